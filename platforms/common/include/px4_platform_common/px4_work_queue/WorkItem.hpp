@@ -35,8 +35,9 @@
 
 #include "WorkQueueManager.hpp"
 #include "WorkQueue.hpp"
+#include "WorkItemStats.hpp"
 
-#include <containers/IntrusiveQueue.hpp>
+#include <containers/IntrusiveMPSCQueue.hpp>
 #include <containers/IntrusiveSortedList.hpp>
 #include <px4_platform_common/defines.h>
 #include <drivers/drv_hrt.h>
@@ -48,7 +49,7 @@
 namespace px4
 {
 
-class WorkItem : public IntrusiveSortedListNode<WorkItem *>, public IntrusiveQueueNode<WorkItem *>
+class WorkItem : public IntrusiveSortedListNode<WorkItem *>, public IntrusiveMPSCQueueNode<WorkItem *>
 {
 public:
 
@@ -72,6 +73,11 @@ public:
 
 	virtual void print_run_status();
 
+	void print_timing();
+
+	const DurationHistogram &latency_histogram() const { return _latency; }
+	const DurationHistogram &runtime_histogram() const { return _runtime; }
+
 	/**
 	 * Switch to a different WorkQueue.
 	 * NOTE: Caller is responsible for synchronization.
@@ -108,7 +114,7 @@ protected:
 		}
 	}
 
-	friend void WorkQueue::Run();
+	friend class WorkQueue;
 	virtual void Run() = 0;
 
 	/**
@@ -134,6 +140,11 @@ private:
 
 	WorkQueue	*_wq{nullptr};
 
+	// execution timing, updated by the WorkQueue
+	hrt_abstime		_time_queued{0};
+	DurationHistogram	_latency{};
+	DurationHistogram	_runtime{};
+
 };
 
 } // namespace px4
@@ -0,0 +1,87 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace px4
+{
+
+/**
+ * Log2 histogram of durations in microseconds.
+ *
+ * Bucket 0 counts everything below 8 us, bucket i in [1, BUCKETS - 2] counts
+ * [4 * 2^i, 8 * 2^i) us and the last bucket everything from 8192 us.
+ */
+struct DurationHistogram {
+	static constexpr int BUCKETS = 12;
+
+	uint32_t count[BUCKETS] {};
+	uint32_t max{0};
+
+	static int bucket(uint32_t duration_us)
+	{
+		if (duration_us < 8) {
+			return 0;
+		}
+
+		// index of the highest set bit, 8 us (bit 3) maps to bucket 1
+		const int b = 31 - __builtin_clz(duration_us) - 2;
+		return (b < BUCKETS) ? b : (BUCKETS - 1);
+	}
+
+	void add(uint64_t duration_us)
+	{
+		const uint32_t us = (duration_us < UINT32_MAX) ? (uint32_t)duration_us : UINT32_MAX;
+
+		count[bucket(us)]++;
+
+		if (us > max) {
+			max = us;
+		}
+	}
+};
+
+/**
+ * Execution statistics of a single work item (see WorkQueueManagerItemStats()).
+ */
+struct work_item_stats_t {
+	char item_name[24];
+	char wq_name[24];
+	DurationHistogram latency; // from being queued until Run() starts
+	DurationHistogram runtime; // Run() duration
+	float wq_utilization;      // fraction of time the work queue is busy
+};
+
+} // namespace px4
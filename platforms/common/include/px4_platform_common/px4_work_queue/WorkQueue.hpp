@@ -34,10 +34,13 @@
 #pragma once
 
 #include "WorkQueueManager.hpp"
+#include "WorkQueueThreadPool.hpp"
+#include "WorkItemStats.hpp"
 
 #include <containers/BlockingList.hpp>
 #include <containers/List.hpp>
-#include <containers/IntrusiveQueue.hpp>
+#include <containers/IntrusiveMPSCQueue.hpp>
+#include <drivers/drv_hrt.h>
 #include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/sem.h>
@@ -54,6 +57,11 @@ public:
 	explicit WorkQueue(const wq_config_t &wq_config);
 	WorkQueue() = delete;
 
+#if defined(__PX4_POSIX)
+	// work queue without its own thread, run by the workers of pool
+	WorkQueue(const wq_config_t &wq_config, WorkQueueThreadPool *pool);
+#endif // __PX4_POSIX
+
 	~WorkQueue();
 
 	const wq_config_t &get_config() const { return _config; }
@@ -69,9 +77,24 @@ public:
 
 	void Run();
 
+	// run all queued work items, from Run() or a pool worker
+	void ProcessQueue();
+
 	void request_stop() { _should_exit.store(true); }
 
 	void print_status(bool last = false);
+	void print_timing();
+
+	/**
+	 * Copy the statistics of the index-th attached work item.
+	 * @return false if there is no such item
+	 */
+	bool item_stats(unsigned index, work_item_stats_t &stats);
+
+	size_t item_count();
+
+	// fraction of time spent running work items over the last window
+	float utilization() const;
 
 	// WorkQueues sorted numerically by relative priority (-1 to -255)
 	bool operator<=(const WorkQueue &rhs) const { return _config.relative_priority >= rhs.get_config().relative_priority; }
@@ -80,6 +103,8 @@ private:
 
 	bool should_exit() const { return _should_exit.load(); }
 
+	static constexpr hrt_abstime UTILIZATION_WINDOW{1000000}; // 1 s
+
 	inline void SignalWorkerThread();
 
 #ifdef __PX4_NUTTX
@@ -94,17 +119,40 @@ private:
 	px4_sem_t _qlock;
 #endif
 
-	IntrusiveQueue<WorkItem *>	_q;
+	IntrusiveMPSCQueue<WorkItem *>	_q; ///< lock-free push, popped under work_lock()
 	px4_sem_t			_process_lock;
 	px4_sem_t			_exit_lock;
 	const wq_config_t		&_config;
 	BlockingList<WorkItem *>	_work_items;
 	px4::atomic_bool		_should_exit{false};
 
+	WorkItem			*_current_item{nullptr}; ///< item running right now, cleared if it detaches
+
+	// utilization, updated after every run
+	hrt_abstime			_window_start{0};
+	hrt_abstime			_window_busy{0};
+	float				_utilization{0.f};
+
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 	int _lockstep_component {-1};
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
+#if defined(__PX4_POSIX)
+	friend class WorkQueueThreadPool;
+
+	enum class PoolState : uint8_t {
+		Idle,
+		Ready,          ///< in the pool ready list
+		Running,        ///< being processed by a worker
+		RunningPending, ///< being processed and signalled again meanwhile
+	};
+
+	// pool bookkeeping, protected by the pool lock
+	WorkQueueThreadPool *_pool{nullptr};
+	WorkQueue *_pool_ready_next{nullptr};
+	PoolState _pool_state{PoolState::Idle};
+#endif // __PX4_POSIX
+
 };
 
 } // namespace px4
@@ -39,6 +39,7 @@ namespace px4
 {
 
 class WorkQueue; // forward declaration
+struct work_item_stats_t;
 
 struct wq_config_t {
 	const char *name;
@@ -111,6 +112,20 @@ int WorkQueueManagerStop();
  */
 int WorkQueueManagerStatus();
 
+/**
+ * Print the latency and runtime histograms of all work items.
+ */
+int WorkQueueManagerTimingStatus();
+
+/**
+ * Copy the execution statistics of a work item.
+ *
+ * @param index		Index over all work items of all work queues.
+ * @param stats		Filled with the statistics.
+ * @return		false if index is past the last work item.
+ */
+bool WorkQueueManagerItemStats(unsigned index, work_item_stats_t &stats);
+
 /**
  * Create (or find) a work queue with a particular configuration.
  *
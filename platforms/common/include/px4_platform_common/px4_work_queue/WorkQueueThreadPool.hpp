@@ -0,0 +1,119 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#if defined(__PX4_POSIX)
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/sem.h>
+
+#include <pthread.h>
+#include <stddef.h>
+
+namespace px4
+{
+
+class WorkQueue;
+
+/**
+ * A pool of worker threads shared by several WorkQueues (POSIX only).
+ *
+ * Every WorkQueue keeps its own FIFO and is run by at most one worker at a
+ * time, so the items of a queue still execute serially and in order, exactly
+ * as on a dedicated thread. Queues that have work are served highest relative
+ * priority first.
+ */
+class WorkQueueThreadPool
+{
+public:
+	// called from a worker once a work queue has been asked to stop and has no work left
+	using exit_callback_t = void (*)(WorkQueue *wq);
+
+	WorkQueueThreadPool(const char *name, int sched_priority, size_t stacksize, exit_callback_t exit_callback);
+	~WorkQueueThreadPool();
+
+	/**
+	 * Start the worker threads.
+	 *
+	 * @param num_threads	Number of workers (limited to MAX_THREADS).
+	 * @param cpus		CPUs the workers are pinned to round-robin (Linux only), nullptr for no affinity.
+	 * @param num_cpus	Number of entries in cpus.
+	 * @return		Number of workers started.
+	 */
+	unsigned Start(unsigned num_threads, const int *cpus, unsigned num_cpus);
+
+	/**
+	 * Stop and join all workers. The work queues must already be gone.
+	 */
+	void Stop();
+
+	/**
+	 * Make a work queue runnable, called by the WorkQueue whenever it is signalled.
+	 */
+	void Schedule(WorkQueue *wq);
+
+	const char *get_name() const { return _name; }
+	int get_sched_priority() const { return _sched_priority; }
+	unsigned get_thread_count() const { return _num_threads; }
+
+	static constexpr unsigned MAX_THREADS = 8;
+
+private:
+	static void *WorkerEntry(void *arg);
+	void WorkerRun();
+
+	void EnqueueReady(WorkQueue *wq);
+
+	void lock() { do {} while (px4_sem_wait(&_lock) != 0); }
+	void unlock() { px4_sem_post(&_lock); }
+
+	const char *_name;
+	const int _sched_priority;
+	const size_t _stacksize;
+	const exit_callback_t _exit_callback;
+
+	px4_sem_t _lock;
+	px4_sem_t _ready_sem; ///< counts queued entries in the ready list
+
+	WorkQueue *_ready_head{nullptr}; ///< ready work queues, sorted by relative priority
+
+	pthread_t _threads[MAX_THREADS] {};
+	unsigned _num_threads{0};
+
+	px4::atomic_bool _should_exit{false};
+};
+
+} // namespace px4
+
+#endif // __PX4_POSIX
@@ -140,4 +140,22 @@ void WorkItem::print_run_status()
 	_run_count = 0;
 }
 
+void WorkItem::print_timing()
+{
+	PX4_INFO_RAW("  %s\n", _item_name);
+
+	const DurationHistogram *histograms[2] {&_latency, &_runtime};
+	const char *labels[2] {"latency", "runtime"};
+
+	for (int h = 0; h < 2; h++) {
+		PX4_INFO_RAW("    %-8s", labels[h]);
+
+		for (int i = 0; i < DurationHistogram::BUCKETS; i++) {
+			PX4_INFO_RAW(" %7" PRIu32, histograms[h]->count[i]);
+		}
+
+		PX4_INFO_RAW(" %8" PRIu32 "\n", histograms[h]->max);
+	}
+}
+
 } // namespace px4
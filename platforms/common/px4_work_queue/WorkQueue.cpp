@@ -44,15 +44,9 @@ namespace px4
 {
 
 WorkQueue::WorkQueue(const wq_config_t &config) :
-	_config(config)
+	_config(config),
+	_window_start(hrt_absolute_time())
 {
-	// set the threads name
-#ifdef __PX4_DARWIN
-	pthread_setname_np(_config.name);
-#else
-	pthread_setname_np(pthread_self(), _config.name);
-#endif
-
 #ifndef __PX4_NUTTX
 	px4_sem_init(&_qlock, 0, 1);
 #endif /* __PX4_NUTTX */
@@ -64,6 +58,14 @@ WorkQueue::WorkQueue(const wq_config_t &config) :
 	px4_sem_setprotocol(&_exit_lock, SEM_PRIO_NONE);
 }
 
+#if defined(__PX4_POSIX)
+WorkQueue::WorkQueue(const wq_config_t &config, WorkQueueThreadPool *pool) :
+	WorkQueue(config)
+{
+	_pool = pool;
+}
+#endif // __PX4_POSIX
+
 WorkQueue::~WorkQueue()
 {
 
@@ -104,6 +106,11 @@ void WorkQueue::Detach(WorkItem *item)
 
 	_work_items.remove(item);
 
+	if (_current_item == item) {
+		// detaching from its own Run(), it might be deleted right after
+		_current_item = nullptr;
+	}
+
 	if (_work_items.size() == 0) {
 		// shutdown, no active WorkItems
 		PX4_DEBUG("stopping: %s, last active WorkItem closing", _config.name);
@@ -127,24 +134,35 @@ void WorkQueue::Detach(WorkItem *item)
 
 void WorkQueue::Add(WorkItem *item)
 {
-	work_lock();
-
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	// registration has to be atomic with the worker unregistering once the queue is empty
+	work_lock();
 
 	if (_lockstep_component == -1) {
 		_lockstep_component = px4_lockstep_register_component();
 	}
 
-#endif // ENABLE_LOCKSTEP_SCHEDULER
-
-	_q.push(item);
+	_q.push(item, [](WorkItem * queued) { queued->_time_queued = hrt_absolute_time(); });
 	work_unlock();
+#else
+	// lock-free, doesn't contend with the worker
+	_q.push(item, [](WorkItem * queued) { queued->_time_queued = hrt_absolute_time(); });
+#endif // ENABLE_LOCKSTEP_SCHEDULER
 
 	SignalWorkerThread();
 }
 
 void WorkQueue::SignalWorkerThread()
 {
+#if defined(__PX4_POSIX)
+
+	if (_pool) {
+		_pool->Schedule(this);
+		return;
+	}
+
+#endif // __PX4_POSIX
+
 	int sem_val;
 
 	if (px4_sem_getvalue(&_process_lock, &sem_val) == 0 && sem_val <= 0) {
@@ -162,52 +180,85 @@ void WorkQueue::Remove(WorkItem *item)
 void WorkQueue::Clear()
 {
 	work_lock();
-
-	while (!_q.empty()) {
-		_q.pop();
-	}
-
+	_q.clear();
 	work_unlock();
 }
 
 void WorkQueue::Run()
 {
+	// set the threads name
+#ifdef __PX4_DARWIN
+	pthread_setname_np(_config.name);
+#else
+	pthread_setname_np(pthread_self(), _config.name);
+#endif
+
 	while (!should_exit()) {
 		// loop as the wait may be interrupted by a signal
 		do {} while (px4_sem_wait(&_process_lock) != 0);
 
-		work_lock();
+		ProcessQueue();
+	}
+
+	PX4_DEBUG("%s: exiting", _config.name);
+}
+
+void WorkQueue::ProcessQueue()
+{
+	work_lock();
+
+	// process queued work
+	while (!_q.empty()) {
+		// read the queued time before popping, afterwards the item can be queued (and stamped) again
+		WorkItem *work = _q.front();
+		const hrt_abstime time_queued = work->_time_queued;
+		_q.pop();
+		_current_item = work;
+
+		work_unlock(); // unlock work queue to run (item may requeue itself)
+
+		const hrt_abstime time_start = hrt_absolute_time();
+		work->_latency.add(time_start - time_queued);
+
+		work->RunPreamble();
+		work->Run();
+		// Note: after Run() we cannot access work anymore, as it might have been deleted
 
-		// process queued work
-		while (!_q.empty()) {
-			WorkItem *work = _q.pop();
+		const hrt_abstime time_end = hrt_absolute_time();
 
-			work_unlock(); // unlock work queue to run (item may requeue itself)
-			work->RunPreamble();
-			work->Run();
-			// Note: after Run() we cannot access work anymore, as it might have been deleted
-			work_lock(); // re-lock
+		work_lock(); // re-lock
+
+		if (_current_item == work) {
+			// still attached, so still alive
+			work->_runtime.add(time_end - time_start);
+			_current_item = nullptr;
 		}
 
-#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+		_window_busy += time_end - time_start;
 
-		if (_q.empty()) {
-			px4_lockstep_unregister_component(_lockstep_component);
-			_lockstep_component = -1;
+		if (time_end >= _window_start + UTILIZATION_WINDOW) {
+			_utilization = (float)_window_busy / (time_end - _window_start);
+			_window_start = time_end;
+			_window_busy = 0;
 		}
+	}
 
-#endif // ENABLE_LOCKSTEP_SCHEDULER
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
 
-		work_unlock();
+	if (_q.empty()) {
+		px4_lockstep_unregister_component(_lockstep_component);
+		_lockstep_component = -1;
 	}
 
-	PX4_DEBUG("%s: exiting", _config.name);
+#endif // ENABLE_LOCKSTEP_SCHEDULER
+
+	work_unlock();
 }
 
 void WorkQueue::print_status(bool last)
 {
 	const size_t num_items = _work_items.size();
-	PX4_INFO_RAW("%-16s\n", get_name());
+	PX4_INFO_RAW("%-16s %5.1f%%\n", get_name(), (double)(utilization() * 100.f));
 	unsigned i = 0;
 
 	for (WorkItem *item : _work_items) {
@@ -231,4 +282,52 @@ void WorkQueue::print_status(bool last)
 	}
 }
 
+float WorkQueue::utilization() const
+{
+	// the window is only closed by a run, an idle queue would keep reporting its last busy window
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (now > _window_start + 2 * UTILIZATION_WINDOW) {
+		return (float)_window_busy / (now - _window_start);
+	}
+
+	return _utilization;
+}
+
+void WorkQueue::print_timing()
+{
+	PX4_INFO_RAW("%-16s %5.1f%%\n", get_name(), (double)(utilization() * 100.f));
+
+	for (WorkItem *item : _work_items) {
+		item->print_timing();
+	}
+}
+
+size_t WorkQueue::item_count()
+{
+	return _work_items.size();
+}
+
+bool WorkQueue::item_stats(unsigned index, work_item_stats_t &stats)
+{
+	LockGuard lg{_work_items.mutex()};
+
+	unsigned i = 0;
+
+	for (WorkItem *item : _work_items) {
+		if (i++ == index) {
+			strncpy(stats.item_name, item->ItemName(), sizeof(stats.item_name) - 1);
+			stats.item_name[sizeof(stats.item_name) - 1] = '\0';
+			strncpy(stats.wq_name, get_name(), sizeof(stats.wq_name) - 1);
+			stats.wq_name[sizeof(stats.wq_name) - 1] = '\0';
+			stats.latency = item->latency_histogram();
+			stats.runtime = item->runtime_histogram();
+			stats.wq_utilization = utilization();
+			return true;
+		}
+	}
+
+	return false;
+}
+
 } // namespace px4
@@ -46,6 +46,7 @@
 #include <lib/mathlib/mathlib.h>
 
 #include <limits.h>
+#include <stdlib.h>
 #include <string.h>
 
 using namespace time_literals;
@@ -61,6 +62,76 @@ static BlockingQueue<const wq_config_t *, 1> *_wq_manager_create_queue{nullptr};
 
 static px4::atomic_bool _wq_manager_should_exit{true};
 
+#if defined(__PX4_POSIX)
+// Thread pool mode, enabled with PX4_WQ_POOL_THREADS=<workers per class> (optionally pinned with
+// PX4_WQ_POOL_CPUS=<cpu>[,<cpu>...]). Instead of a thread per work queue, each work queue is
+// assigned by relative priority to a priority class served by a shared pool of workers.
+// Work queues above the highest class (rate_ctrl) keep a dedicated thread, so the rate
+// controller never waits for a worker held by bus I/O or a long controller cycle.
+struct wq_pool_class_t {
+	const char *name;
+	int8_t relative_priority; // of the pool threads
+	int8_t min_relative_priority; // lowest work queue priority in this class
+	uint16_t stacksize; // largest stack of the work queues in this class
+};
+
+// all work queue configurations that can be assigned to a pool
+static constexpr const wq_config_t *wq_pool_configs[] {
+	&wq_configurations::rate_ctrl,
+	&wq_configurations::SPI0, &wq_configurations::SPI1, &wq_configurations::SPI2, &wq_configurations::SPI3,
+	&wq_configurations::SPI4, &wq_configurations::SPI5, &wq_configurations::SPI6,
+	&wq_configurations::I2C0, &wq_configurations::I2C1, &wq_configurations::I2C2, &wq_configurations::I2C3,
+	&wq_configurations::I2C4,
+	&wq_configurations::nav_and_controllers,
+	&wq_configurations::INS0, &wq_configurations::INS1, &wq_configurations::INS2, &wq_configurations::INS3,
+	&wq_configurations::hp_default,
+	&wq_configurations::uavcan,
+	&wq_configurations::ttyS0, &wq_configurations::ttyS1, &wq_configurations::ttyS2, &wq_configurations::ttyS3,
+	&wq_configurations::ttyS4, &wq_configurations::ttyS5, &wq_configurations::ttyS6, &wq_configurations::ttyS7,
+	&wq_configurations::ttyS8, &wq_configurations::ttyS9, &wq_configurations::ttyACM0, &wq_configurations::ttyUnknown,
+	&wq_configurations::lp_default,
+	&wq_configurations::test1, &wq_configurations::test2,
+};
+
+// largest stack of the work queues with a relative priority in [min_relative_priority, max_relative_priority]
+static constexpr uint16_t WorkQueuePoolStackSize(int8_t min_relative_priority, int8_t max_relative_priority)
+{
+	uint16_t stacksize = 0;
+
+	for (const wq_config_t *wq : wq_pool_configs) {
+		if ((wq->relative_priority >= min_relative_priority) && (wq->relative_priority <= max_relative_priority)
+		    && (wq->stacksize > stacksize)) {
+			stacksize = wq->stacksize;
+		}
+	}
+
+	return stacksize;
+}
+
+static constexpr int8_t WQ_POOL_HI_MAX = wq_configurations::SPI0.relative_priority;
+static constexpr int8_t WQ_POOL_HI_MIN = wq_configurations::nav_and_controllers.relative_priority;
+static constexpr int8_t WQ_POOL_MID_MIN = wq_configurations::ttyUnknown.relative_priority;
+
+static constexpr wq_pool_class_t wq_pool_classes[] {
+	// SPI, I2C, controllers
+	{"wq:pool_hi", WQ_POOL_HI_MAX, WQ_POOL_HI_MIN, WorkQueuePoolStackSize(WQ_POOL_HI_MIN, WQ_POOL_HI_MAX)},
+	// INS, hp_default, uavcan, serial
+	{
+		"wq:pool_mid", wq_configurations::INS0.relative_priority, WQ_POOL_MID_MIN,
+		WorkQueuePoolStackSize(WQ_POOL_MID_MIN, WQ_POOL_HI_MIN - 1)
+	},
+	// lp_default
+	{
+		"wq:pool_lo", wq_configurations::lp_default.relative_priority, INT8_MIN,
+		WorkQueuePoolStackSize(INT8_MIN, WQ_POOL_MID_MIN - 1)
+	},
+};
+
+static constexpr int WQ_POOL_CLASSES = sizeof(wq_pool_classes) / sizeof(wq_pool_classes[0]);
+
+static WorkQueueThreadPool *_wq_manager_pools[WQ_POOL_CLASSES] {};
+#endif // __PX4_POSIX
+
 
 static WorkQueue *
 FindWorkQueueByName(const char *name)
@@ -252,16 +323,125 @@ WorkQueueRunner(int argc, char *argv[])
 }
 #endif
 
+#if defined(__PX4_POSIX)
+static void
+WorkQueuePoolExit(WorkQueue *wq)
+{
+	// remove from work queue list
+	_wq_manager_wqs_list->remove(wq);
+
+	delete wq;
+}
+
+static size_t
+WorkQueueStackSize(uint16_t stacksize)
+{
+	// On posix system , the desired stacksize round to the nearest multiplier of the system pagesize
+	// It is a requirement of the  pthread_attr_setstacksize* function
+	const unsigned int page_size = sysconf(_SC_PAGESIZE);
+	const size_t stacksize_adj = math::max((int)PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(stacksize));
+	return (stacksize_adj + page_size - (stacksize_adj % page_size));
+}
+
+static void
+WorkQueuePoolsStop()
+{
+	for (int i = 0; i < WQ_POOL_CLASSES; i++) {
+		delete _wq_manager_pools[i];
+		_wq_manager_pools[i] = nullptr;
+	}
+}
+
+static void
+WorkQueuePoolsStart()
+{
+	const char *threads_env = getenv("PX4_WQ_POOL_THREADS");
+	const int num_threads = (threads_env != nullptr) ? atoi(threads_env) : 0;
+
+	if (num_threads <= 0) {
+		return;
+	}
+
+	// workers are pinned round-robin, so more CPUs than workers are never used
+	int cpus[WorkQueueThreadPool::MAX_THREADS];
+	unsigned num_cpus = 0;
+	const char *cpus_env = getenv("PX4_WQ_POOL_CPUS");
+
+	while ((cpus_env != nullptr) && (*cpus_env != '\0') && (num_cpus < WorkQueueThreadPool::MAX_THREADS)) {
+		char *end = nullptr;
+		const long cpu = strtol(cpus_env, &end, 10);
+
+		if ((end == cpus_env) || (cpu < 0)) {
+			PX4_ERR("invalid PX4_WQ_POOL_CPUS");
+			num_cpus = 0;
+			break;
+		}
+
+		cpus[num_cpus++] = cpu;
+		cpus_env = (*end == ',') ? end + 1 : end;
+	}
+
+	for (int i = 0; i < WQ_POOL_CLASSES; i++) {
+		const wq_pool_class_t &pool_class = wq_pool_classes[i];
+
+		_wq_manager_pools[i] = new WorkQueueThreadPool(pool_class.name,
+				sched_get_priority_max(SCHED_FIFO) + pool_class.relative_priority,
+				WorkQueueStackSize(pool_class.stacksize), WorkQueuePoolExit);
+
+		if (_wq_manager_pools[i]->Start(num_threads, cpus, num_cpus) == 0) {
+			PX4_ERR("%s: no workers, falling back to a thread per work queue", pool_class.name);
+			WorkQueuePoolsStop();
+			return;
+		}
+	}
+
+	PX4_INFO("work queue thread pool: %d threads per class", num_threads);
+}
+
+static WorkQueueThreadPool *
+WorkQueuePoolFor(const wq_config_t &wq)
+{
+	if (wq.relative_priority > WQ_POOL_HI_MAX) {
+		// rate_ctrl, dedicated thread
+		return nullptr;
+	}
+
+	for (int i = 0; i < WQ_POOL_CLASSES; i++) {
+		if (wq.relative_priority >= wq_pool_classes[i].min_relative_priority) {
+			return _wq_manager_pools[i];
+		}
+	}
+
+	return nullptr;
+}
+#endif // __PX4_POSIX
+
 static int
 WorkQueueManagerRun(int, char **)
 {
 	_wq_manager_wqs_list = new BlockingList<WorkQueue *>();
 	_wq_manager_create_queue = new BlockingQueue<const wq_config_t *, 1>();
 
+#if defined(__PX4_POSIX)
+	WorkQueuePoolsStart();
+#endif // __PX4_POSIX
+
 	while (!_wq_manager_should_exit.load()) {
 		// create new work queues as needed
 		const wq_config_t *wq = _wq_manager_create_queue->pop();
 
+#if defined(__PX4_POSIX)
+		WorkQueueThreadPool *pool = (wq != nullptr) ? WorkQueuePoolFor(*wq) : nullptr;
+
+		if (pool != nullptr) {
+			// no thread of its own, run by the pool workers
+			_wq_manager_wqs_list->add(new WorkQueue(*wq, pool));
+			PX4_DEBUG("starting: %s on %s", wq->name, pool->get_name());
+			continue;
+		}
+
+#endif // __PX4_POSIX
+
 		if (wq != nullptr) {
 			// create new work queue
 
@@ -271,11 +451,7 @@ WorkQueueManagerRun(int, char **)
 #elif defined(__PX4_NUTTX)
 			const size_t stacksize = math::max(PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(wq->stacksize));
 #elif defined(__PX4_POSIX)
-			// On posix system , the desired stacksize round to the nearest multiplier of the system pagesize
-			// It is a requirement of the  pthread_attr_setstacksize* function
-			const unsigned int page_size = sysconf(_SC_PAGESIZE);
-			const size_t stacksize_adj = math::max((int)PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(wq->stacksize));
-			const size_t stacksize = (stacksize_adj + page_size - (stacksize_adj % page_size));
+			const size_t stacksize = WorkQueueStackSize(wq->stacksize);
 #endif
 
 			// priority
@@ -366,6 +542,10 @@ WorkQueueManagerRun(int, char **)
 		}
 	}
 
+#if defined(__PX4_POSIX)
+	WorkQueuePoolsStop();
+#endif // __PX4_POSIX
+
 	return 0;
 }
 
@@ -454,7 +634,12 @@ WorkQueueManagerStatus()
 	if (!_wq_manager_should_exit.load() && (_wq_manager_wqs_list != nullptr)) {
 
 		const size_t num_wqs = _wq_manager_wqs_list->size();
-		PX4_INFO_RAW("\nWork Queue: %-2zu threads                          RATE        INTERVAL\n", num_wqs);
+#if defined(__PX4_POSIX)
+		const char *unit = (_wq_manager_pools[0] != nullptr) ? "queues " : "threads";
+#else
+		const char *unit = "threads";
+#endif // __PX4_POSIX
+		PX4_INFO_RAW("\nWork Queue: %-2zu %s                          RATE        INTERVAL\n", num_wqs, unit);
 
 		LockGuard lg{_wq_manager_wqs_list->mutex()};
 		size_t i = 0;
@@ -474,6 +659,48 @@ WorkQueueManagerStatus()
 			wq->print_status(last_wq);
 		}
 
+#if defined(__PX4_POSIX)
+
+		for (WorkQueueThreadPool *pool : _wq_manager_pools) {
+			if (pool != nullptr) {
+				PX4_INFO_RAW("%-16s %u threads, priority %d\n", pool->get_name(), pool->get_thread_count(),
+					     pool->get_sched_priority());
+			}
+		}
+
+#endif // __PX4_POSIX
+
+	} else {
+		PX4_INFO("not running");
+	}
+
+	return PX4_OK;
+}
+
+int
+WorkQueueManagerTimingStatus()
+{
+	if (!_wq_manager_should_exit.load() && (_wq_manager_wqs_list != nullptr)) {
+
+		// column header: upper bound of each bucket in us, the last one is open
+		PX4_INFO_RAW("\nWork Queue timing (us)\n%-12s", "");
+
+		char label[8];
+
+		for (int i = 0; i < DurationHistogram::BUCKETS - 1; i++) {
+			snprintf(label, sizeof(label), "<%d", 8 << i);
+			PX4_INFO_RAW(" %7s", label);
+		}
+
+		snprintf(label, sizeof(label), ">=%d", 8 << (DurationHistogram::BUCKETS - 2));
+		PX4_INFO_RAW(" %7s %8s\n", label, "max");
+
+		LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+		for (WorkQueue *wq : *_wq_manager_wqs_list) {
+			wq->print_timing();
+		}
+
 	} else {
 		PX4_INFO("not running");
 	}
@@ -481,4 +708,26 @@ WorkQueueManagerStatus()
 	return PX4_OK;
 }
 
+bool
+WorkQueueManagerItemStats(unsigned index, work_item_stats_t &stats)
+{
+	if (_wq_manager_should_exit.load() || (_wq_manager_wqs_list == nullptr)) {
+		return false;
+	}
+
+	LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+	for (WorkQueue *wq : *_wq_manager_wqs_list) {
+		const size_t num_items = wq->item_count();
+
+		if (index < num_items) {
+			return wq->item_stats(index, stats);
+		}
+
+		index -= num_items;
+	}
+
+	return false;
+}
+
 } // namespace px4
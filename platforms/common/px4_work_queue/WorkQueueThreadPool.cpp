@@ -0,0 +1,244 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <px4_platform_common/px4_work_queue/WorkQueueThreadPool.hpp>
+
+#if defined(__PX4_POSIX)
+
+#include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/tasks.h>
+
+#include <sched.h>
+#include <string.h>
+
+namespace px4
+{
+
+WorkQueueThreadPool::WorkQueueThreadPool(const char *name, int sched_priority, size_t stacksize,
+		exit_callback_t exit_callback) :
+	_name(name),
+	_sched_priority(sched_priority),
+	_stacksize(stacksize),
+	_exit_callback(exit_callback)
+{
+	px4_sem_init(&_lock, 0, 1);
+
+	px4_sem_init(&_ready_sem, 0, 0);
+	px4_sem_setprotocol(&_ready_sem, SEM_PRIO_NONE);
+}
+
+WorkQueueThreadPool::~WorkQueueThreadPool()
+{
+	Stop();
+
+	px4_sem_destroy(&_ready_sem);
+	px4_sem_destroy(&_lock);
+}
+
+unsigned WorkQueueThreadPool::Start(unsigned num_threads, const int *cpus, unsigned num_cpus)
+{
+	if (num_threads > MAX_THREADS) {
+		PX4_WARN("%s: limiting to %u threads", _name, MAX_THREADS);
+		num_threads = MAX_THREADS;
+	}
+
+	for (unsigned i = 0; i < num_threads; i++) {
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+
+		int ret_setstacksize = pthread_attr_setstacksize(&attr, _stacksize);
+
+		if (ret_setstacksize != 0) {
+			PX4_ERR("setting stack size for %s failed (%i)", _name, ret_setstacksize);
+		}
+
+		// schedule policy FIFO
+		sched_param param{};
+		param.sched_priority = _sched_priority;
+		pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+		pthread_attr_setschedparam(&attr, &param);
+
+		int ret_create = pthread_create(&_threads[_num_threads], &attr, WorkerEntry, this);
+		pthread_attr_destroy(&attr);
+
+		if (ret_create != 0) {
+			PX4_ERR("failed to create thread for %s (%i): %s", _name, ret_create, strerror(ret_create));
+			break;
+		}
+
+#if defined(__PX4_LINUX)
+
+		if ((cpus != nullptr) && (num_cpus > 0) && (cpus[i % num_cpus] < CPU_SETSIZE)) {
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			CPU_SET(cpus[i % num_cpus], &cpuset);
+
+			int ret_affinity = pthread_setaffinity_np(_threads[_num_threads], sizeof(cpuset), &cpuset);
+
+			if (ret_affinity != 0) {
+				PX4_ERR("pinning %s to CPU %d failed (%i)", _name, cpus[i % num_cpus], ret_affinity);
+			}
+		}
+
+#endif // __PX4_LINUX
+
+		PX4_DEBUG("starting: %s worker %u, priority: %d, stack: %zu bytes", _name, i, _sched_priority, _stacksize);
+
+		_num_threads++;
+	}
+
+	return _num_threads;
+}
+
+void WorkQueueThreadPool::Stop()
+{
+	if (_num_threads == 0) {
+		return;
+	}
+
+	_should_exit.store(true);
+
+	// wake every worker
+	for (unsigned i = 0; i < _num_threads; i++) {
+		px4_sem_post(&_ready_sem);
+	}
+
+	for (unsigned i = 0; i < _num_threads; i++) {
+		pthread_join(_threads[i], nullptr);
+	}
+
+	_num_threads = 0;
+}
+
+void WorkQueueThreadPool::Schedule(WorkQueue *wq)
+{
+	lock();
+
+	switch (wq->_pool_state) {
+	case WorkQueue::PoolState::Idle:
+		EnqueueReady(wq);
+		break;
+
+	case WorkQueue::PoolState::Running:
+		// the worker currently running it picks it up again when done
+		wq->_pool_state = WorkQueue::PoolState::RunningPending;
+		break;
+
+	case WorkQueue::PoolState::Ready:
+	case WorkQueue::PoolState::RunningPending:
+		break;
+	}
+
+	unlock();
+}
+
+void WorkQueueThreadPool::EnqueueReady(WorkQueue *wq)
+{
+	// sorted by relative priority, FIFO within the same priority
+	WorkQueue **insert = &_ready_head;
+
+	while ((*insert != nullptr) && (*insert)->get_config().relative_priority >= wq->get_config().relative_priority) {
+		insert = &(*insert)->_pool_ready_next;
+	}
+
+	wq->_pool_ready_next = *insert;
+	*insert = wq;
+	wq->_pool_state = WorkQueue::PoolState::Ready;
+
+	px4_sem_post(&_ready_sem);
+}
+
+void *WorkQueueThreadPool::WorkerEntry(void *arg)
+{
+	WorkQueueThreadPool *pool = static_cast<WorkQueueThreadPool *>(arg);
+
+	// set the threads name
+#ifdef __PX4_DARWIN
+	pthread_setname_np(pool->_name);
+#else
+	pthread_setname_np(pthread_self(), pool->_name);
+#endif
+
+	pool->WorkerRun();
+
+	return nullptr;
+}
+
+void WorkQueueThreadPool::WorkerRun()
+{
+	while (!_should_exit.load()) {
+		// loop as the wait may be interrupted by a signal
+		do {} while (px4_sem_wait(&_ready_sem) != 0);
+
+		lock();
+
+		WorkQueue *wq = _ready_head;
+
+		if (wq == nullptr) {
+			unlock();
+			continue;
+		}
+
+		_ready_head = wq->_pool_ready_next;
+		wq->_pool_ready_next = nullptr;
+		wq->_pool_state = WorkQueue::PoolState::Running;
+
+		unlock();
+
+		// only this worker runs wq until it is back to Idle, which keeps the items in order
+		wq->ProcessQueue();
+
+		if (wq->should_exit()) {
+			PX4_DEBUG("%s: exiting", wq->get_name());
+			_exit_callback(wq);
+			continue;
+		}
+
+		lock();
+
+		if (wq->_pool_state == WorkQueue::PoolState::RunningPending) {
+			EnqueueReady(wq);
+
+		} else {
+			wq->_pool_state = WorkQueue::PoolState::Idle;
+		}
+
+		unlock();
+	}
+}
+
+} // namespace px4
+
+#endif // __PX4_POSIX
@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "wqueue_stress_test.h"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+using namespace time_literals;
+
+px4::atomic_int WQueueStressItem::running{0};
+px4::atomic_int WQueueStressItem::errors{0};
+
+void WQueueStressItem::Run()
+{
+	if (running.fetch_add(1) != 0) {
+		// another item of the same queue is running
+		errors.fetch_add(1);
+	}
+
+	// a request that arrives while queued is coalesced into this run
+	_served.store(_requested.load());
+	_runs.fetch_add(1);
+
+	running.fetch_sub(1);
+}
+
+void *WQueueStressTest::producer(void *arg)
+{
+	WQueueStressItem *items = static_cast<WQueueStressItem *>(arg);
+
+	for (int i = 0; i < REQUESTS_PER_PRODUCER; i++) {
+		items[i % NUM_ITEMS].request();
+	}
+
+	return nullptr;
+}
+
+int WQueueStressTest::main()
+{
+	int ret = 0;
+
+	// single producer microbenchmark, items are mostly already queued
+	const hrt_abstime single_start = hrt_absolute_time();
+
+	for (int i = 0; i < REQUESTS_PER_PRODUCER; i++) {
+		_items[i % NUM_ITEMS].request();
+	}
+
+	const hrt_abstime single_elapsed = hrt_elapsed_time(&single_start);
+
+	// multi producer stress
+	pthread_t threads[NUM_PRODUCERS];
+	const hrt_abstime multi_start = hrt_absolute_time();
+
+	for (int i = 0; i < NUM_PRODUCERS; i++) {
+		pthread_create(&threads[i], nullptr, &WQueueStressTest::producer, _items);
+	}
+
+	for (int i = 0; i < NUM_PRODUCERS; i++) {
+		pthread_join(threads[i], nullptr);
+	}
+
+	const hrt_abstime multi_elapsed = hrt_elapsed_time(&multi_start);
+
+	// every request has to be served eventually
+	const hrt_abstime timeout_start = hrt_absolute_time();
+	bool all_served = false;
+
+	while (!all_served && (hrt_elapsed_time(&timeout_start) < 5_s)) {
+		all_served = true;
+
+		for (auto &item : _items) {
+			all_served = all_served && item.served();
+		}
+
+		px4_usleep(10_ms);
+	}
+
+	int runs = 0;
+
+	for (auto &item : _items) {
+		runs += item.runs();
+	}
+
+	const int requests = (NUM_PRODUCERS + 1) * REQUESTS_PER_PRODUCER;
+
+	PX4_INFO("ScheduleNow: %.1f ns/call (1 producer), %.1f ns/call (%d producers)",
+		 1e3 * single_elapsed / REQUESTS_PER_PRODUCER,
+		 1e3 * multi_elapsed / (NUM_PRODUCERS * REQUESTS_PER_PRODUCER), NUM_PRODUCERS);
+	PX4_INFO("%d requests coalesced into %d runs", requests, runs);
+
+	if (!all_served) {
+		PX4_ERR("lost wakeup, not every request was served");
+		ret = 1;
+	}
+
+	if (WQueueStressItem::errors.load() != 0) {
+		PX4_ERR("work items of the same queue ran concurrently (%d)", WQueueStressItem::errors.load());
+		ret = 1;
+	}
+
+	PX4_INFO("WQueueStressTest %s", (ret == 0) ? "finished" : "FAILED");
+
+	return ret;
+}
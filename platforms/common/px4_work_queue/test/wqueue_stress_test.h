@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
+#include <pthread.h>
+
+class WQueueStressItem : public px4::WorkItem
+{
+public:
+	WQueueStressItem() : px4::WorkItem("WQueueStressItem", px4::wq_configurations::test1) {}
+	~WQueueStressItem() = default;
+
+	void request()
+	{
+		_requested.fetch_add(1);
+		ScheduleNow();
+	}
+
+	// every request was followed by a run
+	bool served() { return _served.load() == _requested.load(); }
+
+	int runs() { return _runs.load(); }
+
+	static px4::atomic_int running; // items of the queue currently running
+	static px4::atomic_int errors;
+
+private:
+
+	void Run() override;
+
+	px4::atomic_int _requested{0};
+	px4::atomic_int _served{0};
+	px4::atomic_int _runs{0};
+};
+
+/**
+ * Several threads concurrently scheduling the same set of work items, checking that
+ * no request is lost, the items of a queue never run concurrently, and measuring the
+ * ScheduleNow() cost.
+ */
+class WQueueStressTest
+{
+public:
+	int main();
+
+private:
+
+	static void *producer(void *arg);
+
+	static constexpr int NUM_ITEMS = 8;
+	static constexpr int NUM_PRODUCERS = 4;
+	static constexpr int REQUESTS_PER_PRODUCER = 20000;
+
+	WQueueStressItem _items[NUM_ITEMS];
+};
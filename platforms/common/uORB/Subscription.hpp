@@ -171,6 +171,17 @@ public:
 		return valid() ? Manager::orb_data_copy(_node, dst, _last_generation, false) : false;
 	}
 
+	/**
+	 * Mark all available updates as seen without copying the data
+	 * (e.g. if the data is accessed through another path)
+	 */
+	void ack()
+	{
+		if (valid()) {
+			_last_generation += Manager::updates_available(_node, _last_generation);
+		}
+	}
+
 	/**
 	 * Change subscription instance
 	 * @param instance The new multi-Subscription instance
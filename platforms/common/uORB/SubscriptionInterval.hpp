@@ -133,6 +133,11 @@ public:
 		return false;
 	}
 
+	/**
+	 * Mark all available updates as seen without copying the data
+	 */
+	void ack() { _subscription.ack(); }
+
 	bool		valid() const { return _subscription.valid(); }
 
 	uint8_t		get_instance() const { return _subscription.get_instance(); }
@@ -50,6 +50,7 @@
 #include <string.h>
 #include <errno.h>
 #include "hrt_work.h"
+#include "hrt_callout_queue.h"
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 #include <lockstep_scheduler/lockstep_scheduler.h>
@@ -61,9 +62,9 @@ static constexpr unsigned HRT_INTERVAL_MIN = 50;
 static constexpr unsigned HRT_INTERVAL_MAX = 50000000;
 
 /*
- * Queue of callout entries.
+ * Queue of callout entries, ordered by deadline.
  */
-static struct sq_queue_s	callout_queue;
+static HrtCalloutQueue		callout_queue;
 
 /* latency baseline (last compare value applied) */
 static uint64_t			latency_baseline;
@@ -101,12 +102,16 @@ static void hrt_unlock()
 hrt_abstime hrt_absolute_time()
 {
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
-	// optimized case (avoid ts_to_abstime) if lockstep scheduler is used
+	// optimized case (avoid ts_to_abstime) if lockstep scheduler is used:
+	// a single atomic load, monotonic as the scheduler never moves time backwards
 	return lockstep_scheduler.get_absolute_time();
 
 #else // defined(ENABLE_LOCKSTEP_SCHEDULER)
+	// Call the system clock directly instead of going through px4_clock_gettime().
+	// CLOCK_MONOTONIC is served from the vDSO (Linux) or commpage (macOS), so this
+	// does not enter the kernel.
 	struct timespec ts;
-	px4_clock_gettime(CLOCK_MONOTONIC, &ts);
+	system_clock_gettime(CLOCK_MONOTONIC, &ts);
 	return ts_to_abstime(&ts);
 #endif // defined(ENABLE_LOCKSTEP_SCHEDULER)
 }
@@ -138,7 +143,7 @@ bool	hrt_called(struct hrt_call *entry)
 void	hrt_cancel(struct hrt_call *entry)
 {
 	hrt_lock();
-	sq_rem(&entry->link, &callout_queue);
+	callout_queue.remove(entry);
 	entry->deadline = 0;
 
 	/* if this is a periodic call being removed by the callout, prevent it from
@@ -191,8 +196,6 @@ void	hrt_call_delay(struct hrt_call *entry, hrt_abstime delay)
  */
 void	hrt_init()
 {
-	sq_init(&callout_queue);
-
 	int sem_ret = px4_sem_init(&_hrt_lock, 0, 1);
 
 	if (sem_ret) {
@@ -205,26 +208,15 @@ void	hrt_init()
 static void
 hrt_call_enter(struct hrt_call *entry)
 {
-	struct hrt_call	*call, *next;
-
-	call = (struct hrt_call *)sq_peek(&callout_queue);
+	if (!callout_queue.insert(entry)) {
+		// the storage is preallocated, this only happens with more than CAPACITY active callouts
+		PX4_ERR("hrt callout queue full (%u), callout %p not scheduled", HrtCalloutQueue::CAPACITY, entry);
+		return;
+	}
 
-	if ((call == nullptr) || (entry->deadline < call->deadline)) {
-		sq_addfirst(&entry->link, &callout_queue);
-		//if (call != nullptr) PX4_INFO("call enter at head, reschedule (%lu %lu)", entry->deadline, call->deadline);
+	if (callout_queue.peek() == entry) {
 		/* we changed the next deadline, reschedule the timer event */
 		hrt_call_reschedule();
-
-	} else {
-		do {
-			next = (struct hrt_call *)sq_next(&call->link);
-
-			if ((next == nullptr) || (entry->deadline < next->deadline)) {
-				//lldbg("call enter after head\n");
-				sq_addafter(&call->link, &entry->link, &callout_queue);
-				break;
-			}
-		} while ((call = next) != nullptr);
 	}
 }
 
@@ -263,7 +255,7 @@ hrt_call_reschedule()
 {
 	hrt_abstime	now = hrt_absolute_time();
 	hrt_abstime	delay = HRT_INTERVAL_MAX;
-	struct hrt_call	*next = (struct hrt_call *)sq_peek(&callout_queue);
+	struct hrt_call	*next = callout_queue.peek();
 	hrt_abstime	deadline = now + HRT_INTERVAL_MAX;
 
 	/*
@@ -311,16 +303,11 @@ hrt_call_internal(struct hrt_call *entry, hrt_abstime deadline, hrt_abstime inte
 
 	//PX4_INFO("hrt_call_internal after lock");
 	/* if the entry is currently queued, remove it */
-	/* note that we are using a potentially uninitialised
-	   entry->link here, but it is safe as sq_rem() doesn't
-	   dereference the passed node unless it is found in the
-	   list. So we potentially waste a bit of time searching the
-	   queue for the uninitialised entry->link but we don't do
-	   anything actually unsafe.
+	/* note that entry->heap_index may be uninitialised here, but
+	   remove() only trusts it after checking that the heap slot it
+	   points to holds this entry, so this is safe.
 	*/
-	if (entry->deadline != 0) {
-		sq_rem(&entry->link, &callout_queue);
-	}
+	callout_queue.remove(entry);
 
 #if 1
 
@@ -391,7 +378,7 @@ hrt_call_invoke()
 		/* get the current time */
 		hrt_abstime now = hrt_absolute_time();
 
-		call = (struct hrt_call *)sq_peek(&callout_queue);
+		call = callout_queue.peek();
 
 		if (call == nullptr) {
 			break;
@@ -401,7 +388,7 @@ hrt_call_invoke()
 			break;
 		}
 
-		sq_rem(&call->link, &callout_queue);
+		callout_queue.pop();
 		//PX4_INFO("call pop");
 
 		/* save the intended deadline for periodic calls */
@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file hrt_absolute_time_test.cpp
+ * Monotonicity checks and microbenchmark for hrt_absolute_time() on POSIX.
+ *
+ * Run with --gtest_filter=HrtAbsoluteTime.Benchmark to compare the cost per
+ * call against the raw system clock.
+ */
+
+#include <gtest/gtest.h>
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/time.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+void set_lockstep_time(hrt_abstime time_us)
+{
+	struct timespec ts;
+	abstime_to_ts(&ts, time_us);
+	px4_clock_settime(CLOCK_MONOTONIC, &ts);
+}
+#endif
+
+class HrtAbsoluteTime : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+		// the lockstep time stays at 0 until someone sets it
+		set_lockstep_time(1000000);
+#endif
+	}
+};
+
+template<typename F>
+double ns_per_call(F f, int iterations)
+{
+	volatile hrt_abstime sink = 0;
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < iterations; ++i) {
+		sink = sink + f();
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+} // namespace
+
+TEST_F(HrtAbsoluteTime, MonotonicAcrossThreads)
+{
+	std::atomic<bool> stop{false};
+
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	// keep the simulated time moving while the readers run
+	std::thread clock([&stop]() {
+		hrt_abstime now = hrt_absolute_time();
+
+		while (!stop) {
+			now += 100;
+			set_lockstep_time(now);
+			std::this_thread::yield();
+		}
+	});
+#endif
+
+	// Every reader checks that it never sees a time earlier than the latest
+	// time any thread has seen before.
+	std::atomic<hrt_abstime> latest{hrt_absolute_time()};
+	std::atomic<bool> went_back{false};
+	std::vector<std::thread> readers;
+
+	for (int i = 0; i < 4; ++i) {
+		readers.emplace_back([&]() {
+			for (int n = 0; n < 200000; ++n) {
+				hrt_abstime seen = latest.load();
+				const hrt_abstime now = hrt_absolute_time();
+
+				if (now < seen) {
+					went_back = true;
+				}
+
+				while (now > seen && !latest.compare_exchange_weak(seen, now)) {}
+			}
+		});
+	}
+
+	for (auto &reader : readers) {
+		reader.join();
+	}
+
+	stop = true;
+
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	clock.join();
+#endif
+
+	EXPECT_FALSE(went_back);
+}
+
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+TEST_F(HrtAbsoluteTime, LockstepTimeNeverGoesBack)
+{
+	const hrt_abstime now = hrt_absolute_time();
+	set_lockstep_time(now - 500);
+	EXPECT_EQ(hrt_absolute_time(), now);
+
+	set_lockstep_time(now + 500);
+	EXPECT_EQ(hrt_absolute_time(), now + 500);
+}
+#endif
+
+TEST_F(HrtAbsoluteTime, Benchmark)
+{
+	static constexpr int ITERATIONS = 1000000;
+
+	const double hrt_ns = ns_per_call([]() { return hrt_absolute_time(); }, ITERATIONS);
+
+	const double clock_ns = ns_per_call([]() {
+		struct timespec ts;
+		system_clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts_to_abstime(&ts);
+	}, ITERATIONS);
+
+	printf("hrt_absolute_time():             %6.1f ns/call\n", hrt_ns);
+	printf("clock_gettime(CLOCK_MONOTONIC):  %6.1f ns/call\n", clock_ns);
+
+	// Sanity bound only, generous enough for sanitizer builds and loaded CI machines.
+	EXPECT_LT(hrt_ns, 1000.0);
+}
@@ -0,0 +1,198 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file hrt_callout_queue.h
+ *
+ * Deadline ordered queue of HRT callout entries.
+ *
+ * A binary min-heap keyed on (deadline, insertion sequence), so insert, cancel
+ * and pop are O(log n) and entries with equal deadlines still fire in the order
+ * they were queued. Each queued entry records its heap position in
+ * hrt_call::heap_index, which is validated against the heap before use so
+ * removing an uninitialised or already dequeued entry is a harmless no-op.
+ *
+ * The heap storage is preallocated and the type is trivially destructible, like
+ * the intrusive list it replaced, so the static queue in drv_hrt.cpp stays valid
+ * while HRT and work queue threads are still running during process exit.
+ *
+ * Not thread-safe, the caller holds the HRT lock.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+
+#include <stdint.h>
+
+#include <type_traits>
+
+class HrtCalloutQueue
+{
+public:
+	/* maximum number of simultaneously queued callouts */
+	static constexpr unsigned CAPACITY = 1024;
+
+	constexpr HrtCalloutQueue() = default;
+
+	HrtCalloutQueue(const HrtCalloutQueue &) = delete;
+	HrtCalloutQueue &operator=(const HrtCalloutQueue &) = delete;
+
+	bool empty() const { return _size == 0; }
+	unsigned size() const { return _size; }
+
+	/* entry with the earliest deadline, or nullptr if the queue is empty */
+	struct hrt_call *peek() const { return (_size > 0) ? _heap[0].call : nullptr; }
+
+	bool contains(const struct hrt_call *entry) const
+	{
+		return (entry->heap_index < _size) && (_heap[entry->heap_index].call == entry);
+	}
+
+	bool full() const { return _size == CAPACITY; }
+
+	/* returns false if the queue is full */
+	bool insert(struct hrt_call *entry)
+	{
+		if (full()) {
+			return false;
+		}
+
+		sift_up(_size++, Node{entry, _sequence++});
+		return true;
+	}
+
+	void remove(struct hrt_call *entry)
+	{
+		if (contains(entry)) {
+			remove_at(entry->heap_index);
+		}
+	}
+
+	struct hrt_call *pop()
+	{
+		if (_size == 0) {
+			return nullptr;
+		}
+
+		struct hrt_call *call = _heap[0].call;
+		remove_at(0);
+		return call;
+	}
+
+private:
+	struct Node {
+		struct hrt_call *call;
+		uint64_t sequence;
+	};
+
+	static bool before(const Node &a, const Node &b)
+	{
+		if (a.call->deadline != b.call->deadline) {
+			return a.call->deadline < b.call->deadline;
+		}
+
+		return a.sequence < b.sequence;
+	}
+
+	void place(unsigned index, const Node &node)
+	{
+		_heap[index] = node;
+		node.call->heap_index = index;
+	}
+
+	void sift_up(unsigned index, const Node &node)
+	{
+		while (index > 0) {
+			const unsigned parent = (index - 1) / 2;
+
+			if (!before(node, _heap[parent])) {
+				break;
+			}
+
+			place(index, _heap[parent]);
+			index = parent;
+		}
+
+		place(index, node);
+	}
+
+	void sift_down(unsigned index, const Node &node)
+	{
+		while (true) {
+			unsigned child = 2 * index + 1;
+
+			if (child >= _size) {
+				break;
+			}
+
+			if ((child + 1 < _size) && before(_heap[child + 1], _heap[child])) {
+				child++;
+			}
+
+			if (!before(_heap[child], node)) {
+				break;
+			}
+
+			place(index, _heap[child]);
+			index = child;
+		}
+
+		place(index, node);
+	}
+
+	void remove_at(unsigned index)
+	{
+		_heap[index].call->heap_index = UINT32_MAX;
+
+		const Node last = _heap[--_size];
+
+		if (index == _size) {
+			return;
+		}
+
+		// the moved node can belong either above or below the hole
+		if ((index > 0) && before(last, _heap[(index - 1) / 2])) {
+			sift_up(index, last);
+
+		} else {
+			sift_down(index, last);
+		}
+	}
+
+	Node _heap[CAPACITY] {};
+	unsigned _size{0};
+	uint64_t _sequence{0};
+};
+
+static_assert(std::is_trivially_destructible<HrtCalloutQueue>::value, "HrtCalloutQueue must not run a destructor at exit");
@@ -0,0 +1,180 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file hrt_callout_queue_benchmark.cpp
+ * POSIX HRT callout queue benchmark.
+ *
+ * Compares the heap based HrtCalloutQueue against the sorted sq_queue list it
+ * replaced, for 10, 100 and 1000 queued timers. Each operation pops the earliest
+ * timer and re-enters it one period later (a periodic callout firing), then
+ * cancels and re-schedules a random other timer (hrt_call_after() on a queued
+ * entry). Both queues are fed the same sequence and must fire the timers in the
+ * same order, otherwise the benchmark fails.
+ */
+
+#include "hrt_callout_queue.h"
+
+#include <queue.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+// reference implementation: the sorted list previously used by drv_hrt.cpp
+class SortedListQueue
+{
+public:
+	SortedListQueue() { sq_init(&_queue); }
+
+	struct hrt_call *peek() const { return (struct hrt_call *)sq_peek(&_queue); }
+
+	void insert(struct hrt_call *entry)
+	{
+		struct hrt_call *call = peek();
+
+		if ((call == nullptr) || (entry->deadline < call->deadline)) {
+			sq_addfirst(&entry->link, &_queue);
+			return;
+		}
+
+		struct hrt_call *next;
+
+		do {
+			next = (struct hrt_call *)sq_next(&call->link);
+
+			if ((next == nullptr) || (entry->deadline < next->deadline)) {
+				sq_addafter(&call->link, &entry->link, &_queue);
+				break;
+			}
+		} while ((call = next) != nullptr);
+	}
+
+	void remove(struct hrt_call *entry) { sq_rem(&entry->link, &_queue); }
+
+	struct hrt_call *pop()
+	{
+		struct hrt_call *call = peek();
+
+		if (call != nullptr) {
+			sq_rem(&call->link, &_queue);
+		}
+
+		return call;
+	}
+
+private:
+	sq_queue_t _queue;
+};
+
+struct Result {
+	double ns_per_op;
+	uint64_t checksum;
+};
+
+// small deterministic generator so both queues see identical workloads
+uint32_t next_random(uint32_t &state)
+{
+	state = state * 1664525u + 1013904223u;
+	return state >> 8;
+}
+
+template<typename Queue>
+Result run(unsigned timers, unsigned operations)
+{
+	Queue queue;
+	std::vector<struct hrt_call> calls(timers);
+	uint32_t rng = 12345;
+
+	for (unsigned i = 0; i < timers; i++) {
+		memset(&calls[i], 0, sizeof(calls[i]));
+		calls[i].period = 1000 + (next_random(rng) % 20) * 250; // 1 - 6 ms, plenty of equal deadlines
+		calls[i].deadline = calls[i].period;
+		queue.insert(&calls[i]);
+	}
+
+	uint64_t checksum = 0;
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned op = 0; op < operations; op++) {
+		// periodic callout fires and is re-entered
+		struct hrt_call *call = queue.pop();
+		const hrt_abstime now = call->deadline;
+		checksum = checksum * 31 + static_cast<uint64_t>(call - calls.data());
+		call->deadline = now + call->period;
+		queue.insert(call);
+
+		// reschedule some other queued timer
+		struct hrt_call *other = &calls[next_random(rng) % timers];
+		queue.remove(other);
+		other->deadline = now + other->period;
+		queue.insert(other);
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+	const double elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+	return Result{elapsed_ns / operations, checksum};
+}
+
+} // namespace
+
+int main()
+{
+	static constexpr unsigned operations = 200000;
+	static constexpr unsigned timer_counts[] {10, 100, 1000};
+
+	bool ok = true;
+
+	printf("%10s %18s %18s %10s\n", "timers", "sorted list [ns]", "heap [ns]", "speedup");
+
+	for (unsigned timers : timer_counts) {
+		const Result list = run<SortedListQueue>(timers, operations);
+		const Result heap = run<HrtCalloutQueue>(timers, operations);
+
+		printf("%10u %18.1f %18.1f %9.1fx\n", timers, list.ns_per_op, heap.ns_per_op, list.ns_per_op / heap.ns_per_op);
+
+		if (list.checksum != heap.checksum) {
+			printf("  callout order differs from the sorted list (%llu != %llu)\n",
+			       (unsigned long long)list.checksum, (unsigned long long)heap.checksum);
+			ok = false;
+		}
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -35,72 +35,86 @@
 
 #include <px4_platform_common/log.h>
 
+LockstepScheduler::TimedWait::~TimedWait()
+{
+	if (!done) {
+		// This can only happen when a thread gets canceled (e.g. via pthread_cancel), and since
+		// pthread_cond_wait is a cancellation point, the rest of LockstepScheduler::cond_timedwait afterwards
+		// might not be executed. Which means the mutex will not be unlocked either, so we unlock to avoid
+		// a dead-lock in LockstepScheduler::set_absolute_time().
+		// This destructor gets called as part of thread-local storage cleanup.
+		// This is really only a work-around for non-proper thread stopping. Note that we also assume,
+		// that we can still access the mutex.
+		if (passed_lock) {
+			pthread_mutex_unlock(passed_lock);
+		}
+
+		done = true;
+	}
+
+	// The wait was interrupted before it could dequeue itself, so do it here
+	// before the thread-local storage goes away.
+	if (!removed && scheduler) {
+		std::lock_guard<std::mutex> lock_timed_waits(scheduler->_timed_waits_mutex);
+
+		if (!removed) {
+			scheduler->timed_wait_remove(this);
+		}
+	}
+}
+
 LockstepScheduler::~LockstepScheduler()
 {
-	// cleanup the linked list
 	std::unique_lock<std::mutex> lock_timed_waits(_timed_waits_mutex);
 
-	while (_timed_waits) {
-		TimedWait *tmp = _timed_waits;
-		_timed_waits = _timed_waits->next;
-		tmp->removed = true;
+	for (TimedWait *timed_wait : _timed_waits) {
+		timed_wait->removed = true;
+		timed_wait->scheduler = nullptr;
 	}
+
+	_timed_waits.clear();
 }
 
 void LockstepScheduler::set_absolute_time(uint64_t time_us)
 {
-	if (_time_us == 0 && time_us > 0) {
+	uint64_t current_time_us = _time_us;
+
+	if (current_time_us == 0 && time_us > 0) {
 		PX4_INFO("setting initial absolute time to %" PRIu64 " us", time_us);
 	}
 
-	_time_us = time_us;
+	// The time never goes backwards, even if several time sources (e.g. simulator
+	// and replay) race each other, so readers can rely on it being monotonic.
+	while (time_us > current_time_us && !_time_us.compare_exchange_weak(current_time_us, time_us)) {}
+
+	if (time_us < current_time_us) {
+		time_us = current_time_us;
+	}
 
 	{
 		std::unique_lock<std::mutex> lock_timed_waits(_timed_waits_mutex);
-		_setting_time = true;
-
-		TimedWait *timed_wait = _timed_waits;
-		TimedWait *timed_wait_prev = nullptr;
-
-		while (timed_wait) {
-			// Clean up the ones that are already done from last iteration.
-			if (timed_wait->done) {
-				// Erase from the linked list
-				if (timed_wait_prev) {
-					timed_wait_prev->next = timed_wait->next;
-
-				} else {
-					_timed_waits = timed_wait->next;
-				}
-
-				TimedWait *tmp = timed_wait;
-				timed_wait = timed_wait->next;
-				tmp->removed = true;
-				continue;
-			}
 
-			if (timed_wait->time_us <= time_us &&
-			    !timed_wait->timeout) {
-				// We are abusing the condition here to signal that the time
-				// has passed.
-				pthread_mutex_lock(timed_wait->passed_lock);
-				timed_wait->timeout = true;
-				pthread_cond_broadcast(timed_wait->passed_cond);
-				pthread_mutex_unlock(timed_wait->passed_lock);
-			}
+		// Only the waits that are due are touched, in deadline order. Each one
+		// is dequeued before its waiter is signalled, so a waiter that wakes up
+		// with the timeout flag set never has to access the heap again.
+		while (!_timed_waits.empty() && _timed_waits.front()->time_us <= time_us) {
+			TimedWait *timed_wait = _timed_waits.front();
+			timed_wait_remove(timed_wait);
 
-			timed_wait_prev = timed_wait;
-			timed_wait = timed_wait->next;
+			// We are abusing the condition here to signal that the time
+			// has passed.
+			pthread_mutex_lock(timed_wait->passed_lock);
+			timed_wait->timeout = true;
+			pthread_cond_broadcast(timed_wait->passed_cond);
+			pthread_mutex_unlock(timed_wait->passed_lock);
 		}
-
-		_setting_time = false;
 	}
 }
 
 int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *lock, uint64_t time_us)
 {
-	// A TimedWait object might still be in timed_waits_ after we return, so its lifetime needs to be
-	// longer. And using thread_local is more efficient than malloc.
+	// A TimedWait object might still be referenced by set_absolute_time() after we return, so its
+	// lifetime needs to be longer. And using thread_local is more efficient than malloc.
 	static thread_local TimedWait timed_wait;
 	{
 		std::lock_guard<std::mutex> lock_timed_waits(_timed_waits_mutex);
@@ -115,13 +129,9 @@ int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *loc
 		timed_wait.passed_lock = lock;
 		timed_wait.timeout = false;
 		timed_wait.done = false;
+		timed_wait.scheduler = this;
 
-		// Add to linked list if not removed yet (otherwise just re-use the object)
-		if (timed_wait.removed) {
-			timed_wait.removed = false;
-			timed_wait.next = _timed_waits;
-			_timed_waits = &timed_wait;
-		}
+		timed_wait_insert(&timed_wait);
 	}
 
 	int result = pthread_cond_wait(cond, lock);
@@ -134,20 +144,34 @@ int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *loc
 
 	timed_wait.done = true;
 
-	if (!timeout && _setting_time) {
-		// This is where it gets tricky: the timeout has not been triggered yet,
-		// and another thread is in set_absolute_time().
-		// If it already passed the 'done' check, it will access the mutex and
-		// the condition variable next. However they might be invalid as soon as we
-		// return here, so we wait until set_absolute_time() is done.
-		// In addition we have to unlock 'lock', otherwise we risk a
-		// deadlock due to a different locking order in set_absolute_time().
-		// Note that this case does not happen too frequently, and thus can be
-		// a bit more expensive.
-		pthread_mutex_unlock(lock);
-		_timed_waits_mutex.lock();
-		_timed_waits_mutex.unlock();
-		pthread_mutex_lock(lock);
+	if (!timeout) {
+		// Woken up by someone else, so we are most likely still queued and
+		// have to dequeue ourselves. set_absolute_time() locks the heap first
+		// and 'lock' second, so we must not block on the heap mutex while
+		// holding 'lock'. The uncontended case just takes the heap mutex.
+		if (_timed_waits_mutex.try_lock()) {
+			if (!timed_wait.removed) {
+				timed_wait_remove(&timed_wait);
+			}
+
+			_timed_waits_mutex.unlock();
+
+		} else {
+			// set_absolute_time() is running and might be about to access
+			// 'lock' and 'cond', which can be invalid as soon as we return.
+			// Release 'lock' and wait until it is done.
+			// Note that this case does not happen too frequently, and thus can
+			// be a bit more expensive.
+			pthread_mutex_unlock(lock);
+			_timed_waits_mutex.lock();
+
+			if (!timed_wait.removed) {
+				timed_wait_remove(&timed_wait);
+			}
+
+			_timed_waits_mutex.unlock();
+			pthread_mutex_lock(lock);
+		}
 	}
 
 	return result;
@@ -171,3 +195,78 @@ int LockstepScheduler::usleep_until(uint64_t time_us)
 
 	return result;
 }
+
+void LockstepScheduler::timed_wait_insert(TimedWait *timed_wait)
+{
+	timed_wait->removed = false;
+	_timed_waits.push_back(timed_wait);
+	timed_wait_sift_up(_timed_waits.size() - 1, timed_wait);
+}
+
+void LockstepScheduler::timed_wait_remove(TimedWait *timed_wait)
+{
+	const size_t index = timed_wait->heap_index;
+	TimedWait *last = _timed_waits.back();
+	_timed_waits.pop_back();
+	timed_wait->removed = true;
+
+	if (index == _timed_waits.size()) {
+		return;
+	}
+
+	// the moved entry can belong either above or below the hole
+	if (index > 0 && last->time_us < _timed_waits[(index - 1) / 2]->time_us) {
+		timed_wait_sift_up(index, last);
+
+	} else {
+		timed_wait_sift_down(index, last);
+	}
+}
+
+void LockstepScheduler::timed_wait_place(size_t index, TimedWait *timed_wait)
+{
+	_timed_waits[index] = timed_wait;
+	timed_wait->heap_index = index;
+}
+
+void LockstepScheduler::timed_wait_sift_up(size_t index, TimedWait *timed_wait)
+{
+	while (index > 0) {
+		const size_t parent = (index - 1) / 2;
+
+		if (_timed_waits[parent]->time_us <= timed_wait->time_us) {
+			break;
+		}
+
+		timed_wait_place(index, _timed_waits[parent]);
+		index = parent;
+	}
+
+	timed_wait_place(index, timed_wait);
+}
+
+void LockstepScheduler::timed_wait_sift_down(size_t index, TimedWait *timed_wait)
+{
+	const size_t size = _timed_waits.size();
+
+	while (true) {
+		size_t child = 2 * index + 1;
+
+		if (child >= size) {
+			break;
+		}
+
+		if (child + 1 < size && _timed_waits[child + 1]->time_us < _timed_waits[child]->time_us) {
+			child++;
+		}
+
+		if (timed_wait->time_us <= _timed_waits[child]->time_us) {
+			break;
+		}
+
+		timed_wait_place(index, _timed_waits[child]);
+		index = child;
+	}
+
+	timed_wait_place(index, timed_wait);
+}
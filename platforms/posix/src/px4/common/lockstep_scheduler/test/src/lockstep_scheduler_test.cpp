@@ -51,6 +51,51 @@ void test_absolute_time()
 	EXPECT_EQ(ls.get_absolute_time(),  some_time_us);
 }
 
+void test_absolute_time_monotonic()
+{
+	LockstepScheduler ls;
+	ls.set_absolute_time(some_time_us);
+
+	// going back in time is ignored
+	ls.set_absolute_time(some_time_us - 1000);
+	EXPECT_EQ(ls.get_absolute_time(), some_time_us);
+
+	// time sources racing each other can only move the time forward
+	std::atomic<bool> time_went_back{false};
+	std::thread reader([&]() {
+		uint64_t last = ls.get_absolute_time();
+
+		for (int i = 0; i < 100000; ++i) {
+			const uint64_t now = ls.get_absolute_time();
+
+			if (now < last) {
+				time_went_back = true;
+			}
+
+			last = now;
+		}
+	});
+
+	std::thread writers[2];
+
+	for (int w = 0; w < 2; ++w) {
+		writers[w] = std::thread([&ls, w]() {
+			for (uint64_t step = 1; step <= 10000; ++step) {
+				ls.set_absolute_time(some_time_us + step * 2 + w);
+			}
+		});
+	}
+
+	for (auto &writer : writers) {
+		writer.join();
+	}
+
+	reader.join();
+
+	EXPECT_FALSE(time_went_back);
+	EXPECT_EQ(ls.get_absolute_time(), some_time_us + 10000 * 2 + 1);
+}
+
 void test_condition_timing_out()
 {
 	// Create locked condition.
@@ -307,14 +352,63 @@ void test_usleep()
 	thread.join(ls);
 }
 
+void test_many_sleepers_wake_in_deadline_order()
+{
+	LockstepScheduler ls;
+	ls.set_absolute_time(some_time_us);
+
+	static constexpr int num_threads = 50;
+	static constexpr uint64_t step_us = 10;
+
+	std::atomic<int> num_woken{0};
+	std::atomic<uint64_t> woken_at[num_threads] {};
+	std::vector<std::shared_ptr<TestThread>> threads{};
+
+	// distinct deadlines, queued in scrambled order
+	auto deadline = [](int i) { return some_time_us + ((i * 37) % num_threads + 1) * step_us; };
+
+	for (int i = 0; i < num_threads; ++i) {
+		threads.push_back(std::make_shared<TestThread>([&ls, &num_woken, &woken_at, &deadline, i]() {
+			EXPECT_EQ(ls.usleep_until(deadline(i)), 0);
+			woken_at[i] = ls.get_absolute_time();
+			++num_woken;
+		}));
+	}
+
+	// give every thread the chance to queue its wait
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_EQ(num_woken, 0);
+
+	for (int step = 1; step <= num_threads; ++step) {
+		ls.set_absolute_time(some_time_us + step * step_us);
+
+		// exactly one sleeper is due per step
+		WAIT_FOR(num_woken >= step);
+		EXPECT_EQ(num_woken, step);
+	}
+
+	for (int i = 0; i < num_threads; ++i) {
+		threads[i]->join(ls);
+		EXPECT_EQ(woken_at[i], deadline(i));
+	}
+}
+
 TEST(LockstepScheduler, All)
 {
 	for (unsigned iteration = 1; iteration <= 100; ++iteration) {
 		//std::cout << "Test iteration: " << iteration << "\n";
 		test_absolute_time();
+		test_absolute_time_monotonic();
 		test_condition_timing_out();
 		test_locked_semaphore_getting_unlocked();
 		test_usleep();
 		test_multiple_semaphores_waiting();
 	}
 }
+
+TEST(LockstepScheduler, ManySleepers)
+{
+	for (unsigned iteration = 1; iteration <= 10; ++iteration) {
+		test_many_sleepers_wake_in_deadline_order();
+	}
+}
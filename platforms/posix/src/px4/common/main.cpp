@@ -171,10 +171,34 @@ int main(int argc, char **argv)
 			return -1;
 		}
 
+		px4_daemon::Client client(instance);
+
+		/* Run a sequence of commands over a single connection. */
+		if (argc >= 2 && (strcmp(argv[1], "--batch") == 0 || strcmp(argv[1], "--session") == 0)) {
+			const bool pipelined = strcmp(argv[1], "--batch") == 0;
+			FILE *in = stdin;
+
+			if (argc >= 3 && strcmp(argv[2], "-") != 0) {
+				in = fopen(argv[2], "r");
+
+				if (in == nullptr) {
+					PX4_ERR("failed to open %s: %s", argv[2], strerror(errno));
+					return -1;
+				}
+			}
+
+			const int ret = client.process_session(in, pipelined);
+
+			if (in != stdin) {
+				fclose(in);
+			}
+
+			return ret;
+		}
+
 		/* Remove the path and prefix. */
 		argv[0] += path_length + strlen(prefix);
 
-		px4_daemon::Client client(instance);
 		return client.process_args(argc, (const char **)argv);
 
 	} else {
@@ -605,6 +629,10 @@ void print_usage()
 	printf("\n");
 	printf("    px4-MODULE [--instance <instance>] command using symlink.\n");
 	printf("        e.g.: px4-commander status\n");
+	printf("    px4-MODULE [--instance <instance>] --batch|--session [<file>]\n");
+	printf("        run the commands in <file> (or stdin), one per line, over a single connection.\n");
+	printf("        --batch sends all commands without waiting for each result, --session runs\n");
+	printf("        them one at a time and flushes the output after each command.\n");
 }
 
 bool is_server_running(int instance, bool server)
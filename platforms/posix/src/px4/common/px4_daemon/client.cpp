@@ -41,6 +41,8 @@
 #include <errno.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -48,6 +50,7 @@
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <string>
 
 #include <px4_platform_common/log.h>
@@ -62,7 +65,7 @@ Client::Client(int instance_id) :
 {}
 
 int
-Client::process_args(const int argc, const char **argv)
+Client::_connect()
 {
 	std::string sock_path = get_socket_path(_instance_id);
 
@@ -82,6 +85,16 @@ Client::process_args(const int argc, const char **argv)
 		return -1;
 	}
 
+	return 0;
+}
+
+int
+Client::process_args(const int argc, const char **argv)
+{
+	if (_connect() != 0) {
+		return -1;
+	}
+
 	int ret = _send_cmds(argc, argv);
 
 	if (ret != 0) {
@@ -177,6 +190,165 @@ Client::_listen()
 	}
 }
 
+int
+Client::process_session(FILE *in, bool pipelined)
+{
+	if (_connect() != 0) {
+		return -1;
+	}
+
+	const char isatty_byte = isatty(STDOUT_FILENO);
+
+	std::string send_buf(1, (char)SESSION_START);
+	std::string recv_buf;
+	bool input_done = false;
+	int n_outstanding = 0;
+	int last_error = 0;
+
+	while (true) {
+		// Queue the next command, unless we have to wait for the previous result first.
+		if (!input_done && send_buf.empty() && (pipelined || n_outstanding == 0)) {
+			std::string cmd;
+
+			if (_read_session_command(in, cmd)) {
+				send_buf = cmd;
+				send_buf.push_back(isatty_byte);
+				++n_outstanding;
+
+			} else {
+				input_done = true;
+				// Let the server end the session once it ran all commands.
+				shutdown(_fd, SHUT_WR);
+			}
+		}
+
+		// Keep reading while sending, so neither side can block on a full socket buffer.
+		pollfd fds{_fd, (short)(POLLIN | (send_buf.empty() ? 0 : POLLOUT)), 0};
+
+		if (poll(&fds, 1, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			PX4_ERR("poll() failed: %s", strerror(errno));
+			return -1;
+		}
+
+		if (fds.revents & POLLOUT) {
+			ssize_t n_sent = write(_fd, send_buf.data(), send_buf.size());
+
+			if (n_sent < 0) {
+				PX4_ERR("write() failed: %s", strerror(errno));
+				return -1;
+			}
+
+			send_buf.erase(0, n_sent);
+		}
+
+		if (fds.revents & (POLLIN | POLLHUP | POLLERR)) {
+			char chunk[1024];
+			ssize_t n_read = read(_fd, chunk, sizeof chunk);
+
+			if (n_read < 0 && errno == EINTR) {
+				continue;
+			}
+
+			if (n_read <= 0) {
+				// The server closes the connection once it is done with the session. Waiting
+				// for that (instead of closing first) lets it exit the client thread cleanly.
+				return (n_read == 0 && input_done && n_outstanding == 0) ? last_error : -1;
+			}
+
+			recv_buf.append(chunk, n_read);
+			int n_done = _handle_session_frames(recv_buf, last_error);
+
+			if (n_done < 0) {
+				PX4_ERR("invalid session frame");
+				return -1;
+			}
+
+			n_outstanding -= n_done;
+
+			if (n_done > 0 && !pipelined) {
+				fflush(stdout);
+			}
+		}
+	}
+}
+
+bool
+Client::_read_session_command(FILE *in, std::string &out)
+{
+	char *line = nullptr;
+	size_t line_size = 0;
+	bool found = false;
+
+	while (getline(&line, &line_size, in) >= 0) {
+		std::string cmd(line);
+
+		// Bytes 0x00 - 0x02 have a special meaning on the wire.
+		cmd.erase(std::remove_if(cmd.begin(), cmd.end(), [](char c) { return (uint8_t)c <= SESSION_START || c == '\n' || c == '\r'; }),
+			  cmd.end());
+
+		const size_t first = cmd.find_first_not_of(" \t");
+
+		if (first == std::string::npos || cmd[first] == '#') {
+			continue;
+		}
+
+		out = cmd.substr(first);
+		found = true;
+		break;
+	}
+
+	free(line);
+	return found;
+}
+
+int
+Client::_handle_session_frames(std::string &buffer, int &last_error)
+{
+	int n_done = 0;
+	size_t pos = 0;
+
+	while (buffer.size() - pos >= SESSION_FRAME_HEADER_SIZE) {
+		const uint8_t *header = (const uint8_t *)buffer.data() + pos;
+		const size_t len = header[1] | (header[2] << 8);
+
+		if (buffer.size() - pos < SESSION_FRAME_HEADER_SIZE + len) {
+			break;
+		}
+
+		const char *payload = buffer.data() + pos + SESSION_FRAME_HEADER_SIZE;
+
+		switch ((SessionFrame)header[0]) {
+		case SessionFrame::Stdout:
+			fwrite(payload, len, 1, stdout);
+			break;
+
+		case SessionFrame::Retval:
+			if (len != 1) {
+				return -1;
+			}
+
+			if (payload[0] != 0) {
+				last_error = payload[0];
+			}
+
+			++n_done;
+			break;
+
+		default:
+			return -1;
+		}
+
+		pos += SESSION_FRAME_HEADER_SIZE + len;
+	}
+
+	buffer.erase(0, pos);
+	return n_done;
+}
+
 Client::~Client()
 {
 	if (_fd >= 0) {
@@ -40,6 +40,9 @@
  * It the client dies, the connection gets closed automatically and the corresponding
  * thread in the server gets cancelled.
  *
+ * For scripted use the client can also keep a single session open and run a
+ * whole sequence of commands over it (see sock_protocol.h).
+ *
  * @author Julian Oes <julian@oes.ch>
  * @author Beat Küng <beat-kueng@gmx.net>
  * @author Mara Bos <m-ou.se@m-ou.se>
@@ -47,6 +50,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdio.h>
+#include <string>
 
 #include "sock_protocol.h"
 
@@ -76,10 +81,29 @@ public:
 	 */
 	int process_args(const int argc, const char **argv);
 
+	/**
+	 * Open a session and run the commands read line by line from a stream, reusing
+	 * the same connection for all of them. Empty lines and lines starting with '#'
+	 * are skipped.
+	 *
+	 * @param in: stream to read the commands from
+	 * @param pipelined: if true, commands are sent without waiting for the result
+	 *                   of the previous one (batch mode). Otherwise each command
+	 *                   completes and its output is flushed before the next line
+	 *                   is read.
+	 * @return 0 if all commands succeeded, the return value of the last failing
+	 *         command otherwise, or -1 on a connection error
+	 */
+	int process_session(FILE *in, bool pipelined);
+
 private:
+	int _connect();
 	int _send_cmds(const int argc, const char **argv);
 	int _listen();
 
+	bool _read_session_command(FILE *in, std::string &out);
+	int _handle_session_frames(std::string &buffer, int &last_error);
+
 	int _fd;
 	int _instance_id; ///< instance ID for running multiple instances of the px4 server
 };
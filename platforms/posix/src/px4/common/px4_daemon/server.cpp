@@ -49,7 +49,9 @@
 #include <sys/stat.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
+#include <algorithm>
 #include <vector>
 
 #include <px4_platform_common/log.h>
@@ -252,6 +254,12 @@ void
 
 		cmd.resize(n + n_read);
 
+		if ((uint8_t)cmd[0] == SESSION_START) {
+			_handle_session(fd, cmd.substr(1));
+			_cleanup(fd);
+			return nullptr;
+		}
+
 		// Command ends in 0x00 (no tty) or 0x01 (tty).
 		if (!cmd.empty() && cmd.back() < 2) {
 			break;
@@ -295,6 +303,141 @@ void
 	return nullptr;
 }
 
+/**
+ * Write a complete session frame, retrying on partial writes.
+ */
+static bool send_session_frame(int fd, SessionFrame type, const char *data, size_t len)
+{
+	uint8_t header[SESSION_FRAME_HEADER_SIZE] = {(uint8_t)type, (uint8_t)(len & 0xff), (uint8_t)(len >> 8)};
+	iovec iov[2] = {{header, sizeof header}, {(void *)data, len}};
+	int iov_index = 0;
+
+	while (iov_index < 2) {
+		ssize_t n_written = writev(fd, &iov[iov_index], 2 - iov_index);
+
+		if (n_written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			return false;
+		}
+
+		while (iov_index < 2 && (size_t)n_written >= iov[iov_index].iov_len) {
+			n_written -= iov[iov_index].iov_len;
+			++iov_index;
+		}
+
+		if (iov_index < 2) {
+			iov[iov_index].iov_base = (char *)iov[iov_index].iov_base + n_written;
+			iov[iov_index].iov_len -= n_written;
+		}
+	}
+
+	return true;
+}
+
+static ssize_t session_stdout_write(void *cookie, const char *buf, size_t size)
+{
+	const int fd = (int)(intptr_t)cookie;
+	size_t n_left = size;
+
+	while (n_left > 0) {
+		const size_t len = std::min(n_left, SESSION_FRAME_MAX_PAYLOAD);
+
+		if (!send_session_frame(fd, SessionFrame::Stdout, buf, len)) {
+			return -1;
+		}
+
+		buf += len;
+		n_left -= len;
+	}
+
+	return size;
+}
+
+#if defined(__PX4_DARWIN)
+static int session_stdout_write_darwin(void *cookie, const char *buf, int size)
+{
+	return session_stdout_write(cookie, buf, size);
+}
+#endif
+
+/**
+ * Open a stream that wraps everything written to it in SessionFrame::Stdout frames.
+ * Closing the stream does not close the underlying fd.
+ */
+static FILE *open_session_stdout(int fd)
+{
+#if defined(__PX4_DARWIN)
+	return funopen((void *)(intptr_t)fd, nullptr, session_stdout_write_darwin, nullptr, nullptr);
+#else
+	cookie_io_functions_t io_functions{};
+	io_functions.write = session_stdout_write;
+	return fopencookie((void *)(intptr_t)fd, "w", io_functions);
+#endif
+}
+
+void
+Server::_handle_session(int fd, std::string buffer)
+{
+	FILE *out = open_session_stdout(fd);
+
+	if (out == nullptr) {
+		PX4_ERR("could not open session stdout");
+		return;
+	}
+
+	setvbuf(out, nullptr, _IOLBF, BUFSIZ);
+
+	// The thread specific data is released at the end of the session, before its stdout is
+	// closed. The key destructor only covers a session thread that is cancelled.
+	CmdThreadSpecificData *thread_data_ptr = new CmdThreadSpecificData;
+	thread_data_ptr->thread_stdout = out;
+	thread_data_ptr->is_atty = false;
+	(void)pthread_setspecific(_instance->_key, (void *)thread_data_ptr);
+
+	char chunk[1024];
+
+	while (true) {
+		// Each command ends in 0x00 (no tty) or 0x01 (tty).
+		auto end = std::find_if(buffer.begin(), buffer.end(), [](char c) { return (uint8_t)c < 2; });
+
+		if (end == buffer.end()) {
+			ssize_t n_read = read(fd, chunk, sizeof chunk);
+
+			if (n_read < 0 && errno == EINTR) {
+				continue;
+			}
+
+			if (n_read <= 0) {
+				// Client closed its side, the session is done.
+				break;
+			}
+
+			buffer.append(chunk, n_read);
+			continue;
+		}
+
+		const std::string cmd(buffer.begin(), end);
+		thread_data_ptr->is_atty = *end;
+		buffer.erase(buffer.begin(), end + 1);
+
+		const char retval = (char)Pxh::process_line(cmd, true);
+
+		// The command output must reach the client before its return value.
+		fflush(out);
+
+		if (!send_session_frame(fd, SessionFrame::Retval, &retval, 1)) {
+			break;
+		}
+	}
+
+	(void)pthread_setspecific(_instance->_key, nullptr);
+	delete thread_data_ptr;
+	fclose(out);
+}
+
 void
 Server::_cleanup(int fd)
 {
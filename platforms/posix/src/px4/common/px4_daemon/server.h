@@ -39,6 +39,10 @@
  * The server will return the stdout of the executing command, as well as the return
  * value to the client.
  *
+ * Alternatively a client can open a session (see sock_protocol.h) and run many
+ * commands over the same connection and client thread, which avoids the socket
+ * setup and thread creation for every single command.
+ *
  * There should only every be one server running, therefore the static instance.
  * The Singleton implementation is not complete, but it should be obvious not
  * to instantiate multiple servers.
@@ -54,6 +58,7 @@
 #include <stdbool.h>
 #include <pthread.h>
 #include <map>
+#include <string>
 
 #include "sock_protocol.h"
 
@@ -104,6 +109,7 @@ private:
 	}
 
 	static void *_handle_client(void *arg);
+	static void _handle_session(int fd, std::string buffer);
 	static void _cleanup(int fd);
 
 	pthread_t _server_main_pthread;
@@ -33,10 +33,25 @@
 /**
  * @file sock_protocol.h
  *
+ * Two protocols are spoken on the daemon socket:
+ *
+ * One-shot: the client sends a single command followed by an 'isatty' byte
+ * (0x00 or 0x01). The server streams back the raw stdout of the command,
+ * followed by {0, retval}, and closes the connection.
+ *
+ * Session: the client starts with a SESSION_START byte and can then send any
+ * number of commands, each terminated by its 'isatty' byte. Commands may be
+ * pipelined; the server executes them in order on a single thread. Every
+ * response is sent as a sequence of frames {type, len_lo, len_hi, payload},
+ * where a SessionFrame::Retval frame (payload: 1 byte return value) ends the
+ * response of the current command. The session ends when the client shuts
+ * down its sending side.
+ *
  * @author Mara Bos <m-ou.se@m-ou.se>
  */
 #pragma once
 
+#include <stdint.h>
 #include <string>
 
 namespace px4_daemon
@@ -44,5 +59,16 @@ namespace px4_daemon
 
 std::string get_socket_path(int instance_id);
 
+/// First byte sent by a client to open a persistent session instead of a one-shot command
+static constexpr uint8_t SESSION_START = 0x02;
+
+enum class SessionFrame : uint8_t {
+	Stdout = 1, ///< stdout data of the running command
+	Retval = 2, ///< return value, ends the response of a command
+};
+
+static constexpr size_t SESSION_FRAME_HEADER_SIZE = 3;
+static constexpr size_t SESSION_FRAME_MAX_PAYLOAD = UINT16_MAX;
+
 } // namespace px4_daemon
 
@@ -0,0 +1,204 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file IntrusiveMPSCQueue.hpp
+ *
+ * Intrusive FIFO with lock-free multi-producer push and a single consumer.
+ *
+ * Producers push onto an atomic LIFO inbox with a CAS, the consumer takes the
+ * whole inbox at once and appends it, in push order, to a private list. A node
+ * is queued at most once: pushing a node that is already queued is a no-op,
+ * until it has been popped (or removed) by the consumer.
+ *
+ * push() may be called from any thread (or ISR). All other methods belong to
+ * the consumer and must be serialized by the caller.
+ */
+
+#pragma once
+
+#include <px4_platform_common/atomic.h>
+
+template<class T>
+class IntrusiveMPSCQueue
+{
+public:
+
+	/**
+	 * Queue a node (lock-free).
+	 *
+	 * @return false if the node was already queued
+	 */
+	bool push(T newNode) { return push(newNode, [](T) {}); }
+
+	/**
+	 * Queue a node (lock-free), calling on_queued(newNode) once this push owns
+	 * the node but before the consumer can see it (e.g. to timestamp it).
+	 *
+	 * @return false if the node was already queued
+	 */
+	template<typename F>
+	bool push(T newNode, F on_queued)
+	{
+		bool queued = false;
+
+		if (!newNode->_mpsc_queued.compare_exchange(&queued, true)) {
+			// already queued
+			return false;
+		}
+
+		on_queued(newNode);
+
+		T head = _inbox.load();
+
+		do {
+			newNode->_next_mpsc_queue_node = head;
+		} while (!_inbox.compare_exchange(&head, newNode));
+
+		return true;
+	}
+
+	bool empty() const { return (_head == nullptr) && (_inbox.load() == nullptr); }
+
+	// the node pop() returns next, it stays queued until then
+	T front()
+	{
+		if (_head == nullptr) {
+			collect();
+		}
+
+		return _head;
+	}
+
+	T pop()
+	{
+		T ret = front();
+
+		if (ret != nullptr) {
+			_head = ret->_next_mpsc_queue_node;
+
+			if (_head == nullptr) {
+				_tail = nullptr;
+			}
+
+			ret->_next_mpsc_queue_node = nullptr;
+
+			// from now on the node can be queued again (e.g. by itself while running)
+			ret->_mpsc_queued.store(false);
+		}
+
+		return ret;
+	}
+
+	bool remove(T removeNode)
+	{
+		collect();
+
+		T prev = nullptr;
+
+		for (T node = _head; node != nullptr; node = node->_next_mpsc_queue_node) {
+			if (node == removeNode) {
+				if (prev == nullptr) {
+					_head = node->_next_mpsc_queue_node;
+
+				} else {
+					prev->_next_mpsc_queue_node = node->_next_mpsc_queue_node;
+				}
+
+				if (node == _tail) {
+					_tail = prev;
+				}
+
+				node->_next_mpsc_queue_node = nullptr;
+				node->_mpsc_queued.store(false);
+				return true;
+			}
+
+			prev = node;
+		}
+
+		return false;
+	}
+
+	void clear()
+	{
+		while (pop() != nullptr) {}
+	}
+
+private:
+
+	// move everything pushed so far to the private list, restoring push order
+	void collect()
+	{
+		T node = _inbox.load();
+
+		while (!_inbox.compare_exchange(&node, nullptr)) {}
+
+		T first = nullptr;
+		T last = node;
+
+		while (node != nullptr) {
+			T next = node->_next_mpsc_queue_node;
+			node->_next_mpsc_queue_node = first;
+			first = node;
+			node = next;
+		}
+
+		if (first != nullptr) {
+			if (_tail != nullptr) {
+				_tail->_next_mpsc_queue_node = first;
+
+			} else {
+				_head = first;
+			}
+
+			_tail = last;
+		}
+	}
+
+	px4::atomic<T> _inbox{nullptr}; ///< pushed but not yet collected, newest first
+
+	// consumer private FIFO
+	T _head{nullptr};
+	T _tail{nullptr};
+};
+
+template<class T>
+class IntrusiveMPSCQueueNode
+{
+private:
+	friend IntrusiveMPSCQueue<T>;
+
+	T _next_mpsc_queue_node{nullptr};
+	px4::atomic_bool _mpsc_queued{false};
+};
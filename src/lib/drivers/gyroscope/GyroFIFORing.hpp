@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file GyroFIFORing.hpp
+ *
+ * Per instance ring of raw gyro FIFO bursts shared between the driver (PX4Gyroscope) and
+ * consumers in the same address space. The single writer fills the next slot in place and
+ * commits it, readers access the bursts in place and keep track of their own position.
+ * A reader detects a slot overwritten while it was reading it (seqlock) and must then
+ * discard what it read. Rings outlive their driver, so the writer generation tells a reader
+ * whether the ring is still fed by the publisher it attached to.
+ */
+
+#pragma once
+
+#include <px4_platform_common/atomic.h>
+#include <uORB/topics/sensor_gyro_fifo.h>
+
+class GyroFIFORing
+{
+public:
+	static constexpr unsigned SIZE = sensor_gyro_fifo_s::ORB_QUEUE_LENGTH;
+	static_assert((SIZE & (SIZE - 1)) == 0, "SIZE must be a power of 2");
+
+	static constexpr int MAX_INSTANCES = 4;
+
+	/**
+	 * Get the ring of a sensor_gyro_fifo instance. Rings are created by the driver and never freed,
+	 * so a reader can safely keep the pointer.
+	 *
+	 * @param instance sensor_gyro_fifo uORB instance
+	 * @param create create the ring if it doesn't exist yet (driver only)
+	 * @return nullptr if not available (e.g. driver in another address space)
+	 */
+	static GyroFIFORing *get(int instance, bool create = false)
+	{
+		if ((instance < 0) || (instance >= MAX_INSTANCES)) {
+			return nullptr;
+		}
+
+		px4::atomic<GyroFIFORing *> &ring = rings()[instance];
+
+		if ((ring.load() == nullptr) && create) {
+			// only the single publisher of an instance creates its ring
+			ring.store(new GyroFIFORing());
+		}
+
+		return ring.load();
+	}
+
+	// writer: take ownership of the ring, invalidating readers attached to a previous writer
+	void writer_start() { _writer.fetch_add((_writer.load() & 1) ? 2 : 1); }
+
+	// writer: stop feeding the ring (e.g. driver stopped), readers fall back to uORB
+	void writer_stop()
+	{
+		if (_writer.load() & 1) {
+			_writer.fetch_add(1);
+		}
+	}
+
+	// writer: slot of the next burst, filled in place
+	sensor_gyro_fifo_s &claim() { return _buffer[_write.load() & (SIZE - 1)]; }
+
+	// writer: make the claimed burst visible to readers
+	void commit() { _write.fetch_add(1); }
+
+	class Reader
+	{
+	public:
+		bool attached() const { return _ring != nullptr; }
+
+		// start reading the bursts committed from now on, only if the ring has an active writer
+		bool attach(GyroFIFORing *ring)
+		{
+			_ring = nullptr;
+
+			if (ring != nullptr) {
+				const unsigned writer = ring->_writer.load();
+
+				if (writer & 1) {
+					_writer = writer;
+					_read = ring->_write.load();
+					_ring = ring;
+				}
+			}
+
+			return attached();
+		}
+
+		void detach() { _ring = nullptr; }
+
+		// false once the writer attached to has stopped or was replaced (ring stale)
+		bool writer_valid() const { return attached() && (_ring->_writer.load() == _writer); }
+
+		bool available() const { return attached() && (_ring->_write.load() != _read); }
+
+		/**
+		 * Next unread burst in place, followed by release() once it has been read
+		 *
+		 * @param gap set if bursts were overwritten before they could be read
+		 * @return nullptr if there is no new burst
+		 */
+		const sensor_gyro_fifo_s *peek(bool &gap)
+		{
+			const unsigned write = _ring->_write.load();
+
+			if (write == _read) {
+				return nullptr;
+			}
+
+			if (write - _read >= SIZE) {
+				// skip to the oldest burst that isn't being overwritten
+				_read = write - (SIZE - 1);
+				gap = true;
+			}
+
+			return &_ring->_buffer[_read & (SIZE - 1)];
+		}
+
+		/**
+		 * Finish reading the burst returned by peek()
+		 *
+		 * @return false if the writer started overwriting the burst while it was read
+		 */
+		bool release()
+		{
+			// order the reads of the burst before the check
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+			const bool valid = (_ring->_write.load() - _read) < SIZE;
+			_read++;
+			return valid;
+		}
+
+	private:
+		GyroFIFORing *_ring{nullptr};
+		unsigned _read{0};
+		unsigned _writer{0};
+	};
+
+private:
+	GyroFIFORing() = default;
+
+	static px4::atomic<GyroFIFORing *> *rings()
+	{
+		static px4::atomic<GyroFIFORing *> rings[MAX_INSTANCES] {};
+		return rings;
+	}
+
+	sensor_gyro_fifo_s _buffer[SIZE] {};
+	px4::atomic<unsigned> _write{0};
+	px4::atomic<unsigned> _writer{0}; // writer generation, odd while a writer is active
+};
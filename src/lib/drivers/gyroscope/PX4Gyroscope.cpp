@@ -78,6 +78,11 @@ PX4Gyroscope::PX4Gyroscope(uint32_t device_id, enum Rotation rotation) :
 
 PX4Gyroscope::~PX4Gyroscope()
 {
+	if (_fifo_ring != nullptr) {
+		// the ring outlives the driver, mark it stale for readers
+		_fifo_ring->writer_stop();
+	}
+
 	_sensor_pub.unadvertise();
 	_sensor_fifo_pub.unadvertise();
 }
@@ -136,39 +141,67 @@ void PX4Gyroscope::update(const hrt_abstime &timestamp_sample, float x, float y,
 
 void PX4Gyroscope::updateFIFO(sensor_gyro_fifo_s &sample)
 {
+	if ((_fifo_ring == nullptr) && _sensor_fifo_pub.advertise()) {
+		// shared FIFO ring of this sensor_gyro_fifo instance (consumed in place by VehicleAngularVelocity)
+		_fifo_ring = GyroFIFORing::get(_sensor_fifo_pub.get_instance(), true);
+
+		if (_fifo_ring != nullptr) {
+			_fifo_ring->writer_start();
+		}
+	}
+
+	// fill the next ring slot directly if available, otherwise work in place
+	sensor_gyro_fifo_s &fifo = (_fifo_ring != nullptr) ? _fifo_ring->claim() : sample;
+
 	// rotate all raw samples and publish fifo
 	const uint8_t N = sample.samples;
 
 	for (int n = 0; n < N; n++) {
-		rotate_3i(_rotation, sample.x[n], sample.y[n], sample.z[n]);
+		int16_t x = sample.x[n];
+		int16_t y = sample.y[n];
+		int16_t z = sample.z[n];
+
+		rotate_3i(_rotation, x, y, z);
+
+		fifo.x[n] = x;
+		fifo.y[n] = y;
+		fifo.z[n] = z;
+	}
+
+	fifo.timestamp_sample = sample.timestamp_sample;
+	fifo.dt = sample.dt;
+	fifo.samples = N;
+	fifo.device_id = _device_id;
+	fifo.scale = _scale;
+	fifo.timestamp = hrt_absolute_time();
+
+	if (_fifo_ring != nullptr) {
+		_fifo_ring->commit();
 	}
 
-	sample.device_id = _device_id;
-	sample.scale = _scale;
-	sample.timestamp = hrt_absolute_time();
-	_sensor_fifo_pub.publish(sample);
+	_sensor_fifo_pub.publish(fifo);
 
 
 	// publish
 	sensor_gyro_s report;
-	report.timestamp_sample = sample.timestamp_sample;
+	report.timestamp_sample = fifo.timestamp_sample;
 	report.device_id = _device_id;
 	report.temperature = _temperature;
 	report.error_count = _error_count;
 
 	// trapezoidal integration (equally spaced)
 	const float scale = _scale / (float)N;
-	report.x = (0.5f * (_last_sample[0] + sample.x[N - 1]) + sum(sample.x, N - 1)) * scale;
-	report.y = (0.5f * (_last_sample[1] + sample.y[N - 1]) + sum(sample.y, N - 1)) * scale;
-	report.z = (0.5f * (_last_sample[2] + sample.z[N - 1]) + sum(sample.z, N - 1)) * scale;
+	report.x = (0.5f * (_last_sample[0] + fifo.x[N - 1]) + sum(fifo.x, N - 1)) * scale;
+	report.y = (0.5f * (_last_sample[1] + fifo.y[N - 1]) + sum(fifo.y, N - 1)) * scale;
+	report.z = (0.5f * (_last_sample[2] + fifo.z[N - 1]) + sum(fifo.z, N - 1)) * scale;
 
-	_last_sample[0] = sample.x[N - 1];
-	_last_sample[1] = sample.y[N - 1];
-	_last_sample[2] = sample.z[N - 1];
+	_last_sample[0] = fifo.x[N - 1];
+	_last_sample[1] = fifo.y[N - 1];
+	_last_sample[2] = fifo.z[N - 1];
 
-	report.clip_counter[0] = clipping(sample.x, N);
-	report.clip_counter[1] = clipping(sample.y, N);
-	report.clip_counter[2] = clipping(sample.z, N);
+	report.clip_counter[0] = clipping(fifo.x, N);
+	report.clip_counter[1] = clipping(fifo.y, N);
+	report.clip_counter[2] = clipping(fifo.z, N);
 	report.samples = N;
 	report.timestamp = hrt_absolute_time();
 
@@ -33,6 +33,8 @@
 
 #pragma once
 
+#include "GyroFIFORing.hpp"
+
 #include <drivers/drv_hrt.h>
 #include <lib/conversion/rotation.h>
 #include <uORB/PublicationMulti.hpp>
@@ -68,6 +70,8 @@ private:
 	uORB::PublicationMulti<sensor_gyro_s> _sensor_pub{ORB_ID(sensor_gyro)};
 	uORB::PublicationMulti<sensor_gyro_fifo_s>  _sensor_fifo_pub{ORB_ID(sensor_gyro_fifo)};
 
+	GyroFIFORing		*_fifo_ring{nullptr};
+
 	uint32_t		_device_id{0};
 	const enum Rotation	_rotation;
 
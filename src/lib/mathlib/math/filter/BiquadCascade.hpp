@@ -0,0 +1,262 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file BiquadCascade.hpp
+ *
+ * @brief Cascade of second order filter sections applied to three interleaved axes.
+ *
+ * Coefficients and state of all stages are stored contiguously with one lane per axis
+ * (padded to four lanes), so the complete chain is applied to a sample of all three axes
+ * in a single pass with a kernel that the compiler can map onto SIMD instructions.
+ * Each stage uses the direct form I, like NotchFilter.
+ */
+
+#pragma once
+
+#include <mathlib/math/Functions.hpp>
+#include <float.h>
+#include <stdint.h>
+
+namespace math
+{
+
+class BiquadCascade
+{
+public:
+	static constexpr int AXES = 3;
+
+	BiquadCascade() = default;
+	~BiquadCascade() { delete[] _stages; delete[] _active; }
+
+	BiquadCascade(const BiquadCascade &) = delete;
+	BiquadCascade &operator=(const BiquadCascade &) = delete;
+
+	/**
+	 * (Re)allocate storage for the given number of stages, all stages start bypassed
+	 *
+	 * @return false if the allocation failed
+	 */
+	bool allocate(int num_stages)
+	{
+		delete[] _stages;
+		delete[] _active;
+		_stages = nullptr;
+		_active = nullptr;
+		_num_stages = 0;
+		_num_active = 0;
+
+		if (num_stages <= 0) {
+			return true;
+		}
+
+		_stages = new Stage[num_stages];
+		_active = new uint16_t[num_stages];
+
+		if ((_stages == nullptr) || (_active == nullptr)) {
+			delete[] _stages;
+			delete[] _active;
+			_stages = nullptr;
+			_active = nullptr;
+			return false;
+		}
+
+		_num_stages = num_stages;
+		return true;
+	}
+
+	int stages() const { return _num_stages; }
+	int activeStages() const { return _num_active; }
+
+	/**
+	 * Set the coefficients (normalized by a0) of a stage for one axis.
+	 * The stage state is kept, a reset needs to be requested separately.
+	 */
+	void setCoefficients(int stage, int axis, const float a[3], const float b[3])
+	{
+		if (valid(stage, axis)) {
+			Stage &s = _stages[stage];
+			s.b0[axis] = b[0];
+			s.b1[axis] = b[1];
+			s.b2[axis] = b[2];
+			s.a1[axis] = a[1];
+			s.a2[axis] = a[2];
+
+			if (!s.enabled[axis]) {
+				s.enabled[axis] = true;
+				s.reset_pending[axis] = true;
+				_active_update = true;
+			}
+		}
+	}
+
+	// bypass a stage for one axis
+	void disable(int stage, int axis)
+	{
+		if (valid(stage, axis)) {
+			Stage &s = _stages[stage];
+			s.b0[axis] = 1.f;
+			s.b1[axis] = s.b2[axis] = s.a1[axis] = s.a2[axis] = 0.f;
+			s.x1[axis] = s.x2[axis] = s.y1[axis] = s.y2[axis] = 0.f;
+			s.reset_pending[axis] = false;
+
+			if (s.enabled[axis]) {
+				s.enabled[axis] = false;
+				_active_update = true;
+			}
+		}
+	}
+
+	bool enabled(int stage, int axis) const { return valid(stage, axis) && _stages[stage].enabled[axis]; }
+
+	// reset the stage state of one axis with its next input sample
+	void reset(int stage, int axis)
+	{
+		if (enabled(stage, axis)) {
+			_stages[stage].reset_pending[axis] = true;
+		}
+	}
+
+	// reset the stage state of one axis assuming a constant input sample
+	void reset(int stage, int axis, float sample)
+	{
+		if (enabled(stage, axis)) {
+			resetLane(_stages[stage], axis, sample);
+		}
+	}
+
+	/**
+	 * Filter arrays of samples of all axes in place, stage by stage for each sample
+	 *
+	 * @param data array of AXES pointers to num_samples samples each
+	 */
+	void apply(float *const data[AXES], int num_samples)
+	{
+		if (_active_update) {
+			updateActiveStages();
+		}
+
+		for (int n = 0; n < num_samples; n++) {
+			float v[LANES] {data[0][n], data[1][n], data[2][n], 0.f};
+
+			for (int i = 0; i < _num_active; i++) {
+				Stage &s = _stages[_active[i]];
+
+				if (s.reset_pending[0] || s.reset_pending[1] || s.reset_pending[2]) {
+					for (int axis = 0; axis < AXES; axis++) {
+						if (s.reset_pending[axis]) {
+							resetLane(s, axis, v[axis]);
+						}
+					}
+				}
+
+				for (int k = 0; k < LANES; k++) {
+					const float output = s.b0[k] * v[k] + s.b1[k] * s.x1[k] + s.b2[k] * s.x2[k] - s.a1[k] * s.y1[k] - s.a2[k] * s.y2[k];
+
+					s.x2[k] = s.x1[k];
+					s.x1[k] = v[k];
+					s.y2[k] = s.y1[k];
+					s.y1[k] = output;
+
+					v[k] = output;
+				}
+			}
+
+			for (int axis = 0; axis < AXES; axis++) {
+				data[axis][n] = v[axis];
+			}
+		}
+	}
+
+private:
+	static constexpr int LANES = 4;
+
+	struct Stage {
+		// coefficients normalized by a0, a bypassed lane passes the input through unchanged
+		float b0[LANES] {1.f, 1.f, 1.f, 1.f};
+		float b1[LANES] {};
+		float b2[LANES] {};
+		float a1[LANES] {};
+		float a2[LANES] {};
+
+		// direct form I input and output delay elements
+		float x1[LANES] {};
+		float x2[LANES] {};
+		float y1[LANES] {};
+		float y2[LANES] {};
+
+		bool enabled[LANES] {};
+		bool reset_pending[LANES] {};
+	};
+
+	bool valid(int stage, int axis) const { return (stage >= 0) && (stage < _num_stages) && (axis >= 0) && (axis < AXES); }
+
+	static void resetLane(Stage &s, int axis, float sample)
+	{
+		const float input = isFinite(sample) ? sample : 0.f;
+
+		s.x1[axis] = s.x2[axis] = input;
+		s.y1[axis] = s.y2[axis] = input * (s.b0[axis] + s.b1[axis] + s.b2[axis]) / (1.f + s.a1[axis] + s.a2[axis]);
+
+		if (!isFinite(s.y1[axis])) {
+			s.y1[axis] = s.y2[axis] = 0.f;
+		}
+
+		s.reset_pending[axis] = false;
+	}
+
+	void updateActiveStages()
+	{
+		_num_active = 0;
+
+		for (int stage = 0; stage < _num_stages; stage++) {
+			const Stage &s = _stages[stage];
+
+			if (s.enabled[0] || s.enabled[1] || s.enabled[2]) {
+				_active[_num_active++] = stage;
+			}
+		}
+
+		_active_update = false;
+	}
+
+	Stage *_stages{nullptr};
+	uint16_t *_active{nullptr};	///< indices of the stages enabled for at least one axis in filter order
+
+	int _num_stages{0};
+	int _num_active{0};
+
+	bool _active_update{false};
+};
+
+} // namespace math
@@ -59,6 +59,14 @@ public:
 
 	bool setParameters(float sample_freq, float notch_freq, float bandwidth);
 
+	/**
+	 * Change only the notch frequency of a filter already configured with setParameters(),
+	 * keeping sample frequency and bandwidth. The cosine of the normalized notch frequency
+	 * cos(2 * pi * notch_freq / sample_freq) is passed in so that it can be shared between
+	 * filters or derived incrementally (e.g. harmonics of the same fundamental).
+	 */
+	bool setNotchFreq(float notch_freq, float cos_notch_freq);
+
 	/**
 	 * Add a new raw value to the filter using the Direct Form I
 	 *
@@ -90,7 +98,7 @@ public:
 	float getNotchFreq() const { return _notch_freq; }
 	float getBandwidth() const { return _bandwidth; }
 
-	// Used in unit test only
+	// Coefficients normalized by a0, used to configure a BiquadCascade stage
 	void getCoefficients(float a[3], float b[3]) const
 	{
 		a[0] = 1.f;
@@ -239,24 +247,7 @@ bool NotchFilter<T>::setParameters(float sample_freq, float notch_freq, float ba
 
 		if (notch_freq_diff > FLT_EPSILON) {
 			// only notch frequency has changed
-			_notch_freq = notch_freq_new;
-
-			const float beta = -cosf(2.f * M_PI_F * _notch_freq / _sample_freq);
-
-			_b1 = 2.f * beta * _b0;
-			_a1 = _b1;
-
-			if (notch_freq_diff > _bandwidth) {
-				// force reset
-				_initialized = false;
-			}
-
-			if (!isFinite(_b1)) {
-				disable();
-				return false;
-			}
-
-			return true;
+			return setNotchFreq(notch_freq_new, cosf(2.f * M_PI_F * notch_freq_new / _sample_freq));
 
 		} else {
 			// no change, do nothing
@@ -295,4 +286,36 @@ bool NotchFilter<T>::setParameters(float sample_freq, float notch_freq, float ba
 	return true;
 }
 
+template<typename T>
+bool NotchFilter<T>::setNotchFreq(float notch_freq, float cos_notch_freq)
+{
+	if ((_sample_freq <= 0.f) || (_bandwidth <= 0.f) || (notch_freq <= 0.f) || (notch_freq >= _sample_freq / 2)
+	    || !isFinite(notch_freq) || !isFinite(cos_notch_freq)) {
+
+		disable();
+		return false;
+	}
+
+	const float notch_freq_diff = fabsf(notch_freq - _notch_freq);
+
+	_notch_freq = notch_freq;
+
+	const float beta = -cos_notch_freq;
+
+	_b1 = 2.f * beta * _b0;
+	_a1 = _b1;
+
+	if (notch_freq_diff > _bandwidth) {
+		// force reset
+		_initialized = false;
+	}
+
+	if (!isFinite(_b1)) {
+		disable();
+		return false;
+	}
+
+	return true;
+}
+
 } // namespace math
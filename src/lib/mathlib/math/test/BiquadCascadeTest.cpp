@@ -0,0 +1,187 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file BiquadCascadeTest.cpp
+ *
+ * @brief Unit tests for the biquad cascade filter
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include <lib/mathlib/math/filter/BiquadCascade.hpp>
+#include <lib/mathlib/math/filter/LowPassFilter2p.hpp>
+#include <lib/mathlib/math/filter/NotchFilter.hpp>
+
+using namespace math;
+
+class BiquadCascadeTest : public ::testing::Test
+{
+public:
+	static constexpr float SAMPLE_FREQ = 1000.f;
+	static constexpr int N = 500;
+
+	float input(int axis, int n) const
+	{
+		const float t = n / SAMPLE_FREQ;
+		return (axis + 1) * sinf(2.f * M_PI_F * 5.f * t) + sinf(2.f * M_PI_F * 50.f * t) + 0.5f * sinf(2.f * M_PI_F * 120.f * t);
+	}
+};
+
+TEST_F(BiquadCascadeTest, bypassedByDefault)
+{
+	BiquadCascade cascade;
+	ASSERT_TRUE(cascade.allocate(4));
+	EXPECT_EQ(cascade.stages(), 4);
+
+	float x[N], y[N], z[N];
+
+	for (int n = 0; n < N; n++) {
+		x[n] = input(0, n);
+		y[n] = input(1, n);
+		z[n] = input(2, n);
+	}
+
+	float *data[3] {x, y, z};
+	cascade.apply(data, N);
+	EXPECT_EQ(cascade.activeStages(), 0);
+
+	for (int n = 0; n < N; n++) {
+		EXPECT_EQ(x[n], input(0, n));
+		EXPECT_EQ(y[n], input(1, n));
+		EXPECT_EQ(z[n], input(2, n));
+	}
+}
+
+TEST_F(BiquadCascadeTest, matchesIndividualFilters)
+{
+	// GIVEN: a chain of two notch filters, the second one only on the y axis, followed by a low pass filter
+	NotchFilter<float> notch_50[3];
+	NotchFilter<float> notch_120;
+	LowPassFilter2p<float> lpf[3];
+
+	BiquadCascade cascade;
+	ASSERT_TRUE(cascade.allocate(3));
+
+	float a[3];
+	float b[3];
+
+	for (int axis = 0; axis < 3; axis++) {
+		notch_50[axis].setParameters(SAMPLE_FREQ, 50.f, 10.f);
+		notch_50[axis].getCoefficients(a, b);
+		cascade.setCoefficients(0, axis, a, b);
+
+		lpf[axis].set_cutoff_frequency(SAMPLE_FREQ, 80.f);
+		lpf[axis].reset(0.f);
+		lpf[axis].getCoefficients(a, b);
+		cascade.setCoefficients(2, axis, a, b);
+		cascade.reset(2, axis, 0.f);
+	}
+
+	notch_120.setParameters(SAMPLE_FREQ, 120.f, 20.f);
+	notch_120.getCoefficients(a, b);
+	cascade.setCoefficients(1, 1, a, b);
+
+	// WHEN: the samples are filtered in batches
+	float data_cascade[3][N];
+	float data_filters[3][N];
+
+	for (int axis = 0; axis < 3; axis++) {
+		for (int n = 0; n < N; n++) {
+			data_cascade[axis][n] = data_filters[axis][n] = input(axis, n);
+		}
+	}
+
+	static constexpr int BATCH = 10;
+
+	for (int n = 0; n < N; n += BATCH) {
+		float *data[3] {&data_cascade[0][n], &data_cascade[1][n], &data_cascade[2][n]};
+		cascade.apply(data, BATCH);
+
+		for (int axis = 0; axis < 3; axis++) {
+			notch_50[axis].applyArray(&data_filters[axis][n], BATCH);
+
+			if (axis == 1) {
+				notch_120.applyArray(&data_filters[axis][n], BATCH);
+			}
+
+			lpf[axis].applyArray(&data_filters[axis][n], BATCH);
+		}
+	}
+
+	// THEN: the cascade gives the same result as the individual filters
+	EXPECT_EQ(cascade.activeStages(), 3);
+
+	for (int axis = 0; axis < 3; axis++) {
+		for (int n = 0; n < N; n++) {
+			EXPECT_NEAR(data_cascade[axis][n], data_filters[axis][n], 1e-4f) << "axis " << axis << " sample " << n;
+		}
+	}
+}
+
+TEST_F(BiquadCascadeTest, disableStage)
+{
+	BiquadCascade cascade;
+	ASSERT_TRUE(cascade.allocate(2));
+
+	NotchFilter<float> notch;
+	notch.setParameters(SAMPLE_FREQ, 50.f, 10.f);
+
+	float a[3];
+	float b[3];
+	notch.getCoefficients(a, b);
+
+	for (int axis = 0; axis < 3; axis++) {
+		cascade.setCoefficients(1, axis, a, b);
+	}
+
+	EXPECT_TRUE(cascade.enabled(1, 0));
+	EXPECT_FALSE(cascade.enabled(0, 0));
+
+	cascade.disable(1, 0);
+	cascade.disable(1, 1);
+	cascade.disable(1, 2);
+	EXPECT_FALSE(cascade.enabled(1, 2));
+
+	float x[1] {1.f};
+	float y[1] {2.f};
+	float z[1] {3.f};
+	float *data[3] {x, y, z};
+	cascade.apply(data, 1);
+
+	EXPECT_EQ(cascade.activeStages(), 0);
+	EXPECT_EQ(x[0], 1.f);
+	EXPECT_EQ(y[0], 2.f);
+	EXPECT_EQ(z[0], 3.f);
+}
@@ -347,3 +347,51 @@ TEST_F(NotchFilterTest, setCoefficients)
 		EXPECT_EQ(b[i], b_new[i]);
 	}
 }
+
+TEST_F(NotchFilterTest, setNotchFreqHarmonics)
+{
+	// GIVEN: harmonics of a fundamental frequency with the cosine derived incrementally
+	const float fundamental = 47.3f;
+	const float cos_fundamental = cosf(2.f * M_PI_F * fundamental / _sample_freq);
+	float cos_prev = 1.f;
+	float cos_harmonic = cos_fundamental;
+
+	for (int harmonic = 1; harmonic <= 5; harmonic++) {
+		const float frequency = fundamental * harmonic;
+
+		NotchFilter<float> notch_reference;
+		notch_reference.setParameters(_sample_freq, frequency, _bandwidth);
+
+		NotchFilter<float> notch;
+		notch.setParameters(_sample_freq, _notch_freq, _bandwidth);
+
+		// WHEN: only the notch frequency is updated
+		EXPECT_TRUE(notch.setNotchFreq(frequency, cos_harmonic));
+
+		// THEN: the coefficients match a full update
+		float a_ref[3];
+		float b_ref[3];
+		float a[3];
+		float b[3];
+		notch_reference.getCoefficients(a_ref, b_ref);
+		notch.getCoefficients(a, b);
+
+		EXPECT_FLOAT_EQ(notch.getNotchFreq(), frequency);
+
+		for (int i = 0; i < 3; i++) {
+			EXPECT_NEAR(a[i], a_ref[i], 1e-5f);
+			EXPECT_NEAR(b[i], b_ref[i], 1e-5f);
+		}
+
+		// cos((k + 1) w) = 2 cos(w) cos(k w) - cos((k - 1) w)
+		const float cos_next = 2.f * cos_fundamental * cos_harmonic - cos_prev;
+		cos_prev = cos_harmonic;
+		cos_harmonic = cos_next;
+	}
+
+	// an unconfigured filter or a frequency above Nyquist is rejected
+	EXPECT_FALSE(_notch_float.setNotchFreq(_notch_freq, 0.f));
+	_notch_float.setParameters(_sample_freq, _notch_freq, _bandwidth);
+	EXPECT_FALSE(_notch_float.setNotchFreq(_sample_freq, 1.f));
+	EXPECT_FLOAT_EQ(_notch_float.getNotchFreq(), 0.f);
+}
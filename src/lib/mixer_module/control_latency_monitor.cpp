@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "control_latency_monitor.hpp"
+
+#include <math.h>
+
+void ControlLatencyMonitor::update(hrt_abstime timestamp_sample, hrt_abstime timestamp_output)
+{
+	if (timestamp_sample == 0 || timestamp_sample <= _last_timestamp_sample || timestamp_output < timestamp_sample) {
+		// no new sample (eg. output on a backup schedule)
+		return;
+	}
+
+	updateCycleInterval(timestamp_sample);
+
+	const hrt_abstime latency = timestamp_output - timestamp_sample;
+	const uint32_t latency_us = (latency < UINT32_MAX) ? (uint32_t)latency : UINT32_MAX;
+
+	const uint32_t bucket = latency_us / BUCKET_WIDTH_US;
+	uint16_t &count = _histogram[(bucket < BUCKETS) ? bucket : (BUCKETS - 1)];
+
+	if (count < UINT16_MAX) {
+		count++;
+	}
+
+	_samples++;
+
+	if (latency_us > _latency_max) {
+		_latency_max = latency_us;
+	}
+
+	if (_cycle_interval > 0 && latency_us > _cycle_interval) {
+		_deadline_misses++;
+	}
+}
+
+void ControlLatencyMonitor::updateCycleInterval(hrt_abstime timestamp_sample)
+{
+	if (_last_timestamp_sample != 0) {
+		const float interval = timestamp_sample - _last_timestamp_sample;
+
+		if (_cycle_interval == 0) {
+			_cycle_interval = interval;
+
+		} else if (interval > 1.5f * _cycle_interval) {
+			// samples in between never made it to the output
+			_missed_cycles += lroundf(interval / _cycle_interval) - 1;
+
+		} else {
+			// slow low-pass, gaps are excluded so they don't inflate the deadline
+			_cycle_interval = lroundf(0.95f * _cycle_interval + 0.05f * interval);
+		}
+	}
+
+	_last_timestamp_sample = timestamp_sample;
+}
+
+uint32_t ControlLatencyMonitor::percentile(float p) const
+{
+	if (_samples == 0) {
+		return 0;
+	}
+
+	const uint32_t target = ceilf(p * _samples);
+	uint32_t cumulative = 0;
+
+	for (int i = 0; i < BUCKETS - 1; i++) {
+		cumulative += _histogram[i];
+
+		if (cumulative >= target) {
+			// upper bucket edge, but never above the actual maximum
+			const uint32_t upper = (i + 1) * BUCKET_WIDTH_US;
+			return (upper < _latency_max) ? upper : _latency_max;
+		}
+	}
+
+	return _latency_max;
+}
+
+void ControlLatencyMonitor::getStatus(control_latency_s &status)
+{
+	status.samples = _samples;
+	status.latency_p50 = percentile(0.5f);
+	status.latency_p90 = percentile(0.9f);
+	status.latency_p99 = percentile(0.99f);
+	status.latency_max = _latency_max;
+	status.cycle_interval = _cycle_interval;
+	status.deadline_misses = _deadline_misses;
+	status.missed_cycles = _missed_cycles;
+
+	// new window
+	for (auto &count : _histogram) {
+		count = 0;
+	}
+
+	_samples = 0;
+	_latency_max = 0;
+}
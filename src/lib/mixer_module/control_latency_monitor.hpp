@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <uORB/topics/control_latency.h>
+
+/**
+ * Tracks the latency from a gyro sample to the corresponding actuator output.
+ *
+ * Latencies are binned into a linear histogram over a publication window to get
+ * percentiles. The sample interval is estimated from the sample timestamps and
+ * used as deadline: an output later than one interval after its sample means the
+ * control chain is falling behind, a gap between samples means cycles were skipped.
+ */
+class ControlLatencyMonitor
+{
+public:
+	static constexpr uint32_t BUCKET_WIDTH_US = 20;
+	static constexpr int BUCKETS = 128; ///< the last bucket collects everything above
+
+	/**
+	 * Record an output.
+	 * @param timestamp_sample sample the output is based on, repeated outputs of the same sample are ignored
+	 * @param timestamp_output time the output was written
+	 */
+	void update(hrt_abstime timestamp_sample, hrt_abstime timestamp_output);
+
+	/**
+	 * Fill in the statistics of the current window and start a new one.
+	 */
+	void getStatus(control_latency_s &status);
+
+	/**
+	 * Latency in us that p (0, 1] of the outputs of the current window did not exceed.
+	 */
+	uint32_t percentile(float p) const;
+
+	uint32_t cycleInterval() const { return _cycle_interval; }
+	uint32_t deadlineMisses() const { return _deadline_misses; }
+	uint32_t missedCycles() const { return _missed_cycles; }
+
+private:
+	void updateCycleInterval(hrt_abstime timestamp_sample);
+
+	uint16_t _histogram[BUCKETS] {};
+	uint32_t _samples{0};
+	uint32_t _latency_max{0};
+
+	hrt_abstime _last_timestamp_sample{0};
+	uint32_t _cycle_interval{0}; ///< 0 until estimated
+
+	uint32_t _deadline_misses{0};
+	uint32_t _missed_cycles{0};
+};
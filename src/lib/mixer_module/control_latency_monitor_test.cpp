@@ -0,0 +1,131 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "control_latency_monitor.hpp"
+
+static constexpr hrt_abstime INTERVAL = 2500; // 400 Hz
+
+TEST(ControlLatencyMonitorTest, Empty)
+{
+	ControlLatencyMonitor monitor;
+	control_latency_s status{};
+	monitor.getStatus(status);
+
+	EXPECT_EQ(status.samples, 0u);
+	EXPECT_EQ(status.latency_p50, 0u);
+	EXPECT_EQ(status.latency_max, 0u);
+	EXPECT_EQ(status.cycle_interval, 0u);
+	EXPECT_EQ(status.deadline_misses, 0u);
+	EXPECT_EQ(status.missed_cycles, 0u);
+}
+
+TEST(ControlLatencyMonitorTest, Percentiles)
+{
+	ControlLatencyMonitor monitor;
+
+	// 100 cycles with latencies 100, 110, ..., 1090 us
+	for (int i = 0; i < 100; i++) {
+		const hrt_abstime timestamp_sample = 1000000 + i * INTERVAL;
+		monitor.update(timestamp_sample, timestamp_sample + 100 + i * 10);
+	}
+
+	control_latency_s status{};
+	monitor.getStatus(status);
+
+	EXPECT_EQ(status.samples, 100u);
+	EXPECT_EQ(status.cycle_interval, INTERVAL);
+	EXPECT_EQ(status.latency_max, 1090u);
+
+	// resolution is one bucket
+	EXPECT_NEAR(status.latency_p50, 590, ControlLatencyMonitor::BUCKET_WIDTH_US);
+	EXPECT_NEAR(status.latency_p90, 990, ControlLatencyMonitor::BUCKET_WIDTH_US);
+	EXPECT_NEAR(status.latency_p99, 1080, ControlLatencyMonitor::BUCKET_WIDTH_US);
+	EXPECT_LE(status.latency_p99, status.latency_max);
+	EXPECT_EQ(status.deadline_misses, 0u);
+
+	// the next window starts empty
+	monitor.getStatus(status);
+	EXPECT_EQ(status.samples, 0u);
+	EXPECT_EQ(status.latency_max, 0u);
+}
+
+TEST(ControlLatencyMonitorTest, RepeatedSampleIgnored)
+{
+	ControlLatencyMonitor monitor;
+
+	monitor.update(1000000, 1000300);
+	monitor.update(1000000, 1050000); // backup schedule output, same sample
+
+	control_latency_s status{};
+	monitor.getStatus(status);
+	EXPECT_EQ(status.samples, 1u);
+	EXPECT_EQ(status.latency_max, 300u);
+}
+
+TEST(ControlLatencyMonitorTest, DeadlineMisses)
+{
+	ControlLatencyMonitor monitor;
+	hrt_abstime timestamp_sample = 1000000;
+
+	for (int i = 0; i < 50; i++) {
+		// every 10th output is later than one cycle
+		const hrt_abstime latency = (i % 10 == 9) ? INTERVAL + 500 : 400;
+		monitor.update(timestamp_sample, timestamp_sample + latency);
+		timestamp_sample += INTERVAL;
+	}
+
+	EXPECT_EQ(monitor.deadlineMisses(), 5u);
+	EXPECT_EQ(monitor.missedCycles(), 0u);
+}
+
+TEST(ControlLatencyMonitorTest, MissedCycles)
+{
+	ControlLatencyMonitor monitor;
+	hrt_abstime timestamp_sample = 1000000;
+
+	for (int i = 0; i < 20; i++) {
+		monitor.update(timestamp_sample, timestamp_sample + 400);
+		timestamp_sample += INTERVAL;
+	}
+
+	// 3 samples never reach the output
+	timestamp_sample += 3 * INTERVAL;
+	monitor.update(timestamp_sample, timestamp_sample + 400);
+
+	EXPECT_EQ(monitor.missedCycles(), 3u);
+
+	// the gap doesn't change the deadline
+	EXPECT_EQ(monitor.cycleInterval(), INTERVAL);
+}
@@ -133,6 +133,14 @@ void MixingOutput::printStatus() const
 	PX4_INFO("Param prefix: %s", _param_prefix);
 	perf_print_counter(_control_latency_perf);
 
+	if (_control_latency_monitor.cycleInterval() > 0) {
+		PX4_INFO("control cycle: %" PRIu32 " us, p50 latency: %" PRIu32 " us, p99 latency: %" PRIu32
+			 " us, deadline misses: %" PRIu32 ", missed cycles: %" PRIu32,
+			 _control_latency_monitor.cycleInterval(), _control_latency_monitor.percentile(0.5f),
+			 _control_latency_monitor.percentile(0.99f), _control_latency_monitor.deadlineMisses(),
+			 _control_latency_monitor.missedCycles());
+	}
+
 	if (_wq_switched) {
 		PX4_INFO("Switched to rate_ctrl work queue");
 	}
@@ -679,6 +687,15 @@ MixingOutput::updateLatencyPerfCounter(const actuator_outputs_s &actuator_output
 
 		if (_function_allocated[0]->getLatestSampleTimestamp(timestamp_sample)) {
 			perf_set_elapsed(_control_latency_perf, actuator_outputs.timestamp - timestamp_sample);
+			_control_latency_monitor.update(timestamp_sample, actuator_outputs.timestamp);
+
+			if (actuator_outputs.timestamp >= _control_latency_last_publish + 1_s) {
+				control_latency_s control_latency{};
+				_control_latency_monitor.getStatus(control_latency);
+				control_latency.timestamp = hrt_absolute_time();
+				_control_latency_pub.publish(control_latency);
+				_control_latency_last_publish = actuator_outputs.timestamp;
+			}
 		}
 	}
 }
@@ -34,6 +34,7 @@
 #pragma once
 
 #include "actuator_test.hpp"
+#include "control_latency_monitor.hpp"
 
 #include "functions/FunctionActuatorSet.hpp"
 #include "functions/FunctionConstantMax.hpp"
@@ -277,6 +278,10 @@ private:
 
 	perf_counter_t _control_latency_perf;
 
+	ControlLatencyMonitor _control_latency_monitor;
+	hrt_abstime _control_latency_last_publish{0};
+	uORB::PublicationMulti<control_latency_s> _control_latency_pub{ORB_ID(control_latency)};
+
 	FunctionProviderBase *_function_allocated[MAX_ACTUATORS] {}; ///< unique allocated functions
 	FunctionProviderBase *_functions[MAX_ACTUATORS] {}; ///< currently assigned functions
 	OutputFunction _function_assignment[MAX_ACTUATORS] {};
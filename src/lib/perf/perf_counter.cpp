@@ -44,6 +44,7 @@
 #include <drivers/drv_hrt.h>
 #include <math.h>
 #include <pthread.h>
+#include <px4_platform_common/atomic.h>
 #include <systemlib/err.h>
 
 #include "perf_counter.h"
@@ -52,9 +53,12 @@
  * Header common to all counters.
  */
 struct perf_ctr_header {
-	sq_entry_t		link;	/**< list linkage */
-	enum perf_counter_type	type;	/**< counter type */
-	const char		*name;	/**< counter name */
+	perf_ctr_header		*next{nullptr};	/**< registry linkage */
+	enum perf_counter_type	type;		/**< counter type */
+	const char		*name;		/**< counter name */
+	bool			shared{false};	/**< from perf_alloc_once, never deleted */
+	bool			reset_requested{false}; /**< perf_reset_all() of an owned counter, applied by its owner */
+	px4::atomic_bool	registered{false}; /**< in the registry (not freed) */
 };
 
 /**
@@ -68,6 +72,7 @@ struct perf_ctr_count : public perf_ctr_header {
  * PC_ELAPSED counter.
  */
 struct perf_ctr_elapsed : public perf_ctr_header {
+	uint32_t		seq{0};		/**< odd while an update is in progress */
 	uint64_t		event_count{0};
 	uint64_t		time_start{0};
 	uint64_t		time_total{0};
@@ -77,10 +82,18 @@ struct perf_ctr_elapsed : public perf_ctr_header {
 	float			M2{0.0f};
 };
 
+/**
+ * PC_HISTOGRAM counter.
+ */
+struct perf_ctr_histogram : public perf_ctr_elapsed {
+	uint32_t		buckets[PERF_HISTOGRAM_BUCKETS] {};
+};
+
 /**
  * PC_INTERVAL counter.
  */
 struct perf_ctr_interval : public perf_ctr_header {
+	uint32_t		seq{0};		/**< odd while an update is in progress */
 	uint64_t		event_count{0};
 	uint64_t		time_event{0};
 	uint64_t		time_first{0};
@@ -92,24 +105,211 @@ struct perf_ctr_interval : public perf_ctr_header {
 };
 
 /**
- * List of all known counters.
+ * List of all registered counters, most recent first.
+ *
+ * perf_alloc() pushes lock-free. Removal and traversal are serialized by
+ * perf_counters_mutex, they only have to cope with concurrent pushes to the head.
+ */
+static px4::atomic<perf_counter_t> perf_counters{nullptr};
+
+/**
+ * Hash table of the shared counters (perf_alloc_once) for lookup by name.
+ *
+ * Entries are only ever added (under perf_counters_mutex) and never removed, so the
+ * lookup does not need the lock. A freed shared counter stays in the table and is
+ * registered again by the next perf_alloc_once() with its name.
  */
-static sq_queue_t	perf_counters = { nullptr, nullptr };
+struct perf_shared_entry {
+	perf_shared_entry	*next;
+	perf_counter_t		handle;
+};
+
+static constexpr unsigned PERF_SHARED_BUCKETS = 16;
+static px4::atomic<perf_shared_entry *> perf_shared_counters[PERF_SHARED_BUCKETS] {};
 
 /**
- * mutex protecting access to the perf_counters linked list (which is read from & written to by different threads)
+ * mutex protecting changes to the registry other than the lock-free insertion,
+ * and the traversal of it.
  */
 pthread_mutex_t perf_counters_mutex = PTHREAD_MUTEX_INITIALIZER;
-// FIXME: the mutex does **not** protect against access to/from the perf
-// counter's data. It can still happen that a counter is updated while it is
-// printed. This can lead to inconsistent output, or completely bogus values
-// (especially the 64bit values which are in general not atomically updated).
-// The same holds for shared perf counters (perf_alloc_once), that can be updated
-// concurrently (this affects the 'ctrl_latency' counter).
 
+// Counter updates don't take the mutex. A counter from perf_alloc() is owned by one
+// module and only written from the thread updating it (including perf_reset()), so it
+// only needs to be readable at any time (perf command, logger) and is updated with
+// plain stores. perf_reset_all() from another thread only flags an owned counter, the
+// owner applies the reset with its next update.
+// Shared counters (perf_alloc_once) can be updated from several threads:
+// - PC_COUNT is incremented atomically (relaxed, it's a pure statistic).
+// - PC_ELAPSED, PC_HISTOGRAM and PC_INTERVAL are multi-field, they are guarded by a
+//   sequence counter. A writer of a shared counter claims it with a compare-and-swap
+//   and drops its sample if another writer is in the middle of an update, so a writer
+//   never waits. Readers retry until they get a consistent copy.
+
+static inline void count_add(uint64_t &value, uint64_t num, bool shared)
+{
+	if (!shared) {
+		// single writer: plain increment (a relaxed load and store where that's free)
+		if (__atomic_always_lock_free(sizeof(value), 0)) {
+			__atomic_store_n(&value, __atomic_load_n(&value, __ATOMIC_RELAXED) + num, __ATOMIC_RELAXED);
 
-perf_counter_t
-perf_alloc(enum perf_counter_type type, const char *name)
+		} else {
+			value += num;
+		}
+
+		return;
+	}
+
+#if defined(__PX4_NUTTX)
+
+	if (!__atomic_always_lock_free(sizeof(value), 0)) {
+		irqstate_t flags = enter_critical_section();
+		value += num;
+		leave_critical_section(flags);
+		return;
+	}
+
+#endif // __PX4_NUTTX
+
+	__atomic_fetch_add(&value, num, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t count_load(const uint64_t &value)
+{
+#if defined(__PX4_NUTTX)
+
+	if (!__atomic_always_lock_free(sizeof(value), 0)) {
+		irqstate_t flags = enter_critical_section();
+		uint64_t ret = value;
+		leave_critical_section(flags);
+		return ret;
+	}
+
+#endif // __PX4_NUTTX
+
+	return __atomic_load_n(&value, __ATOMIC_RELAXED);
+}
+
+static inline void count_store(uint64_t &value, uint64_t num)
+{
+#if defined(__PX4_NUTTX)
+
+	if (!__atomic_always_lock_free(sizeof(value), 0)) {
+		irqstate_t flags = enter_critical_section();
+		value = num;
+		leave_critical_section(flags);
+		return;
+	}
+
+#endif // __PX4_NUTTX
+
+	__atomic_store_n(&value, num, __ATOMIC_RELAXED);
+}
+
+/**
+ * Start an update of a sequence guarded counter.
+ * @param claim true if other writers are possible (shared counter, reset)
+ * @return false if another update is in progress, the caller must skip its update
+ */
+static inline bool seq_write_begin(uint32_t &seq, uint32_t &seq_value, bool claim)
+{
+	seq_value = __atomic_load_n(&seq, __ATOMIC_RELAXED);
+
+	if (claim) {
+		if ((seq_value & 1) || !__atomic_compare_exchange_n(&seq, &seq_value, seq_value + 1, false,
+				__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return false;
+		}
+
+	} else {
+		__atomic_store_n(&seq, seq_value + 1, __ATOMIC_RELAXED);
+	}
+
+	// the odd sequence has to be visible before any of the data changes
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	return true;
+}
+
+static inline void seq_write_end(uint32_t &seq, uint32_t seq_value)
+{
+	__atomic_store_n(&seq, seq_value + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copy a sequence guarded counter, retrying while it's being updated.
+ */
+template<typename T>
+static void seq_read(const T *src, T &dst)
+{
+	for (int i = 0; i < 10; i++) {
+		const uint32_t seq_before = __atomic_load_n(&src->seq, __ATOMIC_ACQUIRE);
+		memcpy((void *)&dst, (const void *)src, sizeof(T));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		if (((seq_before & 1) == 0) && (__atomic_load_n(&src->seq, __ATOMIC_RELAXED) == seq_before)) {
+			return;
+		}
+	}
+
+	// the counter is being updated continuously, use the last (possibly inconsistent) copy
+}
+
+/**
+ * Apply a reset requested by perf_reset_all() in the context of the owner, before its update.
+ */
+static inline void perf_reset_pending(perf_counter_t handle)
+{
+	if (__atomic_load_n(&handle->reset_requested, __ATOMIC_RELAXED)) {
+		__atomic_store_n(&handle->reset_requested, false, __ATOMIC_RELAXED);
+		perf_reset(handle);
+	}
+}
+
+static inline uint32_t
+perf_name_hash(const char *name)
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+
+	while (*name) {
+		hash = (hash ^ (uint8_t) * name++) * 16777619u;
+	}
+
+	return hash;
+}
+
+static void
+perf_register(perf_counter_t ctr)
+{
+	ctr->registered.store(true);
+
+	perf_counter_t head = perf_counters.load();
+
+	do {
+		ctr->next = head;
+	} while (!perf_counters.compare_exchange(&head, ctr));
+}
+
+/** Remove from the registry, must hold perf_counters_mutex */
+static void
+perf_unregister(perf_counter_t ctr)
+{
+	perf_counter_t expected = ctr;
+
+	if (!perf_counters.compare_exchange(&expected, ctr->next)) {
+		// not the head (anymore), concurrent insertions only change the head
+		for (perf_counter_t prev = perf_counters.load(); prev != nullptr; prev = prev->next) {
+			if (prev->next == ctr) {
+				prev->next = ctr->next;
+				break;
+			}
+		}
+	}
+
+	ctr->registered.store(false);
+}
+
+static perf_counter_t
+perf_new(enum perf_counter_type type, const char *name)
 {
 	perf_counter_t ctr = nullptr;
 
@@ -122,6 +322,10 @@ perf_alloc(enum perf_counter_type type, const char *name)
 		ctr = new perf_ctr_elapsed();
 		break;
 
+	case PC_HISTOGRAM:
+		ctr = new perf_ctr_histogram();
+		break;
+
 	case PC_INTERVAL:
 		ctr = new perf_ctr_interval();
 		break;
@@ -133,41 +337,84 @@ perf_alloc(enum perf_counter_type type, const char *name)
 	if (ctr != nullptr) {
 		ctr->type = type;
 		ctr->name = name;
-		pthread_mutex_lock(&perf_counters_mutex);
-		sq_addfirst(&ctr->link, &perf_counters);
-		pthread_mutex_unlock(&perf_counters_mutex);
 	}
 
 	return ctr;
 }
 
+perf_counter_t
+perf_alloc(enum perf_counter_type type, const char *name)
+{
+	perf_counter_t ctr = perf_new(type, name);
+
+	if (ctr != nullptr) {
+		perf_register(ctr);
+	}
+
+	return ctr;
+}
+
+static perf_counter_t
+perf_find_shared(unsigned bucket, const char *name)
+{
+	for (perf_shared_entry *entry = perf_shared_counters[bucket].load(); entry != nullptr; entry = entry->next) {
+		if (!strcmp(entry->handle->name, name)) {
+			return entry->handle;
+		}
+	}
+
+	return nullptr;
+}
+
 perf_counter_t
 perf_alloc_once(enum perf_counter_type type, const char *name)
 {
+	const unsigned bucket = perf_name_hash(name) % PERF_SHARED_BUCKETS;
+
+	// fast path: existing and registered, without the lock
+	perf_counter_t handle = perf_find_shared(bucket, name);
+
+	if ((handle != nullptr) && handle->registered.load()) {
+		/* same name but different type, assuming this is an error and not intended */
+		return (handle->type == type) ? handle : nullptr;
+	}
+
 	pthread_mutex_lock(&perf_counters_mutex);
-	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
 
-	while (handle != nullptr) {
-		if (!strcmp(handle->name, name)) {
-			if (type == handle->type) {
-				/* they are the same counter */
-				pthread_mutex_unlock(&perf_counters_mutex);
-				return handle;
+	// look again, another thread might have been faster
+	handle = perf_find_shared(bucket, name);
 
-			} else {
-				/* same name but different type, assuming this is an error and not intended */
-				pthread_mutex_unlock(&perf_counters_mutex);
-				return nullptr;
-			}
+	if (handle != nullptr) {
+		if (handle->type != type) {
+			handle = nullptr;
+
+		} else if (!handle->registered.load()) {
+			// freed before, reuse it
+			perf_reset(handle);
+			perf_register(handle);
 		}
 
-		handle = (perf_counter_t)sq_next(&handle->link);
+	} else {
+		handle = perf_new(type, name);
+		perf_shared_entry *entry = (handle != nullptr) ? new perf_shared_entry{nullptr, handle} : nullptr;
+
+		if (entry != nullptr) {
+			handle->shared = true;
+			perf_register(handle);
+
+			// only inserted under the lock, lock-free readers see the complete entry
+			entry->next = perf_shared_counters[bucket].load();
+			perf_shared_counters[bucket].store(entry);
+
+		} else {
+			delete handle;
+			handle = nullptr;
+		}
 	}
 
 	pthread_mutex_unlock(&perf_counters_mutex);
 
-	/* if the execution reaches here, no existing counter of that name was found */
-	return perf_alloc(type, name);
+	return handle;
 }
 
 void
@@ -178,10 +425,16 @@ perf_free(perf_counter_t handle)
 	}
 
 	pthread_mutex_lock(&perf_counters_mutex);
-	sq_rem(&handle->link, &perf_counters);
+
+	if (handle->registered.load()) {
+		perf_unregister(handle);
+	}
+
 	pthread_mutex_unlock(&perf_counters_mutex);
 
-	delete handle;
+	if (!handle->shared) {
+		delete handle;
+	}
 }
 
 void
@@ -191,9 +444,11 @@ perf_count(perf_counter_t handle)
 		return;
 	}
 
+	perf_reset_pending(handle);
+
 	switch (handle->type) {
 	case PC_COUNT:
-		((struct perf_ctr_count *)handle)->event_count++;
+		count_add(((struct perf_ctr_count *)handle)->event_count, 1, handle->shared);
 		break;
 
 	case PC_INTERVAL:
@@ -214,6 +469,7 @@ perf_begin(perf_counter_t handle)
 
 	switch (handle->type) {
 	case PC_ELAPSED:
+	case PC_HISTOGRAM:
 		((struct perf_ctr_elapsed *)handle)->time_start = hrt_absolute_time();
 		break;
 
@@ -230,7 +486,8 @@ perf_end(perf_counter_t handle)
 	}
 
 	switch (handle->type) {
-	case PC_ELAPSED: {
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
 			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
 
 			if (pce->time_start != 0) {
@@ -244,6 +501,18 @@ perf_end(perf_counter_t handle)
 	}
 }
 
+static inline unsigned
+perf_histogram_bucket(uint32_t elapsed)
+{
+	if (elapsed < 2) {
+		return 0;
+	}
+
+	// index of the highest set bit
+	const unsigned bucket = 31 - __builtin_clz(elapsed);
+	return (bucket < PERF_HISTOGRAM_BUCKETS) ? bucket : (PERF_HISTOGRAM_BUCKETS - 1);
+}
+
 void
 perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 {
@@ -251,11 +520,15 @@ perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 		return;
 	}
 
+	perf_reset_pending(handle);
+
 	switch (handle->type) {
-	case PC_ELAPSED: {
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
 			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+			uint32_t seq;
 
-			if (elapsed >= 0) {
+			if (elapsed >= 0 && seq_write_begin(pce->seq, seq, handle->shared)) {
 				pce->event_count++;
 				pce->time_total += elapsed;
 
@@ -274,7 +547,13 @@ perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 				pce->mean += delta_intvl / pce->event_count;
 				pce->M2 += delta_intvl * (dt - pce->mean);
 
+				if (handle->type == PC_HISTOGRAM) {
+					((struct perf_ctr_histogram *)handle)->buckets[perf_histogram_bucket(elapsed)]++;
+				}
+
 				pce->time_start = 0;
+
+				seq_write_end(pce->seq, seq);
 			}
 		}
 		break;
@@ -291,9 +570,16 @@ perf_count_interval(perf_counter_t handle, hrt_abstime now)
 		return;
 	}
 
+	perf_reset_pending(handle);
+
 	switch (handle->type) {
 	case PC_INTERVAL: {
 			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
+			uint32_t seq;
+
+			if (!seq_write_begin(pci->seq, seq, handle->shared)) {
+				break;
+			}
 
 			switch (pci->event_count) {
 			case 0:
@@ -330,6 +616,8 @@ perf_count_interval(perf_counter_t handle, hrt_abstime now)
 
 			pci->time_last = now;
 			pci->event_count++;
+
+			seq_write_end(pci->seq, seq);
 			break;
 		}
 
@@ -345,9 +633,11 @@ perf_set_count(perf_counter_t handle, uint64_t count)
 		return;
 	}
 
+	perf_reset_pending(handle);
+
 	switch (handle->type) {
 	case PC_COUNT: {
-			((struct perf_ctr_count *)handle)->event_count = count;
+			count_store(((struct perf_ctr_count *)handle)->event_count, count);
 		}
 		break;
 
@@ -365,7 +655,8 @@ perf_cancel(perf_counter_t handle)
 	}
 
 	switch (handle->type) {
-	case PC_ELAPSED: {
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
 			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
 
 			pce->time_start = 0;
@@ -386,27 +677,46 @@ perf_reset(perf_counter_t handle)
 
 	switch (handle->type) {
 	case PC_COUNT:
-		((struct perf_ctr_count *)handle)->event_count = 0;
+		count_store(((struct perf_ctr_count *)handle)->event_count, 0);
 		break;
 
-	case PC_ELAPSED: {
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
 			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
-			pce->event_count = 0;
-			pce->time_start = 0;
-			pce->time_total = 0;
-			pce->time_least = 0;
-			pce->time_most = 0;
+			uint32_t seq;
+
+			// shared: don't wait for a concurrent update, the reset would lose against it anyway
+			if (seq_write_begin(pce->seq, seq, handle->shared)) {
+				pce->event_count = 0;
+				pce->time_start = 0;
+				pce->time_total = 0;
+				pce->time_least = 0;
+				pce->time_most = 0;
+
+				if (handle->type == PC_HISTOGRAM) {
+					memset(((struct perf_ctr_histogram *)handle)->buckets, 0, sizeof(perf_ctr_histogram::buckets));
+				}
+
+				seq_write_end(pce->seq, seq);
+			}
+
 			break;
 		}
 
 	case PC_INTERVAL: {
 			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
-			pci->event_count = 0;
-			pci->time_event = 0;
-			pci->time_first = 0;
-			pci->time_last = 0;
-			pci->time_least = 0;
-			pci->time_most = 0;
+			uint32_t seq;
+
+			if (seq_write_begin(pci->seq, seq, handle->shared)) {
+				pci->event_count = 0;
+				pci->time_event = 0;
+				pci->time_first = 0;
+				pci->time_last = 0;
+				pci->time_least = 0;
+				pci->time_most = 0;
+				seq_write_end(pci->seq, seq);
+			}
+
 			break;
 		}
 	}
@@ -433,11 +743,21 @@ perf_print_counter_fd(int fd, perf_counter_t handle)
 	case PC_COUNT:
 		dprintf(fd, "%s: %" PRIu64 " events\n",
 			handle->name,
-			((struct perf_ctr_count *)handle)->event_count);
+			count_load(((struct perf_ctr_count *)handle)->event_count));
 		break;
 
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_histogram pch;
+
+			if (handle->type == PC_HISTOGRAM) {
+				seq_read((struct perf_ctr_histogram *)handle, pch);
+
+			} else {
+				seq_read((struct perf_ctr_elapsed *)handle, (struct perf_ctr_elapsed &)pch);
+			}
+
+			struct perf_ctr_elapsed *pce = &pch;
 			float rms = sqrtf(pce->M2 / (pce->event_count - 1));
 			dprintf(fd, "%s: %" PRIu64 " events, %" PRIu64 "us elapsed, %.2fus avg, min %" PRIu32 "us max %" PRIu32
 				"us %5.3fus rms\n",
@@ -448,11 +768,32 @@ perf_print_counter_fd(int fd, perf_counter_t handle)
 				pce->time_least,
 				pce->time_most,
 				(double)(1e6f * rms));
+
+			if (handle->type == PC_HISTOGRAM) {
+				// only the populated buckets, labeled with their upper bound
+				dprintf(fd, "    histogram [us]:");
+
+				for (unsigned i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+					if (pch.buckets[i] != 0) {
+						if (i < PERF_HISTOGRAM_BUCKETS - 1) {
+							dprintf(fd, " <%" PRIu32 ": %" PRIu32, (uint32_t)2 << i, pch.buckets[i]);
+
+						} else {
+							dprintf(fd, " >=%" PRIu32 ": %" PRIu32, (uint32_t)1 << i, pch.buckets[i]);
+						}
+					}
+				}
+
+				dprintf(fd, "\n");
+			}
+
 			break;
 		}
 
 	case PC_INTERVAL: {
-			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
+			struct perf_ctr_interval pci_copy;
+			seq_read((struct perf_ctr_interval *)handle, pci_copy);
+			struct perf_ctr_interval *pci = &pci_copy;
 			float rms = sqrtf(pci->M2 / (pci->event_count - 1));
 
 			dprintf(fd, "%s: %" PRIu64 " events, %.2fus avg, min %" PRIu32 "us max %" PRIu32 "us %5.3fus rms\n",
@@ -484,11 +825,14 @@ perf_print_counter_buffer(char *buffer, int length, perf_counter_t handle)
 	case PC_COUNT:
 		num_written = snprintf(buffer, length, "%s: %" PRIu64 " events",
 				       handle->name,
-				       ((struct perf_ctr_count *)handle)->event_count);
+				       count_load(((struct perf_ctr_count *)handle)->event_count));
 		break;
 
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed pce_copy;
+			seq_read((struct perf_ctr_elapsed *)handle, pce_copy);
+			struct perf_ctr_elapsed *pce = &pce_copy;
 			float rms = sqrtf(pce->M2 / (pce->event_count - 1));
 			num_written = snprintf(buffer, length,
 					       "%s: %" PRIu64 " events, %" PRIu64 "us elapsed, %.2fus avg, min %" PRIu32 "us max %" PRIu32 "us %5.3fus rms",
@@ -503,7 +847,9 @@ perf_print_counter_buffer(char *buffer, int length, perf_counter_t handle)
 		}
 
 	case PC_INTERVAL: {
-			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
+			struct perf_ctr_interval pci_copy;
+			seq_read((struct perf_ctr_interval *)handle, pci_copy);
+			struct perf_ctr_interval *pci = &pci_copy;
 			float rms = sqrtf(pci->M2 / (pci->event_count - 1));
 
 			num_written = snprintf(buffer, length,
@@ -534,16 +880,19 @@ perf_event_count(perf_counter_t handle)
 
 	switch (handle->type) {
 	case PC_COUNT:
-		return ((struct perf_ctr_count *)handle)->event_count;
+		return count_load(((struct perf_ctr_count *)handle)->event_count);
 
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
-			return pce->event_count;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed pce;
+			seq_read((struct perf_ctr_elapsed *)handle, pce);
+			return pce.event_count;
 		}
 
 	case PC_INTERVAL: {
-			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
-			return pci->event_count;
+			struct perf_ctr_interval pci;
+			seq_read((struct perf_ctr_interval *)handle, pci);
+			return pci.event_count;
 		}
 
 	default:
@@ -561,7 +910,8 @@ perf_mean(perf_counter_t handle)
 	}
 
 	switch (handle->type) {
-	case PC_ELAPSED: {
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
 			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
 			return pce->mean;
 		}
@@ -578,15 +928,71 @@ perf_mean(perf_counter_t handle)
 	return 0.0f;
 }
 
+void
+perf_snapshot(perf_counter_t handle, perf_counter_snapshot_t *snapshot)
+{
+	memset(snapshot, 0, sizeof(*snapshot));
+
+	if (handle == nullptr) {
+		return;
+	}
+
+	snapshot->name = handle->name;
+	snapshot->name_hash = perf_name_hash(handle->name);
+	snapshot->type = handle->type;
+
+	switch (handle->type) {
+	case PC_COUNT:
+		snapshot->event_count = count_load(((struct perf_ctr_count *)handle)->event_count);
+		break;
+
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed pce;
+			seq_read((struct perf_ctr_elapsed *)handle, pce);
+			snapshot->event_count = pce.event_count;
+			snapshot->time_total = pce.time_total;
+			snapshot->time_most = pce.time_most;
+			break;
+		}
+
+	case PC_INTERVAL: {
+			struct perf_ctr_interval pci;
+			seq_read((struct perf_ctr_interval *)handle, pci);
+			snapshot->event_count = pci.event_count;
+			snapshot->time_total = pci.time_last - pci.time_first;
+			snapshot->time_most = pci.time_most;
+			break;
+		}
+
+	default:
+		break;
+	}
+}
+
+int
+perf_histogram(perf_counter_t handle, uint32_t buckets[PERF_HISTOGRAM_BUCKETS])
+{
+	if (handle == nullptr || handle->type != PC_HISTOGRAM) {
+		return -1;
+	}
+
+	struct perf_ctr_histogram pch;
+	seq_read((struct perf_ctr_histogram *)handle, pch);
+	memcpy(buckets, pch.buckets, sizeof(pch.buckets));
+
+	return 0;
+}
+
 void
 perf_iterate_all(perf_callback cb, void *user)
 {
 	pthread_mutex_lock(&perf_counters_mutex);
-	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
+	perf_counter_t handle = perf_counters.load();
 
 	while (handle != nullptr) {
 		cb(handle, user);
-		handle = (perf_counter_t)sq_next(&handle->link);
+		handle = handle->next;
 	}
 
 	pthread_mutex_unlock(&perf_counters_mutex);
@@ -596,11 +1002,11 @@ void
 perf_print_all(int fd)
 {
 	pthread_mutex_lock(&perf_counters_mutex);
-	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
+	perf_counter_t handle = perf_counters.load();
 
 	while (handle != nullptr) {
 		perf_print_counter_fd(fd, handle);
-		handle = (perf_counter_t)sq_next(&handle->link);
+		handle = handle->next;
 	}
 
 	pthread_mutex_unlock(&perf_counters_mutex);
@@ -626,11 +1032,18 @@ void
 perf_reset_all(void)
 {
 	pthread_mutex_lock(&perf_counters_mutex);
-	perf_counter_t handle = (perf_counter_t)sq_peek(&perf_counters);
+	perf_counter_t handle = perf_counters.load();
 
 	while (handle != nullptr) {
-		perf_reset(handle);
-		handle = (perf_counter_t)sq_next(&handle->link);
+		if (handle->shared) {
+			perf_reset(handle);
+
+		} else {
+			// owned counters are only written by their owner, it applies the reset with its next update
+			__atomic_store_n(&handle->reset_requested, true, __ATOMIC_RELAXED);
+		}
+
+		handle = handle->next;
 	}
 
 	pthread_mutex_unlock(&perf_counters_mutex);
@@ -44,16 +44,40 @@
 
 /**
  * Counter types.
+ *
+ * Updates don't take a lock. A counter from perf_alloc() must only be updated by one thread
+ * at a time, shared counters from perf_alloc_once() can be updated concurrently (colliding
+ * PC_ELAPSED, PC_HISTOGRAM or PC_INTERVAL updates drop one of the samples).
+ * All counters can be read at any time.
  */
 enum perf_counter_type {
 	PC_COUNT,		/**< count the number of times an event occurs */
 	PC_ELAPSED,		/**< measure the time elapsed performing an event */
-	PC_INTERVAL		/**< measure the interval between instances of an event */
+	PC_INTERVAL,		/**< measure the interval between instances of an event */
+	PC_HISTOGRAM		/**< PC_ELAPSED, plus a log2 histogram of the elapsed times */
 };
 
+/**
+ * Number of PC_HISTOGRAM buckets. Bucket 0 counts elapsed times below 2us, bucket i
+ * [2^i, 2^(i+1)) us and the last one everything from 32768us.
+ */
+#define PERF_HISTOGRAM_BUCKETS 16
+
 struct perf_ctr_header;
 typedef struct perf_ctr_header	*perf_counter_t;
 
+/**
+ * Consistent copy of the main values of a counter.
+ */
+typedef struct {
+	const char		*name;
+	uint32_t		name_hash;	/**< 32 bit FNV-1a hash of the name */
+	enum perf_counter_type	type;
+	uint64_t		event_count;
+	uint64_t		time_total;	/**< PC_ELAPSED, PC_HISTOGRAM: total elapsed time, PC_INTERVAL: time from the first to the last event [us] */
+	uint32_t		time_most;	/**< longest elapsed time or interval [us] */
+} perf_counter_snapshot_t;
+
 __BEGIN_DECLS
 
 /**
@@ -71,6 +95,9 @@ __EXPORT extern perf_counter_t	perf_alloc(enum perf_counter_type type, const cha
 /**
  * Get the reference to an existing counter or create a new one if it does not exist.
  *
+ * The counter is shared by all callers using the same name and it is never deleted:
+ * perf_free() only removes it from the list of counters until it is requested again.
+ *
  * @param type			The type of the counter.
  * @param name			The counter name.
  * @return			Handle for the counter, or NULL if a counter
@@ -161,7 +188,8 @@ __EXPORT extern void		perf_cancel(perf_counter_t handle);
 /**
  * Reset a performance counter.
  *
- * This call resets performance counter to initial state
+ * This call resets performance counter to initial state. A counter from perf_alloc()
+ * must only be reset from the context updating it.
  *
  * @param handle		The handle returned from perf_alloc.
  */
@@ -223,6 +251,8 @@ __EXPORT extern void		perf_print_latency(int fd);
 
 /**
  * Reset all of the performance counters.
+ *
+ * Counters from perf_alloc() are reset by their owner with the next update.
  */
 __EXPORT extern void		perf_reset_all(void);
 
@@ -242,6 +272,23 @@ __EXPORT extern uint64_t	perf_event_count(perf_counter_t handle);
  */
 __EXPORT extern float		perf_mean(perf_counter_t handle);
 
+/**
+ * Get a consistent copy of the main counter values.
+ *
+ * @param handle		The handle returned from perf_alloc.
+ * @param snapshot		Filled with the counter values.
+ */
+__EXPORT extern void		perf_snapshot(perf_counter_t handle, perf_counter_snapshot_t *snapshot);
+
+/**
+ * Copy the histogram of a PC_HISTOGRAM counter.
+ *
+ * @param handle		The handle returned from perf_alloc.
+ * @param buckets		Filled with the event count of each bucket.
+ * @return			0 on success, -1 if handle is not a PC_HISTOGRAM counter
+ */
+__EXPORT extern int		perf_histogram(perf_counter_t handle, uint32_t buckets[PERF_HISTOGRAM_BUCKETS]);
+
 __END_DECLS
 
 #endif
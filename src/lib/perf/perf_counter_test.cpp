@@ -0,0 +1,298 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <px4_platform_common/atomic.h>
+#include <pthread.h>
+#include <string.h>
+
+#include "perf_counter.h"
+
+struct FindContext {
+	perf_counter_t handle;
+	int found;
+};
+
+static void find_callback(perf_counter_t handle, void *user)
+{
+	FindContext *context = (FindContext *)user;
+
+	if (handle == context->handle) {
+		context->found++;
+	}
+}
+
+static int registered(perf_counter_t handle)
+{
+	FindContext context{handle, 0};
+	perf_iterate_all(find_callback, &context);
+	return context.found;
+}
+
+TEST(PerfCounterTest, AllocFree)
+{
+	perf_counter_t a = perf_alloc(PC_COUNT, "test: a");
+	perf_counter_t b = perf_alloc(PC_ELAPSED, "test: b");
+	perf_counter_t c = perf_alloc(PC_INTERVAL, "test: c");
+
+	EXPECT_EQ(registered(a), 1);
+	EXPECT_EQ(registered(b), 1);
+	EXPECT_EQ(registered(c), 1);
+
+	// free from the middle, the head and the tail of the list
+	perf_free(b);
+	EXPECT_EQ(registered(a), 1);
+	EXPECT_EQ(registered(c), 1);
+
+	perf_free(c);
+	EXPECT_EQ(registered(a), 1);
+
+	perf_free(a);
+}
+
+TEST(PerfCounterTest, AllocOnce)
+{
+	perf_counter_t a = perf_alloc_once(PC_COUNT, "test: shared");
+	ASSERT_NE(a, nullptr);
+	EXPECT_EQ(perf_alloc_once(PC_COUNT, "test: shared"), a);
+	EXPECT_EQ(perf_alloc_once(PC_ELAPSED, "test: shared"), nullptr); // type mismatch
+	EXPECT_NE(perf_alloc_once(PC_COUNT, "test: shared2"), a);
+
+	perf_count(a);
+	perf_count(a);
+	EXPECT_EQ(perf_event_count(a), 2u);
+
+	// freed shared counters are kept and come back reset
+	perf_free(a);
+	EXPECT_EQ(registered(a), 0);
+	EXPECT_EQ(perf_alloc_once(PC_COUNT, "test: shared"), a);
+	EXPECT_EQ(registered(a), 1);
+	EXPECT_EQ(perf_event_count(a), 0u);
+
+	perf_free(a);
+	perf_free(perf_alloc_once(PC_COUNT, "test: shared2"));
+}
+
+TEST(PerfCounterTest, Elapsed)
+{
+	perf_counter_t a = perf_alloc(PC_ELAPSED, "test: elapsed");
+
+	perf_set_elapsed(a, 100);
+	perf_set_elapsed(a, 300);
+	perf_set_elapsed(a, -1); // ignored
+
+	EXPECT_EQ(perf_event_count(a), 2u);
+	EXPECT_NEAR(perf_mean(a), 200e-6f, 1e-9f);
+
+	perf_reset(a);
+	EXPECT_EQ(perf_event_count(a), 0u);
+
+	perf_free(a);
+}
+
+TEST(PerfCounterTest, Histogram)
+{
+	perf_counter_t a = perf_alloc(PC_HISTOGRAM, "test: histogram");
+
+	perf_set_elapsed(a, 0);
+	perf_set_elapsed(a, 1);
+	perf_set_elapsed(a, 2);
+	perf_set_elapsed(a, 3);
+	perf_set_elapsed(a, 1000); // [512, 1024)
+	perf_set_elapsed(a, 1000000);
+
+	uint32_t buckets[PERF_HISTOGRAM_BUCKETS];
+	ASSERT_EQ(perf_histogram(a, buckets), 0);
+	EXPECT_EQ(buckets[0], 2u);
+	EXPECT_EQ(buckets[1], 2u);
+	EXPECT_EQ(buckets[9], 1u);
+	EXPECT_EQ(buckets[PERF_HISTOGRAM_BUCKETS - 1], 1u);
+	EXPECT_EQ(perf_event_count(a), 6u);
+
+	char buffer[256];
+	perf_print_counter_buffer(buffer, sizeof(buffer), a);
+	EXPECT_NE(strstr(buffer, "6 events"), nullptr);
+
+	perf_reset(a);
+	ASSERT_EQ(perf_histogram(a, buckets), 0);
+
+	for (unsigned i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+		EXPECT_EQ(buckets[i], 0u);
+	}
+
+	// not a histogram
+	perf_counter_t b = perf_alloc(PC_ELAPSED, "test: no histogram");
+	EXPECT_EQ(perf_histogram(b, buckets), -1);
+
+	perf_free(b);
+	perf_free(a);
+}
+
+TEST(PerfCounterTest, ResetAll)
+{
+	perf_counter_t owned = perf_alloc(PC_COUNT, "test: reset owned");
+	perf_counter_t shared = perf_alloc_once(PC_COUNT, "test: reset shared");
+
+	for (int i = 0; i < 3; i++) {
+		perf_count(owned);
+		perf_count(shared);
+	}
+
+	perf_reset_all();
+
+	// shared counters are reset immediately
+	EXPECT_EQ(perf_event_count(shared), 0u);
+
+	// owned counters by their owner with the next update
+	EXPECT_EQ(perf_event_count(owned), 3u);
+	perf_count(owned);
+	EXPECT_EQ(perf_event_count(owned), 1u);
+
+	perf_free(shared);
+	perf_free(owned);
+}
+
+static constexpr int THREADS = 4;
+static constexpr int ITERATIONS = 100000;
+
+static void *count_thread(void *arg)
+{
+	for (int i = 0; i < ITERATIONS; i++) {
+		perf_count((perf_counter_t)arg);
+	}
+
+	return nullptr;
+}
+
+static void *alloc_thread(void *)
+{
+	for (int i = 0; i < 1000; i++) {
+		perf_free(perf_alloc(PC_COUNT, "test: alloc thread"));
+		perf_alloc_once(PC_COUNT, "test: shared concurrent");
+	}
+
+	return nullptr;
+}
+
+static void *elapsed_thread(void *arg)
+{
+	for (int i = 0; i < ITERATIONS; i++) {
+		perf_set_elapsed((perf_counter_t)arg, 100);
+	}
+
+	return nullptr;
+}
+
+static px4::atomic_bool reset_all_running{false};
+
+static void *reset_all_thread(void *)
+{
+	while (reset_all_running.load()) {
+		perf_reset_all();
+	}
+
+	return nullptr;
+}
+
+TEST(PerfCounterTest, ResetAllConcurrent)
+{
+	// an owned counter updated while another thread resets all counters
+	perf_counter_t a = perf_alloc(PC_ELAPSED, "test: reset concurrent");
+	pthread_t thread;
+	reset_all_running.store(true);
+	pthread_create(&thread, nullptr, reset_all_thread, nullptr);
+
+	int inconsistent = 0;
+	perf_counter_snapshot_t snapshot;
+
+	for (int i = 0; i < 10 * ITERATIONS; i++) {
+		perf_set_elapsed(a, 100);
+
+		// the reset never interleaves with an update
+		perf_snapshot(a, &snapshot);
+
+		if ((snapshot.event_count == 0) || (snapshot.time_total != snapshot.event_count * 100)) {
+			inconsistent++;
+		}
+	}
+
+	reset_all_running.store(false);
+	pthread_join(thread, nullptr);
+
+	EXPECT_EQ(inconsistent, 0);
+
+	perf_free(a);
+}
+
+TEST(PerfCounterTest, Concurrent)
+{
+	// shared counters may be updated from several threads
+	perf_counter_t a = perf_alloc_once(PC_COUNT, "test: concurrent");
+	perf_counter_t b = perf_alloc_once(PC_ELAPSED, "test: concurrent elapsed");
+	pthread_t threads[3 * THREADS];
+
+	for (int i = 0; i < THREADS; i++) {
+		pthread_create(&threads[i], nullptr, count_thread, a);
+		pthread_create(&threads[THREADS + i], nullptr, alloc_thread, nullptr);
+		pthread_create(&threads[2 * THREADS + i], nullptr, elapsed_thread, b);
+	}
+
+	// reading while updating
+	char buffer[256];
+
+	for (int i = 0; i < 1000; i++) {
+		perf_print_counter_buffer(buffer, sizeof(buffer), b);
+	}
+
+	for (int i = 0; i < 3 * THREADS; i++) {
+		pthread_join(threads[i], nullptr);
+	}
+
+	// no lost increments
+	EXPECT_EQ(perf_event_count(a), (uint64_t)THREADS * ITERATIONS);
+
+	// colliding updates are dropped, but never corrupt the statistics
+	EXPECT_GT(perf_event_count(b), 0u);
+	EXPECT_LE(perf_event_count(b), (uint64_t)THREADS * ITERATIONS);
+	EXPECT_NEAR(perf_mean(b), 100e-6f, 1e-9f);
+
+	// a single shared counter, the list intact
+	perf_counter_t shared = perf_alloc_once(PC_COUNT, "test: shared concurrent");
+	EXPECT_EQ(registered(shared), 1);
+	EXPECT_EQ(registered(a), 1);
+
+	perf_free(shared);
+	perf_free(b);
+	perf_free(a);
+}
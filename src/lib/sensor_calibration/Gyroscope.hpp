@@ -78,6 +78,7 @@ public:
 
 	// apply offsets and scale
 	// rotate corrected measurements from sensor to body frame
+	// (affine, so it's applied once to integrated or filtered data instead of to every raw FIFO sample)
 	inline matrix::Vector3f Correct(const matrix::Vector3f &data) const
 	{
 		return _rotation * matrix::Vector3f{data - _thermal_offset - _offset};
@@ -66,7 +66,14 @@ static constexpr unsigned get_lookup_table_index(float *val, float min, float ma
 	return static_cast<unsigned>((-(min) + *val) / SAMPLING_RES);
 }
 
-static constexpr float get_table_data(float lat, float lon, const int16_t table[LAT_DIM][LON_DIM])
+struct TableCell {
+	unsigned lat_index;
+	unsigned lon_index;
+	float lat_scale;
+	float lon_scale;
+};
+
+static constexpr TableCell get_table_cell(float lat, float lon)
 {
 	lat = math::constrain(lat, SAMPLING_MIN_LAT, SAMPLING_MAX_LAT);
 
@@ -82,23 +89,52 @@ static constexpr float get_table_data(float lat, float lon, const int16_t table[
 	float min_lat = floorf(lat / SAMPLING_RES) * SAMPLING_RES;
 	float min_lon = floorf(lon / SAMPLING_RES) * SAMPLING_RES;
 
+	TableCell cell{};
+
 	/* find index of nearest low sampling point */
-	unsigned min_lat_index = get_lookup_table_index(&min_lat, SAMPLING_MIN_LAT, SAMPLING_MAX_LAT);
-	unsigned min_lon_index = get_lookup_table_index(&min_lon, SAMPLING_MIN_LON, SAMPLING_MAX_LON);
+	cell.lat_index = get_lookup_table_index(&min_lat, SAMPLING_MIN_LAT, SAMPLING_MAX_LAT);
+	cell.lon_index = get_lookup_table_index(&min_lon, SAMPLING_MIN_LON, SAMPLING_MAX_LON);
+
+	/* position within the cell used for bilinear interpolation */
+	cell.lat_scale = constrain((lat - min_lat) / SAMPLING_RES, 0.f, 1.f);
+	cell.lon_scale = constrain((lon - min_lon) / SAMPLING_RES, 0.f, 1.f);
+
+	return cell;
+}
+
+static constexpr GeoMagTile::Corners get_table_corners(const TableCell &cell, const int16_t table[LAT_DIM][LON_DIM])
+{
+	const float data_sw = table[cell.lat_index][cell.lon_index];
+	const float data_se = table[cell.lat_index][cell.lon_index + 1];
+	const float data_ne = table[cell.lat_index + 1][cell.lon_index + 1];
+	const float data_nw = table[cell.lat_index + 1][cell.lon_index];
 
-	const float data_sw = table[min_lat_index][min_lon_index];
-	const float data_se = table[min_lat_index][min_lon_index + 1];
-	const float data_ne = table[min_lat_index + 1][min_lon_index + 1];
-	const float data_nw = table[min_lat_index + 1][min_lon_index];
+	return GeoMagTile::Corners{data_sw, data_nw, data_se - data_sw, data_ne - data_nw};
+}
 
+static constexpr float interpolate(const GeoMagTile::Corners &corners, const TableCell &cell)
+{
 	/* perform bilinear interpolation on the four grid corners */
-	const float lat_scale = constrain((lat - min_lat) / SAMPLING_RES, 0.f, 1.f);
-	const float lon_scale = constrain((lon - min_lon) / SAMPLING_RES, 0.f, 1.f);
+	const float data_min = cell.lon_scale * corners.south + corners.sw;
+	const float data_max = cell.lon_scale * corners.north + corners.nw;
+
+	return cell.lat_scale * (data_max - data_min) + data_min;
+}
 
-	const float data_min = lon_scale * (data_se - data_sw) + data_sw;
-	const float data_max = lon_scale * (data_ne - data_nw) + data_nw;
+static constexpr void interpolate_gradient(const GeoMagTile::Corners &corners, const TableCell &cell, float grad[2])
+{
+	/* partial derivatives of the bilinear interpolation per degree of latitude and longitude */
+	const float data_min = cell.lon_scale * corners.south + corners.sw;
+	const float data_max = cell.lon_scale * corners.north + corners.nw;
 
-	return lat_scale * (data_max - data_min) + data_min;
+	grad[0] = (data_max - data_min) / SAMPLING_RES;
+	grad[1] = ((1.f - cell.lat_scale) * corners.south + cell.lat_scale * corners.north) / SAMPLING_RES;
+}
+
+static constexpr float get_table_data(float lat, float lon, const int16_t table[LAT_DIM][LON_DIM])
+{
+	const TableCell cell = get_table_cell(lat, lon);
+	return interpolate(get_table_corners(cell, table), cell);
 }
 
 float get_mag_declination_radians(float lat, float lon)
@@ -130,3 +166,42 @@ float get_mag_strength_tesla(float lat, float lon)
 {
 	return get_mag_strength_gauss(lat, lon) * 1e-4f; // 1 Gauss == 0.0001 Tesla
 }
+
+bool GeoMagTile::contains(float lat, float lon) const
+{
+	const TableCell cell = get_table_cell(lat, lon);
+	return _valid && (cell.lat_index == _lat_index) && (cell.lon_index == _lon_index);
+}
+
+GeoMagTile::Field GeoMagTile::lookup(float lat, float lon)
+{
+	const TableCell cell = get_table_cell(lat, lon);
+
+	if (!_valid || (cell.lat_index != _lat_index) || (cell.lon_index != _lon_index)) {
+		_declination = get_table_corners(cell, declination_table);
+		_inclination = get_table_corners(cell, inclination_table);
+		_strength = get_table_corners(cell, strength_table);
+
+		_lat_index = cell.lat_index;
+		_lon_index = cell.lon_index;
+		_valid = true;
+	}
+
+	// tables stored as 10^-4 radians and milli-Gauss * 10
+	Field field{};
+	field.declination = interpolate(_declination, cell) * 1e-4f;
+	field.inclination = interpolate(_inclination, cell) * 1e-4f;
+	field.strength = interpolate(_strength, cell) * 1e-4f;
+
+	interpolate_gradient(_declination, cell, field.declination_grad);
+	interpolate_gradient(_inclination, cell, field.inclination_grad);
+	interpolate_gradient(_strength, cell, field.strength_grad);
+
+	for (int i = 0; i < 2; i++) {
+		field.declination_grad[i] *= 1e-4f;
+		field.inclination_grad[i] *= 1e-4f;
+		field.strength_grad[i] *= 1e-4f;
+	}
+
+	return field;
+}
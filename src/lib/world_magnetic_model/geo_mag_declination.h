@@ -52,3 +52,48 @@ float get_mag_inclination_radians(float lat, float lon);
 // return magnetic field strength in Gauss or Tesla
 float get_mag_strength_gauss(float lat, float lon);
 float get_mag_strength_tesla(float lat, float lon);
+
+/**
+ * Interpolation tile for the lookup table cell containing a position.
+ *
+ * Declination, inclination and strength are all interpolated from the same four table grid corners.
+ * The tile loads these corners once and reuses them for all lookups until a position outside of the
+ * cell is requested, which avoids redundant table indexing for a vehicle that stays in the same area.
+ */
+class GeoMagTile
+{
+public:
+	struct Field {
+		float declination;		///< magnetic declination (rad)
+		float inclination;		///< magnetic field inclination (rad)
+		float strength;			///< magnetic field strength (Gauss)
+		float declination_grad[2];	///< declination gradient with respect to latitude and longitude (rad/deg)
+		float inclination_grad[2];	///< inclination gradient with respect to latitude and longitude (rad/deg)
+		float strength_grad[2];		///< strength gradient with respect to latitude and longitude (Gauss/deg)
+	};
+
+	// table data of the four grid corners of the tile
+	struct Corners {
+		float sw;	///< south west grid corner
+		float nw;	///< north west grid corner
+		float south;	///< difference from the south east to the south west grid corner
+		float north;	///< difference from the north east to the north west grid corner
+	};
+
+	// Return the magnetic field and its gradients at the given position, reloading the tile if required
+	Field lookup(float lat, float lon);
+
+	// true if the tile is loaded and the given position lies within it
+	bool contains(float lat, float lon) const;
+
+	void invalidate() { _valid = false; }
+
+private:
+	Corners _declination{};
+	Corners _inclination{};
+	Corners _strength{};
+
+	unsigned _lat_index{0};
+	unsigned _lon_index{0};
+	bool _valid{false};
+};
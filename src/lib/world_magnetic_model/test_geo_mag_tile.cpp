@@ -0,0 +1,85 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "geo_mag_declination.h"
+
+TEST(GeoMagTileTest, matchesTableLookup)
+{
+	GeoMagTile tile;
+
+	for (float lat = -90.f; lat <= 90.f; lat += 3.3f) {
+		for (float lon = -180.f; lon <= 180.f; lon += 4.7f) {
+			const GeoMagTile::Field field = tile.lookup(lat, lon);
+
+			EXPECT_FLOAT_EQ(field.declination, get_mag_declination_radians(lat, lon));
+			EXPECT_FLOAT_EQ(field.inclination, get_mag_inclination_radians(lat, lon));
+			EXPECT_FLOAT_EQ(field.strength, get_mag_strength_gauss(lat, lon));
+		}
+	}
+}
+
+TEST(GeoMagTileTest, reusedWithinCell)
+{
+	GeoMagTile tile;
+	EXPECT_FALSE(tile.contains(47.3f, 8.5f));
+
+	tile.lookup(47.3f, 8.5f);
+	EXPECT_TRUE(tile.contains(47.3f, 8.5f));
+	EXPECT_TRUE(tile.contains(42.1f, 1.2f));
+	EXPECT_FALSE(tile.contains(50.1f, 8.5f));
+	EXPECT_FALSE(tile.contains(47.3f, 10.1f));
+
+	tile.invalidate();
+	EXPECT_FALSE(tile.contains(47.3f, 8.5f));
+}
+
+TEST(GeoMagTileTest, gradient)
+{
+	GeoMagTile tile;
+	const float lat = 47.3f;
+	const float lon = 8.5f;
+	const float delta = 0.01f;
+
+	const GeoMagTile::Field field = tile.lookup(lat, lon);
+
+	// the gradient matches a finite difference within the cell
+	EXPECT_NEAR(field.declination_grad[0], (get_mag_declination_radians(lat + delta, lon) - field.declination) / delta, 1e-4f);
+	EXPECT_NEAR(field.declination_grad[1], (get_mag_declination_radians(lat, lon + delta) - field.declination) / delta, 1e-4f);
+	EXPECT_NEAR(field.inclination_grad[0], (get_mag_inclination_radians(lat + delta, lon) - field.inclination) / delta, 1e-4f);
+	EXPECT_NEAR(field.inclination_grad[1], (get_mag_inclination_radians(lat, lon + delta) - field.inclination) / delta, 1e-4f);
+	EXPECT_NEAR(field.strength_grad[0], (get_mag_strength_gauss(lat + delta, lon) - field.strength) / delta, 1e-4f);
+	EXPECT_NEAR(field.strength_grad[1], (get_mag_strength_gauss(lat, lon + delta) - field.strength) / delta, 1e-4f);
+}
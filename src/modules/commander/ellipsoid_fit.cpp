@@ -0,0 +1,239 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ellipsoid_fit.hpp"
+
+using namespace matrix;
+
+static constexpr int upper_index(int row, int col, int n) { return row * n - (row * (row - 1)) / 2 + (col - row); }
+
+template<size_t M, size_t N>
+static bool all_finite(const Matrix<float, M, N> &m)
+{
+	for (size_t i = 0; i < M; i++) {
+		for (size_t j = 0; j < N; j++) {
+			if (!PX4_ISFINITE(m(i, j))) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void EllipsoidFitAccumulator::reset()
+{
+	for (auto &v : _DTD) {
+		v = 0.f;
+	}
+
+	for (auto &v : _DTr) {
+		v = 0.f;
+	}
+
+	_reference.zero();
+	_samples = 0;
+}
+
+void EllipsoidFitAccumulator::update(const Vector3f &sample)
+{
+	if (_samples == 0) {
+		_reference = sample;
+	}
+
+	const float x = sample(0) - _reference(0);
+	const float y = sample(1) - _reference(1);
+	const float z = sample(2) - _reference(2);
+
+	const float xx = x * x;
+	const float yy = y * y;
+	const float zz = z * z;
+
+	const float d[N] {
+		xx + yy - 2.f * zz,
+		xx - 2.f * yy + zz,
+		2.f * x * y,
+		2.f * x * z,
+		2.f * y * z,
+		2.f * x,
+		2.f * y,
+		2.f * z,
+		1.f
+	};
+
+	const float r = xx + yy + zz;
+
+	int k = 0;
+
+	for (int i = 0; i < N; i++) {
+		for (int j = i; j < N; j++) {
+			_DTD[k++] += d[i] * d[j];
+		}
+
+		_DTr[i] += d[i] * r;
+	}
+
+	_samples++;
+}
+
+SquareMatrix<float, EllipsoidFitAccumulator::N> EllipsoidFitAccumulator::normalMatrix() const
+{
+	SquareMatrix<float, N> DTD;
+
+	for (int i = 0; i < N; i++) {
+		for (int j = i; j < N; j++) {
+			DTD(i, j) = DTD(j, i) = _DTD[upper_index(i, j, N)];
+		}
+	}
+
+	return DTD;
+}
+
+bool EllipsoidFitAccumulator::solveSphere(sphere_params &params) const
+{
+	if (_samples < N_SPHERE) {
+		return false;
+	}
+
+	// |x|^2 = 2 o^T x + u8  ->  |x - o|^2 = u8 + |o|^2
+	const SquareMatrix<float, N_SPHERE> DTD{normalMatrix().slice<N_SPHERE, N_SPHERE>(N - N_SPHERE, N - N_SPHERE)};
+	const Vector<float, N_SPHERE> DTr{_DTr + N - N_SPHERE};
+
+	SquareMatrix<float, N_SPHERE> DTD_inv;
+
+	if (!inv(DTD, DTD_inv)) {
+		return false;
+	}
+
+	const Vector<float, N_SPHERE> u{DTD_inv * DTr};
+	const Vector3f offset{u(0), u(1), u(2)};
+	const float radius_squared = u(3) + offset.norm_squared();
+
+	if (!(radius_squared > 0.f) || !all_finite(offset)) {
+		return false;
+	}
+
+	params.offset = offset + _reference;
+	params.radius = sqrtf(radius_squared);
+	params.diag = Vector3f{1.f, 1.f, 1.f};
+	params.offdiag.zero();
+
+	return true;
+}
+
+bool EllipsoidFitAccumulator::solveEllipsoid(sphere_params &params) const
+{
+	if (_samples < N) {
+		return false;
+	}
+
+	SquareMatrix<float, N> DTD_inv;
+
+	if (!inv(normalMatrix(), DTD_inv)) {
+		return false;
+	}
+
+	const Vector<float, N> u{DTD_inv * Vector<float, N>{_DTr}};
+
+	// quadric x^T A x + 2 b^T x + c = 0
+	SquareMatrix3f A;
+	A(0, 0) = u(0) + u(1) - 1.f;
+	A(1, 1) = u(0) - 2.f * u(1) - 1.f;
+	A(2, 2) = u(1) - 2.f * u(0) - 1.f;
+	A(0, 1) = A(1, 0) = u(2);
+	A(0, 2) = A(2, 0) = u(3);
+	A(1, 2) = A(2, 1) = u(4);
+	const Vector3f b{u(5), u(6), u(7)};
+	const float c = u(8);
+
+	SquareMatrix3f A_inv;
+
+	if (!inv(A, A_inv)) {
+		return false;
+	}
+
+	// (x - o)^T Q (x - o) = 1
+	const Vector3f offset{-(A_inv * b)};
+	const float scale = offset.dot(A * offset) - c;
+
+	if (fabsf(scale) < FLT_EPSILON) {
+		return false;
+	}
+
+	const SquareMatrix3f Q{A / scale};
+	const float det_Q = Q(0, 0) * (Q(1, 1) * Q(2, 2) - Q(1, 2) * Q(2, 1))
+			    - Q(0, 1) * (Q(1, 0) * Q(2, 2) - Q(1, 2) * Q(2, 0))
+			    + Q(0, 2) * (Q(1, 0) * Q(2, 1) - Q(1, 1) * Q(2, 0));
+
+	if (!(det_Q > 0.f) || !(Q(0, 0) > 0.f)) {
+		// not an ellipsoid
+		return false;
+	}
+
+	// W = radius * sqrtm(Q) with det(W) = 1, matrix square root using the Denman-Beavers iteration
+	SquareMatrix3f Y{Q};
+	SquareMatrix3f Z{eye<float, 3>()};
+
+	for (int i = 0; i < 20; i++) {
+		SquareMatrix3f Y_inv;
+		SquareMatrix3f Z_inv;
+
+		if (!inv(Y, Y_inv) || !inv(Z, Z_inv)) {
+			return false;
+		}
+
+		const SquareMatrix3f Y_next{(Y + Z_inv) * 0.5f};
+		Z = (Z + Y_inv) * 0.5f;
+
+		const float step = (Y_next - Y).abs().max();
+		Y = Y_next;
+
+		if (step < 1e-6f * Y.abs().max()) {
+			break;
+		}
+	}
+
+	const float radius = powf(det_Q, -1.f / 6.f);
+	const SquareMatrix3f W{Y * radius};
+
+	if (!all_finite(W) || !all_finite(offset) || !PX4_ISFINITE(radius)) {
+		return false;
+	}
+
+	params.offset = offset + _reference;
+	params.radius = radius;
+	params.diag = Vector3f{W(0, 0), W(1, 1), W(2, 2)};
+	params.offdiag = Vector3f{0.5f * (W(0, 1) + W(1, 0)), 0.5f * (W(0, 2) + W(2, 0)), 0.5f * (W(1, 2) + W(2, 1))};
+
+	return true;
+}
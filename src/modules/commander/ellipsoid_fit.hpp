@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "lm_fit.hpp"
+
+#include <matrix/matrix/math.hpp>
+
+/**
+ * Streaming linear least-squares ellipsoid fit.
+ *
+ * Accumulates the normal equations of the algebraic ellipsoid fit sample by sample while the data is
+ * collected, the final solve is then independent of the number of samples. The quadric is parametrized
+ * around a sphere (ref.: Yury Petrov, ellipsoid_fit) with an explicit constant term
+ *
+ *   x^2 + y^2 + z^2 = u0 (x^2 + y^2 - 2 z^2) + u1 (x^2 - 2 y^2 + z^2) + 2 u2 xy + 2 u3 xz + 2 u4 yz + 2 u5 x + 2 u6 y + 2 u7 z + u8
+ *
+ * so that the sphere fit is the sub-problem of the last four parameters and data far from the origin is
+ * handled by fitting relative to the first sample.
+ */
+class EllipsoidFitAccumulator
+{
+public:
+	EllipsoidFitAccumulator() = default;
+	~EllipsoidFitAccumulator() = default;
+
+	void reset();
+
+	/**
+	 * Add a sample to the normal equations.
+	 */
+	void update(const matrix::Vector3f &sample);
+
+	unsigned samples() const { return _samples; }
+
+	/**
+	 * Solve for offset and radius only (diag = 1, offdiag = 0).
+	 *
+	 * @return true on success
+	 */
+	bool solveSphere(sphere_params &params) const;
+
+	/**
+	 * Solve for the full ellipsoid. The radius is chosen such that the soft iron matrix has a unit determinant.
+	 *
+	 * @return true on success
+	 */
+	bool solveEllipsoid(sphere_params &params) const;
+
+private:
+	static constexpr int N = 9;     ///< number of ellipsoid parameters
+	static constexpr int N_SPHERE = 4; ///< the sphere parameters are the last N_SPHERE ones
+
+	matrix::SquareMatrix<float, N> normalMatrix() const;
+
+	float _DTD[N * (N + 1) / 2] {}; ///< upper triangle of D^T D, row major
+	float _DTr[N] {};               ///< D^T r
+
+	matrix::Vector3f _reference{};  ///< first sample, all samples are fitted relative to it
+
+	unsigned _samples{0};
+};
@@ -40,6 +40,7 @@
 #include "mag_calibration.h"
 #include "commander_helper.h"
 #include "calibration_routines.h"
+#include "ellipsoid_fit.hpp"
 #include "lm_fit.hpp"
 #include "calibration_messages.h"
 #include "factory_calibration_storage.h"
@@ -94,6 +95,8 @@ struct mag_worker_data_t {
 	float		*y[MAX_MAGS];
 	float		*z[MAX_MAGS];
 
+	EllipsoidFitAccumulator	*fit_accumulator[MAX_MAGS];
+
 	calibration::Magnetometer calibration[MAX_MAGS] {};
 };
 
@@ -389,6 +392,9 @@ static calibrate_return mag_calibration_worker(detect_orientation_return orienta
 						worker_data->z[cur_mag][worker_data->calibration_counter_total[cur_mag]] = new_samples[cur_mag](2);
 
 						worker_data->calibration_counter_total[cur_mag]++;
+
+						// update the linear fit while collecting, so that it's ready once all sides are done
+						worker_data->fit_accumulator[cur_mag]->update(new_samples[cur_mag]);
 					}
 				}
 
@@ -518,6 +524,7 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub, int32_t cal_ma
 		worker_data.x[cur_mag] = nullptr;
 		worker_data.y[cur_mag] = nullptr;
 		worker_data.z[cur_mag] = nullptr;
+		worker_data.fit_accumulator[cur_mag] = nullptr;
 		worker_data.calibration_counter_total[cur_mag] = 0;
 	}
 
@@ -538,8 +545,10 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub, int32_t cal_ma
 			worker_data.x[cur_mag] = static_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
 			worker_data.y[cur_mag] = static_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
 			worker_data.z[cur_mag] = static_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
+			worker_data.fit_accumulator[cur_mag] = new EllipsoidFitAccumulator();
 
-			if (worker_data.x[cur_mag] == nullptr || worker_data.y[cur_mag] == nullptr || worker_data.z[cur_mag] == nullptr) {
+			if (worker_data.x[cur_mag] == nullptr || worker_data.y[cur_mag] == nullptr || worker_data.z[cur_mag] == nullptr
+			    || worker_data.fit_accumulator[cur_mag] == nullptr) {
 				calibration_log_critical(mavlink_log_pub, "ERROR: out of memory");
 				result = calibrate_return_error;
 				break;
@@ -592,19 +601,36 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub, int32_t cal_ma
 
 				bool sphere_fit_success = false;
 				bool ellipsoid_fit_success = false;
-				int ret = lm_mag_fit(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
-						     worker_data.calibration_counter_total[cur_mag], sphere_data, false);
 
-				if (ret == PX4_OK) {
-					sphere_fit_success = true;
-					PX4_INFO("Mag: %" PRIu8 " sphere radius: %.4f", cur_mag, (double)sphere_data.radius);
+				// solve the normal equations accumulated during data collection first
+				const EllipsoidFitAccumulator &fit_accumulator = *worker_data.fit_accumulator[cur_mag];
+				sphere_params linear_fit = sphere_data;
+
+				if (sphere_fit_only ? fit_accumulator.solveSphere(linear_fit) : fit_accumulator.solveEllipsoid(linear_fit)) {
+					if (linear_fit.radius > 0.2f && linear_fit.radius < 0.7f) {
+						sphere_data = linear_fit;
+						sphere_fit_success = true;
+						ellipsoid_fit_success = !sphere_fit_only;
+						PX4_INFO("Mag: %" PRIu8 " linear fit radius: %.4f", cur_mag, (double)sphere_data.radius);
+					}
+				}
+
+				if (!sphere_fit_success) {
+					// fall back to the iterative fit
+					int ret = lm_mag_fit(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
+							     worker_data.calibration_counter_total[cur_mag], sphere_data, false);
 
-					if (!sphere_fit_only) {
-						int ellipsoid_ret = lm_mag_fit(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
-									       worker_data.calibration_counter_total[cur_mag], sphere_data, true);
+					if (ret == PX4_OK) {
+						sphere_fit_success = true;
+						PX4_INFO("Mag: %" PRIu8 " sphere radius: %.4f", cur_mag, (double)sphere_data.radius);
 
-						if (ellipsoid_ret == PX4_OK) {
-							ellipsoid_fit_success = true;
+						if (!sphere_fit_only) {
+							int ellipsoid_ret = lm_mag_fit(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
+										       worker_data.calibration_counter_total[cur_mag], sphere_data, true);
+
+							if (ellipsoid_ret == PX4_OK) {
+								ellipsoid_fit_success = true;
+							}
 						}
 					}
 				}
@@ -884,6 +910,7 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub, int32_t cal_ma
 		free(worker_data.x[cur_mag]);
 		free(worker_data.y[cur_mag]);
 		free(worker_data.z[cur_mag]);
+		delete worker_data.fit_accumulator[cur_mag];
 	}
 
 	FactoryCalibrationStorage factory_storage;
@@ -42,6 +42,7 @@
 #include <matrix/matrix/math.hpp>
 #include <px4_platform_common/defines.h>
 
+#include "ellipsoid_fit.hpp"
 #include "lm_fit.hpp"
 #include "mag_calibration_test_data.h"
 
@@ -236,3 +237,109 @@ TEST_F(MagCalTest, replayTestData)
 	EXPECT_NEAR(ellipsoid.diag(1), scale_true(1), 0.01f) << "scale Y: " << ellipsoid.diag(1);
 	EXPECT_NEAR(ellipsoid.diag(2), scale_true(2), 0.01f) << "scale Z: " << ellipsoid.diag(2);
 }
+
+TEST_F(MagCalTest, accumulatorSphere2Sides)
+{
+	// GIVEN: a dataset of points located on two orthogonal circles with an offset
+	static constexpr unsigned int N_SAMPLES = 240;
+
+	const float mag_str_true = 0.4f;
+	const Vector3f offset_true = {0.12f, -0.3f, 0.45f};
+	const Vector3f scale_true = {1.f, 1.f, 1.f};
+
+	float x[N_SAMPLES];
+	float y[N_SAMPLES];
+	float z[N_SAMPLES];
+
+	generate2SidesMagData(x, y, z, N_SAMPLES, mag_str_true);
+	modifyOffsetScale(x, y, z, N_SAMPLES, offset_true, scale_true);
+
+	// WHEN: accumulating the samples and solving for a sphere
+	EllipsoidFitAccumulator accumulator;
+
+	for (unsigned int k = 0; k < N_SAMPLES; k++) {
+		accumulator.update(Vector3f{x[k], y[k], z[k]});
+	}
+
+	sphere_params sphere;
+	const bool success = accumulator.solveSphere(sphere);
+
+	// THEN: the linear solution is exact
+	EXPECT_TRUE(success);
+	EXPECT_EQ(accumulator.samples(), N_SAMPLES);
+	EXPECT_NEAR(sphere.radius, mag_str_true, 0.001f) << "radius: " << sphere.radius;
+	EXPECT_NEAR(sphere.offset(0), offset_true(0), 0.001f) << "offset X: " << sphere.offset(0);
+	EXPECT_NEAR(sphere.offset(1), offset_true(1), 0.001f) << "offset Y: " << sphere.offset(1);
+	EXPECT_NEAR(sphere.offset(2), offset_true(2), 0.001f) << "offset Z: " << sphere.offset(2);
+}
+
+TEST_F(MagCalTest, accumulatorEllipsoidRegularlySpaced)
+{
+	// GIVEN: a dataset of regularly spaced points on an ellipsoid not centered on the origin
+	static constexpr unsigned int N_SAMPLES = 240;
+
+	const float mag_str_true = 0.4f;
+	const Vector3f offset_true = {-1.07f, 0.35f, -0.78f};
+	const Vector3f scale_true = {1.1f, 0.95f, 0.9f};
+
+	float x[N_SAMPLES];
+	float y[N_SAMPLES];
+	float z[N_SAMPLES];
+	generateRegularData(x, y, z, N_SAMPLES, mag_str_true);
+	modifyOffsetScale(x, y, z, N_SAMPLES, offset_true, scale_true);
+
+	// WHEN: accumulating the samples and solving for an ellipsoid
+	EllipsoidFitAccumulator accumulator;
+
+	for (unsigned int k = 0; k < N_SAMPLES; k++) {
+		accumulator.update(Vector3f{x[k], y[k], z[k]});
+	}
+
+	sphere_params ellipsoid;
+	const bool success = accumulator.solveEllipsoid(ellipsoid);
+
+	// THEN: all samples are mapped back onto a sphere
+	EXPECT_TRUE(success);
+	EXPECT_NEAR(ellipsoid.offset(0), offset_true(0), 0.001f) << "offset X: " << ellipsoid.offset(0);
+	EXPECT_NEAR(ellipsoid.offset(1), offset_true(1), 0.001f) << "offset Y: " << ellipsoid.offset(1);
+	EXPECT_NEAR(ellipsoid.offset(2), offset_true(2), 0.001f) << "offset Z: " << ellipsoid.offset(2);
+	EXPECT_NEAR(ellipsoid.offdiag(0), 0.f, 0.001f) << "offdiag XY: " << ellipsoid.offdiag(0);
+	EXPECT_NEAR(ellipsoid.offdiag(1), 0.f, 0.001f) << "offdiag XZ: " << ellipsoid.offdiag(1);
+	EXPECT_NEAR(ellipsoid.offdiag(2), 0.f, 0.001f) << "offdiag YZ: " << ellipsoid.offdiag(2);
+
+	// the scale factors are only known up to the radius
+	const float radius_scale = mag_str_true / ellipsoid.radius;
+	EXPECT_NEAR(ellipsoid.diag(0) * scale_true(0) * radius_scale, 1.f, 0.001f) << "scale X: " << ellipsoid.diag(0);
+	EXPECT_NEAR(ellipsoid.diag(1) * scale_true(1) * radius_scale, 1.f, 0.001f) << "scale Y: " << ellipsoid.diag(1);
+	EXPECT_NEAR(ellipsoid.diag(2) * scale_true(2) * radius_scale, 1.f, 0.001f) << "scale Z: " << ellipsoid.diag(2);
+}
+
+TEST_F(MagCalTest, accumulatorReplayTestData)
+{
+	// GIVEN: a real test dataset with large offsets
+	constexpr unsigned int N_SAMPLES = 231;
+
+	const float mag_str_true = 0.4f;
+	const Vector3f offset_true = {-0.18f, 0.05f, -0.58f};
+	const Vector3f scale_true = {1.f, 1.06f, 0.94f};
+
+	// WHEN: accumulating the samples and solving for an ellipsoid
+	EllipsoidFitAccumulator accumulator;
+
+	for (unsigned int k = 0; k < N_SAMPLES; k++) {
+		accumulator.update(Vector3f{mag_data1_x[k], mag_data1_y[k], mag_data1_z[k]});
+	}
+
+	sphere_params ellipsoid;
+	const bool success = accumulator.solveEllipsoid(ellipsoid);
+
+	// THEN: the solution is close to the iterative fit
+	EXPECT_TRUE(success);
+	EXPECT_NEAR(ellipsoid.radius, mag_str_true, 0.1f) << "radius: " << ellipsoid.radius;
+	EXPECT_NEAR(ellipsoid.offset(0), offset_true(0), 0.01f) << "offset X: " << ellipsoid.offset(0);
+	EXPECT_NEAR(ellipsoid.offset(1), offset_true(1), 0.01f) << "offset Y: " << ellipsoid.offset(1);
+	EXPECT_NEAR(ellipsoid.offset(2), offset_true(2), 0.01f) << "offset Z: " << ellipsoid.offset(2);
+	EXPECT_NEAR(ellipsoid.diag(0), scale_true(0), 0.01f) << "scale X: " << ellipsoid.diag(0);
+	EXPECT_NEAR(ellipsoid.diag(1), scale_true(1), 0.01f) << "scale Y: " << ellipsoid.diag(1);
+	EXPECT_NEAR(ellipsoid.diag(2), scale_true(2), 0.01f) << "scale Z: " << ellipsoid.diag(2);
+}
@@ -51,20 +51,36 @@ void EKFGSF_yaw::update(const imuSample &imu_sample,
 			float airspeed,			// true airspeed used for centripetal accel compensation - set to 0 when not required.
 			const Vector3f &imu_gyro_bias)  // estimated rate gyro bias (rad/sec)
 {
-	// copy to class variables
-	_delta_ang = imu_sample.delta_ang;
-	_delta_vel = imu_sample.delta_vel;
-	_delta_ang_dt = imu_sample.delta_ang_dt;
-	_delta_vel_dt = imu_sample.delta_vel_dt;
+	// copy to class variables, accumulating the IMU data if the bank update is decimated
+	if (_imu_sample_count == 0) {
+		_delta_ang = imu_sample.delta_ang;
+		_delta_vel = imu_sample.delta_vel;
+		_delta_ang_dt = imu_sample.delta_ang_dt;
+		_delta_vel_dt = imu_sample.delta_vel_dt;
+		_delta_vel_var = sq(_accel_noise * imu_sample.delta_vel_dt);
+		_delta_ang_var = sq(_gyro_noise * imu_sample.delta_ang_dt);
+
+	} else {
+		_delta_ang += imu_sample.delta_ang;
+		_delta_vel += imu_sample.delta_vel;
+		_delta_ang_dt += imu_sample.delta_ang_dt;
+		_delta_vel_dt += imu_sample.delta_vel_dt;
+		_delta_vel_var += sq(_accel_noise * imu_sample.delta_vel_dt);
+		_delta_ang_var += sq(_gyro_noise * imu_sample.delta_ang_dt);
+	}
+
+	_imu_sample_count++;
 	_true_airspeed = airspeed;
 
 	// to reduce effect of vibration, filter using an LPF whose time constant is 1/10 of the AHRS tilt correction time constant
-	const float filter_coef = fminf(10.0f * _delta_vel_dt * _tilt_gain, 1.0f);
-	const Vector3f accel = _delta_vel / fmaxf(_delta_vel_dt, 0.001f);
+	const float filter_coef = fminf(10.0f * imu_sample.delta_vel_dt * _tilt_gain, 1.0f);
+	const Vector3f accel = imu_sample.delta_vel / fmaxf(imu_sample.delta_vel_dt, 0.001f);
 	_ahrs_accel = _ahrs_accel * (1.0f - filter_coef) + accel * filter_coef;
 
 	// Initialise states first time
 	if (!_ahrs_ekf_gsf_tilt_aligned) {
+		_imu_sample_count = 0;
+
 		// check for excessive acceleration to reduce likelihood of large initial roll/pitch errors
 		// due to vehicle movement
 		const float accel_norm_sq = accel.norm_squared();
@@ -81,15 +97,21 @@ void EKFGSF_yaw::update(const imuSample &imu_sample,
 		return;
 	}
 
+	// The bank is only decimated while it is fusing velocity data and should keep doing so. Start, stop
+	// and reset transitions are always handled with the IMU data accumulated so far.
+	if (_ekf_gsf_vel_fuse_started && run_EKF && (_imu_sample_count < _decimation)) {
+		return;
+	}
+
+	_imu_sample_count = 0;
+
 	// calculate common values used by the AHRS complementary filter models
 	_ahrs_accel_norm = _ahrs_accel.norm();
 
 	// AHRS prediction cycle for each model - this always runs
 	_ahrs_accel_fusion_gain = ahrsCalcAccelGain();
 
-	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
-		predictEKF(model_index);
-	}
+	predictEKFBank();
 
 	// The 3-state EKF models only run when flying to avoid corrupted estimates due to operator handling and GPS interference
 	if (run_EKF && _vel_data_updated) {
@@ -105,41 +127,30 @@ void EKFGSF_yaw::update(const imuSample &imu_sample,
 
 			_ekf_gsf_vel_fuse_started = true;
 
-		} else {
-			bool bad_update = false;
+		} else if (updateEKFBank()) {
+			float total_weight = 0.0f;
+			// calculate weighting for each model assuming a normal distribution
+			const float min_weight = 1e-5f;
+			uint8_t n_weight_clips = 0;
 
 			for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
-				// subsequent measurements are fused as direct state observations
-				if (!updateEKF(model_index)) {
-					bad_update = true;
-				}
-			}
-
-			if (!bad_update) {
-				float total_weight = 0.0f;
-				// calculate weighting for each model assuming a normal distribution
-				const float min_weight = 1e-5f;
-				uint8_t n_weight_clips = 0;
-
-				for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
-					_model_weights(model_index) = gaussianDensity(model_index) * _model_weights(model_index);
+				_model_weights(model_index) = gaussianDensity(model_index) * _model_weights(model_index);
 
-					if (_model_weights(model_index) < min_weight) {
-						n_weight_clips++;
-						_model_weights(model_index) = min_weight;
-					}
-
-					total_weight += _model_weights(model_index);
+				if (_model_weights(model_index) < min_weight) {
+					n_weight_clips++;
+					_model_weights(model_index) = min_weight;
 				}
 
-				// normalise the weighting function
-				if (n_weight_clips < N_MODELS_EKFGSF) {
-					_model_weights /= total_weight;
+				total_weight += _model_weights(model_index);
+			}
+
+			// normalise the weighting function
+			if (n_weight_clips < N_MODELS_EKFGSF) {
+				_model_weights /= total_weight;
 
-				} else {
-					// all weights have collapsed due to excessive innovation variances so reset filters
-					initialiseEKFGSF();
-				}
+			} else {
+				// all weights have collapsed due to excessive innovation variances so reset filters
+				initialiseEKFGSF();
 			}
 		}
 
@@ -154,8 +165,8 @@ void EKFGSF_yaw::update(const imuSample &imu_sample,
 	Vector2f yaw_vector;
 
 	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
-		yaw_vector(0) += _model_weights(model_index) * cosf(_ekf_gsf[model_index].X(2));
-		yaw_vector(1) += _model_weights(model_index) * sinf(_ekf_gsf[model_index].X(2));
+		yaw_vector(0) += _model_weights(model_index) * cosf(_ekf_gsf.yaw[model_index]);
+		yaw_vector(1) += _model_weights(model_index) * sinf(_ekf_gsf.yaw[model_index]);
 	}
 
 	_gsf_yaw = atan2f(yaw_vector(1), yaw_vector(0));
@@ -165,8 +176,8 @@ void EKFGSF_yaw::update(const imuSample &imu_sample,
 	_gsf_yaw_variance = 0.0f;
 
 	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
-		const float yaw_delta = wrap_pi(_ekf_gsf[model_index].X(2) - _gsf_yaw);
-		_gsf_yaw_variance += _model_weights(model_index) * (_ekf_gsf[model_index].P(2, 2) + yaw_delta * yaw_delta);
+		const float yaw_delta = wrap_pi(_ekf_gsf.yaw[model_index] - _gsf_yaw);
+		_gsf_yaw_variance += _model_weights(model_index) * (_ekf_gsf.P22[model_index] + yaw_delta * yaw_delta);
 	}
 
 	// prevent the same velocity data being used more than once
@@ -259,207 +270,226 @@ void EKFGSF_yaw::ahrsAlignYaw()
 	// Align yaw angle for each model
 	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index++) {
 		Dcmf &R = _ahrs_ekf_gsf[model_index].R;
-		const float yaw = wrap_pi(_ekf_gsf[model_index].X(2));
+		const float yaw = wrap_pi(_ekf_gsf.yaw[model_index]);
 		R = updateYawInRotMat(yaw, R);
 
 		_ahrs_ekf_gsf[model_index].aligned = true;
 	}
 }
 
-void EKFGSF_yaw::predictEKF(const uint8_t model_index)
+void EKFGSF_yaw::predictEKFBank()
 {
 	// generate an attitude reference using IMU data
-	ahrsPredict(model_index);
+	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
+		ahrsPredict(model_index);
+	}
 
 	// we don't start running the EKF part of the algorithm until there are regular velocity observations
 	if (!_ekf_gsf_vel_fuse_started) {
 		return;
 	}
 
-	// Calculate the yaw state using a projection onto the horizontal that avoids gimbal lock
-	_ekf_gsf[model_index].X(2) = getEulerYaw(_ahrs_ekf_gsf[model_index].R);
-
-	// calculate delta velocity in a horizontal front-right frame
-	const Vector3f del_vel_NED = _ahrs_ekf_gsf[model_index].R * _delta_vel;
-	const float cos_yaw = cosf(_ekf_gsf[model_index].X(2));
-	const float sin_yaw = sinf(_ekf_gsf[model_index].X(2));
-	const float dvx =   del_vel_NED(0) * cos_yaw + del_vel_NED(1) * sin_yaw;
-	const float dvy = - del_vel_NED(0) * sin_yaw + del_vel_NED(1) * cos_yaw;
+	float cos_yaw[N_MODELS_EKFGSF];
+	float sin_yaw[N_MODELS_EKFGSF];
+	float dvx[N_MODELS_EKFGSF];
+	float dvy[N_MODELS_EKFGSF];
 
-	// sum delta velocities in earth frame:
-	_ekf_gsf[model_index].X(0) += del_vel_NED(0);
-	_ekf_gsf[model_index].X(1) += del_vel_NED(1);
+	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
+		// Calculate the yaw state using a projection onto the horizontal that avoids gimbal lock
+		_ekf_gsf.yaw[model_index] = getEulerYaw(_ahrs_ekf_gsf[model_index].R);
+
+		// calculate delta velocity in a horizontal front-right frame
+		const Vector3f del_vel_NED = _ahrs_ekf_gsf[model_index].R * _delta_vel;
+		cos_yaw[model_index] = cosf(_ekf_gsf.yaw[model_index]);
+		sin_yaw[model_index] = sinf(_ekf_gsf.yaw[model_index]);
+		dvx[model_index] =   del_vel_NED(0) * cos_yaw[model_index] + del_vel_NED(1) * sin_yaw[model_index];
+		dvy[model_index] = - del_vel_NED(0) * sin_yaw[model_index] + del_vel_NED(1) * cos_yaw[model_index];
+
+		// sum delta velocities in earth frame:
+		_ekf_gsf.vel_N[model_index] += del_vel_NED(0);
+		_ekf_gsf.vel_E[model_index] += del_vel_NED(1);
+	}
 
 	// predict covariance - equations generated using EKF/python/gsf_ekf_yaw_estimator/main.py
 
-	// Local short variable name copies required for readability
-	const float P00 = _ekf_gsf[model_index].P(0,0);
-	const float P01 = _ekf_gsf[model_index].P(0,1);
-	const float P02 = _ekf_gsf[model_index].P(0,2);
-	const float P11 = _ekf_gsf[model_index].P(1,1);
-	const float P12 = _ekf_gsf[model_index].P(1,2);
-	const float P22 = _ekf_gsf[model_index].P(2,2);
-	const float psi = _ekf_gsf[model_index].X(2);
-
 	// Use fixed values for delta velocity and delta angle process noise variances
-	const float dvxVar = sq(_accel_noise * _delta_vel_dt); // variance of forward delta velocity - (m/s)^2
+	const float dvxVar = _delta_vel_var; // variance of forward delta velocity - (m/s)^2
 	const float dvyVar = dvxVar; // variance of right delta velocity - (m/s)^2
-	const float dazVar = sq(_gyro_noise * _delta_ang_dt); // variance of yaw delta angle - rad^2
-
-	// optimized auto generated code from SymPy script src/lib/ecl/EKF/python/ekf_derivation/main.py
-	const float S0 = cosf(psi);
-	const float S1 = ecl::powf(S0, 2);
-	const float S2 = sinf(psi);
-	const float S3 = ecl::powf(S2, 2);
-	const float S4 = S0*dvy + S2*dvx;
-	const float S5 = P02 - P22*S4;
-	const float S6 = S0*dvx - S2*dvy;
-	const float S7 = S0*S2;
-	const float S8 = P01 + S7*dvxVar - S7*dvyVar;
-	const float S9 = P12 + P22*S6;
-
-	_ekf_gsf[model_index].P(0,0) = P00 - P02*S4 + S1*dvxVar + S3*dvyVar - S4*S5;
-	_ekf_gsf[model_index].P(0,1) = -P12*S4 + S5*S6 + S8;
-	_ekf_gsf[model_index].P(1,1) = P11 + P12*S6 + S1*dvyVar + S3*dvxVar + S6*S9;
-	_ekf_gsf[model_index].P(0,2) = S5;
-	_ekf_gsf[model_index].P(1,2) = S9;
-	_ekf_gsf[model_index].P(2,2) = P22 + dazVar;
-
-	// covariance matrix is symmetrical, so copy upper half to lower half
-	_ekf_gsf[model_index].P(1,0) = _ekf_gsf[model_index].P(0,1);
-	_ekf_gsf[model_index].P(2,0) = _ekf_gsf[model_index].P(0,2);
-	_ekf_gsf[model_index].P(2,1) = _ekf_gsf[model_index].P(1,2);
+	const float dazVar = _delta_ang_var; // variance of yaw delta angle - rad^2
 
 	// constrain variances
 	const float min_var = 1e-6f;
 
-	for (unsigned index = 0; index < 3; index++) {
-		_ekf_gsf[model_index].P(index, index) = fmaxf(_ekf_gsf[model_index].P(index, index), min_var);
+	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
+		// Local short variable name copies required for readability
+		const float P00 = _ekf_gsf.P00[model_index];
+		const float P01 = _ekf_gsf.P01[model_index];
+		const float P02 = _ekf_gsf.P02[model_index];
+		const float P11 = _ekf_gsf.P11[model_index];
+		const float P12 = _ekf_gsf.P12[model_index];
+		const float P22 = _ekf_gsf.P22[model_index];
+
+		// optimized auto generated code from SymPy script src/lib/ecl/EKF/python/ekf_derivation/main.py
+		const float S0 = cos_yaw[model_index];
+		const float S1 = S0*S0;
+		const float S2 = sin_yaw[model_index];
+		const float S3 = S2*S2;
+		const float S4 = S0*dvy[model_index] + S2*dvx[model_index];
+		const float S5 = P02 - P22*S4;
+		const float S6 = S0*dvx[model_index] - S2*dvy[model_index];
+		const float S7 = S0*S2;
+		const float S8 = P01 + S7*dvxVar - S7*dvyVar;
+		const float S9 = P12 + P22*S6;
+
+		_ekf_gsf.P00[model_index] = fmaxf(P00 - P02*S4 + S1*dvxVar + S3*dvyVar - S4*S5, min_var);
+		_ekf_gsf.P01[model_index] = -P12*S4 + S5*S6 + S8;
+		_ekf_gsf.P11[model_index] = fmaxf(P11 + P12*S6 + S1*dvyVar + S3*dvxVar + S6*S9, min_var);
+		_ekf_gsf.P02[model_index] = S5;
+		_ekf_gsf.P12[model_index] = S9;
+		_ekf_gsf.P22[model_index] = fmaxf(P22 + dazVar, min_var);
 	}
 }
 
-// Update EKF states and covariance for specified model index using velocity measurement
-bool EKFGSF_yaw::updateEKF(const uint8_t model_index)
+// Update EKF states and covariance for all models using velocity measurement
+bool EKFGSF_yaw::updateEKFBank()
 {
 	// set observation variance from accuracy estimate supplied by GPS and apply a sanity check minimum
 	const float velObsVar = sq(fmaxf(_vel_accuracy, 0.01f));
 
-	// calculate velocity observation innovations
-	_ekf_gsf[model_index].innov(0) = _ekf_gsf[model_index].X(0) - _vel_NE(0);
-	_ekf_gsf[model_index].innov(1) = _ekf_gsf[model_index].X(1) - _vel_NE(1);
-
-	// Use temporary variables for covariance elements to reduce verbosity of auto-code expressions
-	const float P00 = _ekf_gsf[model_index].P(0,0);
-	const float P01 = _ekf_gsf[model_index].P(0,1);
-	const float P02 = _ekf_gsf[model_index].P(0,2);
-	const float P11 = _ekf_gsf[model_index].P(1,1);
-	const float P12 = _ekf_gsf[model_index].P(1,2);
-	const float P22 = _ekf_gsf[model_index].P(2,2);
-
-	// optimized auto generated code from SymPy script src/lib/ecl/EKF/python/ekf_derivation/main.py
-	const float t0 = ecl::powf(P01, 2);
-	const float t1 = -t0;
-	const float t2 = P00*P11 + P00*velObsVar + P11*velObsVar + t1 + ecl::powf(velObsVar, 2);
-	if (fabsf(t2) < 1e-6f) {
-		return false;
-	}
-	const float t3 = 1.0F/t2;
-	const float t4 = P11 + velObsVar;
-	const float t5 = P01*t3;
-	const float t6 = -t5;
-	const float t7 = P00 + velObsVar;
-	const float t8 = P00*t4 + t1;
-	const float t9 = t5*velObsVar;
-	const float t10 = P11*t7;
-	const float t11 = t1 + t10;
-	const float t12 = P01*P12;
-	const float t13 = P02*t4;
-	const float t14 = P01*P02;
-	const float t15 = P12*t7;
-	const float t16 = t0*velObsVar;
-	const float t17 = ecl::powf(t2, -2);
-	const float t18 = t4*velObsVar + t8;
-	const float t19 = t17*t18;
-	const float t20 = t17*(t16 + t7*t8);
-	const float t21 = t0 - t10;
-	const float t22 = t17*t21;
-	const float t23 = t14 - t15;
-	const float t24 = P01*t23;
-	const float t25 = t12 - t13;
-	const float t26 = t16 - t21*t4;
-	const float t27 = t17*t26;
-	const float t28 = t11 + t7*velObsVar;
-	const float t30 = t17*t28;
-	const float t31 = P01*t25;
-	const float t32 = t23*t4 + t31;
-	const float t33 = t17*t32;
-	const float t35 = t24 + t25*t7;
-	const float t36 = t17*t35;
-
-	_ekf_gsf[model_index].S_det_inverse = t3;
-
-	_ekf_gsf[model_index].S_inverse(0,0) = t3*t4;
-	_ekf_gsf[model_index].S_inverse(0,1) = t6;
-	_ekf_gsf[model_index].S_inverse(1,1) = t3*t7;
-	_ekf_gsf[model_index].S_inverse(1,0) = _ekf_gsf[model_index].S_inverse(0,1);
-
-	matrix::Matrix<float, 3, 2> K;
-	K(0,0) = t3*t8;
-	K(1,0) = t9;
-	K(2,0) = t3*(-t12 + t13);
-	K(0,1) = t9;
-	K(1,1) = t11*t3;
-	K(2,1) = t3*(-t14 + t15);
-
-	_ekf_gsf[model_index].P(0,0) = P00 - t16*t19 - t20*t8;
-	_ekf_gsf[model_index].P(0,1) = P01*(t18*t22 - t20*velObsVar + 1);
-	_ekf_gsf[model_index].P(1,1) = P11 - t16*t30 + t22*t26;
-	_ekf_gsf[model_index].P(0,2) = P02 + t19*t24 + t20*t25;
-	_ekf_gsf[model_index].P(1,2) = P12 + t23*t27 + t30*t31;
-	_ekf_gsf[model_index].P(2,2) = P22 - t23*t33 - t25*t36;
-	_ekf_gsf[model_index].P(1,0) = _ekf_gsf[model_index].P(0,1);
-	_ekf_gsf[model_index].P(2,0) = _ekf_gsf[model_index].P(0,2);
-	_ekf_gsf[model_index].P(2,1) = _ekf_gsf[model_index].P(1,2);
-
 	// constrain variances
 	const float min_var = 1e-6f;
 
-	for (unsigned index = 0; index < 3; index++) {
-		_ekf_gsf[model_index].P(index, index) = fmaxf(_ekf_gsf[model_index].P(index, index), min_var);
-	}
-
-	// test ratio = transpose(innovation) * inverse(innovation variance) * innovation = [1x2] * [2,2] * [2,1] = [1,1]
-	const float test_ratio = _ekf_gsf[model_index].innov * (_ekf_gsf[model_index].S_inverse * _ekf_gsf[model_index].innov);
+	bool updated[N_MODELS_EKFGSF];
+	float yaw_delta[N_MODELS_EKFGSF];
 
-	// Perform a chi-square innovation consistency test and calculate a compression scale factor
-	// that limits the magnitude of innovations to 5-sigma
-	// If the test ratio is greater than 25 (5 Sigma) then reduce the length of the innovation vector to clip it at 5-Sigma
-	// This protects from large measurement spikes
-	const float innov_comp_scale_factor = test_ratio > 25.f ? sqrtf(25.0f / test_ratio) : 1.f;
-
-	// Correct the state vector and capture the change in yaw angle
-	const float oldYaw = _ekf_gsf[model_index].X(2);
+	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
+		// calculate velocity observation innovations
+		const float innov_VN = _ekf_gsf.vel_N[model_index] - _vel_NE(0);
+		const float innov_VE = _ekf_gsf.vel_E[model_index] - _vel_NE(1);
+		_ekf_gsf.innov_VN[model_index] = innov_VN;
+		_ekf_gsf.innov_VE[model_index] = innov_VE;
+
+		// Use temporary variables for covariance elements to reduce verbosity of auto-code expressions
+		const float P00 = _ekf_gsf.P00[model_index];
+		const float P01 = _ekf_gsf.P01[model_index];
+		const float P02 = _ekf_gsf.P02[model_index];
+		const float P11 = _ekf_gsf.P11[model_index];
+		const float P12 = _ekf_gsf.P12[model_index];
+		const float P22 = _ekf_gsf.P22[model_index];
+
+		// optimized auto generated code from SymPy script src/lib/ecl/EKF/python/ekf_derivation/main.py
+		const float t0 = P01*P01;
+		const float t1 = -t0;
+		const float t2 = P00*P11 + P00*velObsVar + P11*velObsVar + t1 + velObsVar*velObsVar;
+
+		updated[model_index] = fabsf(t2) >= 1e-6f;
+
+		if (!updated[model_index]) {
+			continue;
+		}
 
-	_ekf_gsf[model_index].X -= (K * _ekf_gsf[model_index].innov) * innov_comp_scale_factor;
+		const float t3 = 1.0F/t2;
+		const float t4 = P11 + velObsVar;
+		const float t5 = P01*t3;
+		const float t6 = -t5;
+		const float t7 = P00 + velObsVar;
+		const float t8 = P00*t4 + t1;
+		const float t9 = t5*velObsVar;
+		const float t10 = P11*t7;
+		const float t11 = t1 + t10;
+		const float t12 = P01*P12;
+		const float t13 = P02*t4;
+		const float t14 = P01*P02;
+		const float t15 = P12*t7;
+		const float t16 = t0*velObsVar;
+		const float t17 = 1.0f/(t2*t2);
+		const float t18 = t4*velObsVar + t8;
+		const float t19 = t17*t18;
+		const float t20 = t17*(t16 + t7*t8);
+		const float t21 = t0 - t10;
+		const float t22 = t17*t21;
+		const float t23 = t14 - t15;
+		const float t24 = P01*t23;
+		const float t25 = t12 - t13;
+		const float t26 = t16 - t21*t4;
+		const float t27 = t17*t26;
+		const float t28 = t11 + t7*velObsVar;
+		const float t30 = t17*t28;
+		const float t31 = P01*t25;
+		const float t32 = t23*t4 + t31;
+		const float t33 = t17*t32;
+		const float t35 = t24 + t25*t7;
+		const float t36 = t17*t35;
+
+		_ekf_gsf.S_det_inverse[model_index] = t3;
+
+		const float S_inv00 = t3*t4;
+		const float S_inv01 = t6;
+		const float S_inv11 = t3*t7;
+		_ekf_gsf.S_inv00[model_index] = S_inv00;
+		_ekf_gsf.S_inv01[model_index] = S_inv01;
+		_ekf_gsf.S_inv11[model_index] = S_inv11;
+
+		const float K00 = t3*t8;
+		const float K10 = t9;
+		const float K20 = t3*(-t12 + t13);
+		const float K01 = t9;
+		const float K11 = t11*t3;
+		const float K21 = t3*(-t14 + t15);
+
+		_ekf_gsf.P00[model_index] = fmaxf(P00 - t16*t19 - t20*t8, min_var);
+		_ekf_gsf.P01[model_index] = P01*(t18*t22 - t20*velObsVar + 1);
+		_ekf_gsf.P11[model_index] = fmaxf(P11 - t16*t30 + t22*t26, min_var);
+		_ekf_gsf.P02[model_index] = P02 + t19*t24 + t20*t25;
+		_ekf_gsf.P12[model_index] = P12 + t23*t27 + t30*t31;
+		_ekf_gsf.P22[model_index] = fmaxf(P22 - t23*t33 - t25*t36, min_var);
+
+		// test ratio = transpose(innovation) * inverse(innovation variance) * innovation = [1x2] * [2,2] * [2,1] = [1,1]
+		const float test_ratio = innov_VN * (S_inv00 * innov_VN + S_inv01 * innov_VE)
+					 + innov_VE * (S_inv01 * innov_VN + S_inv11 * innov_VE);
+
+		// Perform a chi-square innovation consistency test and calculate a compression scale factor
+		// that limits the magnitude of innovations to 5-sigma
+		// If the test ratio is greater than 25 (5 Sigma) then reduce the length of the innovation vector to clip it at 5-Sigma
+		// This protects from large measurement spikes
+		const float innov_comp_scale_factor = test_ratio > 25.f ? sqrtf(25.0f / test_ratio) : 1.f;
+
+		// Correct the state vector and capture the change in yaw angle
+		const float oldYaw = _ekf_gsf.yaw[model_index];
+
+		_ekf_gsf.vel_N[model_index] -= (K00 * innov_VN + K01 * innov_VE) * innov_comp_scale_factor;
+		_ekf_gsf.vel_E[model_index] -= (K10 * innov_VN + K11 * innov_VE) * innov_comp_scale_factor;
+		_ekf_gsf.yaw[model_index] -= (K20 * innov_VN + K21 * innov_VE) * innov_comp_scale_factor;
+
+		yaw_delta[model_index] = _ekf_gsf.yaw[model_index] - oldYaw;
+	}
 
-	const float yawDelta = _ekf_gsf[model_index].X(2) - oldYaw;
+	bool update_ok = true;
 
-	// apply the change in yaw angle to the AHRS
-	// take advantage of sparseness in the yaw rotation matrix
-	const float cosYaw = cosf(yawDelta);
-	const float sinYaw = sinf(yawDelta);
-	const float R_prev00 = _ahrs_ekf_gsf[model_index].R(0, 0);
-	const float R_prev01 = _ahrs_ekf_gsf[model_index].R(0, 1);
-	const float R_prev02 = _ahrs_ekf_gsf[model_index].R(0, 2);
+	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index ++) {
+		if (!updated[model_index]) {
+			update_ok = false;
+			continue;
+		}
 
-	_ahrs_ekf_gsf[model_index].R(0, 0) = R_prev00 * cosYaw - _ahrs_ekf_gsf[model_index].R(1, 0) * sinYaw;
-	_ahrs_ekf_gsf[model_index].R(0, 1) = R_prev01 * cosYaw - _ahrs_ekf_gsf[model_index].R(1, 1) * sinYaw;
-	_ahrs_ekf_gsf[model_index].R(0, 2) = R_prev02 * cosYaw - _ahrs_ekf_gsf[model_index].R(1, 2) * sinYaw;
-	_ahrs_ekf_gsf[model_index].R(1, 0) = R_prev00 * sinYaw + _ahrs_ekf_gsf[model_index].R(1, 0) * cosYaw;
-	_ahrs_ekf_gsf[model_index].R(1, 1) = R_prev01 * sinYaw + _ahrs_ekf_gsf[model_index].R(1, 1) * cosYaw;
-	_ahrs_ekf_gsf[model_index].R(1, 2) = R_prev02 * sinYaw + _ahrs_ekf_gsf[model_index].R(1, 2) * cosYaw;
+		// apply the change in yaw angle to the AHRS
+		// take advantage of sparseness in the yaw rotation matrix
+		Dcmf &R = _ahrs_ekf_gsf[model_index].R;
+		const float cosYaw = cosf(yaw_delta[model_index]);
+		const float sinYaw = sinf(yaw_delta[model_index]);
+		const float R_prev00 = R(0, 0);
+		const float R_prev01 = R(0, 1);
+		const float R_prev02 = R(0, 2);
+
+		R(0, 0) = R_prev00 * cosYaw - R(1, 0) * sinYaw;
+		R(0, 1) = R_prev01 * cosYaw - R(1, 1) * sinYaw;
+		R(0, 2) = R_prev02 * cosYaw - R(1, 2) * sinYaw;
+		R(1, 0) = R_prev00 * sinYaw + R(1, 0) * cosYaw;
+		R(1, 1) = R_prev01 * sinYaw + R(1, 1) * cosYaw;
+		R(1, 2) = R_prev02 * sinYaw + R(1, 2) * cosYaw;
+	}
 
-	return true;
+	return update_ok;
 }
 
 void EKFGSF_yaw::initialiseEKFGSF()
@@ -474,25 +504,29 @@ void EKFGSF_yaw::initialiseEKFGSF()
 
 	for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index++) {
 		// evenly space initial yaw estimates in the region between +-Pi
-		_ekf_gsf[model_index].X(2) = -_m_pi + (0.5f * yaw_increment) + ((float)model_index * yaw_increment);
+		_ekf_gsf.yaw[model_index] = -_m_pi + (0.5f * yaw_increment) + ((float)model_index * yaw_increment);
 
 		// take velocity states and corresponding variance from last measurement
-		_ekf_gsf[model_index].X(0) = _vel_NE(0);
-		_ekf_gsf[model_index].X(1) = _vel_NE(1);
-		_ekf_gsf[model_index].P(0, 0) = sq(_vel_accuracy);
-		_ekf_gsf[model_index].P(1, 1) = _ekf_gsf[model_index].P(0, 0);
+		_ekf_gsf.vel_N[model_index] = _vel_NE(0);
+		_ekf_gsf.vel_E[model_index] = _vel_NE(1);
+		_ekf_gsf.P00[model_index] = sq(_vel_accuracy);
+		_ekf_gsf.P11[model_index] = _ekf_gsf.P00[model_index];
 
 		// use half yaw interval for yaw uncertainty
-		_ekf_gsf[model_index].P(2, 2) = sq(0.5f * yaw_increment);
+		_ekf_gsf.P22[model_index] = sq(0.5f * yaw_increment);
 	}
 }
 
 float EKFGSF_yaw::gaussianDensity(const uint8_t model_index) const
 {
+	const float innov_VN = _ekf_gsf.innov_VN[model_index];
+	const float innov_VE = _ekf_gsf.innov_VE[model_index];
+
 	// calculate transpose(innovation) * inv(S) * innovation
-	const float normDist = _ekf_gsf[model_index].innov.dot(_ekf_gsf[model_index].S_inverse * _ekf_gsf[model_index].innov);
+	const float normDist = innov_VN * (_ekf_gsf.S_inv00[model_index] * innov_VN + _ekf_gsf.S_inv01[model_index] * innov_VE)
+			       + innov_VE * (_ekf_gsf.S_inv01[model_index] * innov_VN + _ekf_gsf.S_inv11[model_index] * innov_VE);
 
-	return _m_2pi_inv * sqrtf(_ekf_gsf[model_index].S_det_inverse) * expf(-0.5f * normDist);
+	return _m_2pi_inv * sqrtf(_ekf_gsf.S_det_inverse[model_index]) * expf(-0.5f * normDist);
 }
 
 bool EKFGSF_yaw::getLogData(float *yaw_composite, float *yaw_variance, float yaw[N_MODELS_EKFGSF],
@@ -503,9 +537,9 @@ bool EKFGSF_yaw::getLogData(float *yaw_composite, float *yaw_variance, float yaw
 		*yaw_variance = _gsf_yaw_variance;
 
 		for (uint8_t model_index = 0; model_index < N_MODELS_EKFGSF; model_index++) {
-			yaw[model_index] = _ekf_gsf[model_index].X(2);
-			innov_VN[model_index] = _ekf_gsf[model_index].innov(0);
-			innov_VE[model_index] = _ekf_gsf[model_index].innov(1);
+			yaw[model_index] = _ekf_gsf.yaw[model_index];
+			innov_VN[model_index] = _ekf_gsf.innov_VN[model_index];
+			innov_VE[model_index] = _ekf_gsf.innov_VE[model_index];
 			weight[model_index] = _model_weights(model_index);
 		}
 
@@ -568,3 +602,8 @@ void EKFGSF_yaw::setVelocity(const Vector2f &velocity, float accuracy)
 	_vel_accuracy = accuracy;
 	_vel_data_updated = true;
 }
+
+void EKFGSF_yaw::setDecimation(uint8_t decimation)
+{
+	_decimation = math::max(decimation, (uint8_t)1);
+}
@@ -81,6 +81,11 @@ public:
 			float innov_VE[N_MODELS_EKFGSF],
 			float weight[N_MODELS_EKFGSF]) const;
 
+	// Run the bank of filters once every 'decimation' IMU samples using accumulated IMU data.
+	// This is intended for use while the main filter yaw is trusted and must be set back to 1 as soon as
+	// it is not. Pending IMU data is processed on the next update, so the bank restarts warm.
+	void setDecimation(uint8_t decimation);
+
 	bool isActive() const { return _ekf_gsf_vel_fuse_started; }
 	float getYaw() const { return _gsf_yaw; }
 	float getYawVar() const { return _gsf_yaw_variance; }
@@ -99,8 +104,13 @@ private:
 	Vector3f _delta_vel{};	// IMU delta velocity (m/s)
 	float _delta_ang_dt{};	// _delta_ang integration time interval (sec)
 	float _delta_vel_dt{};	// _delta_vel integration time interval (sec)
+	float _delta_vel_var{};	// horizontal delta velocity process noise variance accumulated over _delta_vel_dt ((m/s)^2)
+	float _delta_ang_var{};	// yaw delta angle process noise variance accumulated over _delta_ang_dt (rad^2)
 	float _true_airspeed{};	// true airspeed used for centripetal accel compensation (m/s)
 
+	uint8_t _decimation{1};		// number of IMU samples accumulated before the bank of filters is updated
+	uint8_t _imu_sample_count{0};	// number of IMU samples accumulated since the last bank update
+
 	struct _ahrs_ekf_gsf_struct {
 		Dcmf R;			// matrix that rotates a vector from body to earth frame
 		Vector3f gyro_bias;	// gyro bias learned and used by the quaternion calculation
@@ -131,14 +141,26 @@ private:
 	Matrix3f ahrsPredictRotMat(const Matrix3f &R, const Vector3f &g);
 
 	// Declarations used by a bank of N_MODELS_EKFGSF EKFs
+	// The bank is stored as a structure of arrays so that the per model arithmetic can be done
+	// in loops across all models which the compiler is able to vectorize.
 
 	struct _ekf_gsf_struct {
-		matrix::Vector3f X; 				// Vel North (m/s),  Vel East (m/s), yaw (rad)s
-		matrix::SquareMatrix<float, 3> P; 		// covariance matrix
-		matrix::SquareMatrix<float, 2> S_inverse;	// inverse of the innovation covariance matrix
-		float S_det_inverse; 				// inverse of the innovation covariance matrix determinant
-		matrix::Vector2f innov; 			// Velocity N,E innovation (m/s)
-	} _ekf_gsf[N_MODELS_EKFGSF] {};
+		float vel_N[N_MODELS_EKFGSF];		// Vel North (m/s)
+		float vel_E[N_MODELS_EKFGSF];		// Vel East (m/s)
+		float yaw[N_MODELS_EKFGSF];		// yaw (rad)
+		float P00[N_MODELS_EKFGSF];		// covariance matrix elements
+		float P01[N_MODELS_EKFGSF];
+		float P02[N_MODELS_EKFGSF];
+		float P11[N_MODELS_EKFGSF];
+		float P12[N_MODELS_EKFGSF];
+		float P22[N_MODELS_EKFGSF];
+		float S_inv00[N_MODELS_EKFGSF];		// inverse of the innovation covariance matrix elements
+		float S_inv01[N_MODELS_EKFGSF];
+		float S_inv11[N_MODELS_EKFGSF];
+		float S_det_inverse[N_MODELS_EKFGSF];	// inverse of the innovation covariance matrix determinant
+		float innov_VN[N_MODELS_EKFGSF];	// Velocity N innovation (m/s)
+		float innov_VE[N_MODELS_EKFGSF];	// Velocity E innovation (m/s)
+	} _ekf_gsf{};
 
 	bool _vel_data_updated{};	// true when velocity data has been updated
 	Vector2f _vel_NE{};        // NE velocity observations (m/s)
@@ -148,12 +170,12 @@ private:
 	// initialise states and covariance data for the GSF and EKF filters
 	void initialiseEKFGSF();
 
-	// predict state and covariance for the specified EKF using inertial data
-	void predictEKF(const uint8_t model_index);
+	// predict state and covariance for all EKFs using inertial data
+	void predictEKFBank();
 
-	// update state and covariance for the specified EKF using a NE velocity measurement
-	// return false if update failed
-	bool updateEKF(const uint8_t model_index);
+	// update state and covariance for all EKFs using a NE velocity measurement
+	// return false if the update failed for any of the models
+	bool updateEKFBank();
 
 	inline float sq(float x) const { return x * x; };
 
@@ -126,6 +126,11 @@ enum RngCtrl : uint8_t {
 	ENABLED     = 2
 };
 
+enum class CovarianceMaintenance : uint8_t {
+	FULL        = 0,	///< constrain variances and force symmetry of all active states after every measurement update
+	INCREMENTAL = 1		///< constrain variances after every measurement update, only make the touched blocks symmetric once per filter update
+};
+
 enum SensorFusionMask : uint16_t {
 	// Bit locations for fusion_mode
 	DEPRECATED_USE_GPS = (1<<0),    ///< set to true to use GPS data (DEPRECATED, use gnss_ctrl)
@@ -425,12 +430,17 @@ struct parameters {
 	const float auxvel_noise{0.5f};         ///< minimum observation noise, uses reported noise if greater (m/s)
 	const float auxvel_gate{5.0f};          ///< velocity fusion innovation consistency gate size (STD)
 
+	// covariance matrix maintenance
+	int32_t cov_maintenance{0};             ///< covariance maintenance mode after measurement updates (see CovarianceMaintenance)
+	int32_t cov_sweep_interval{100};        ///< number of filter updates between full covariance sweeps in incremental mode (0 to disable)
+
 	// compute synthetic magnetomter Z value if possible
 	int32_t synthesize_mag_z{0};
 	int32_t check_mag_strength{0};
 
 	// Parameters used to control when yaw is reset to the EKF-GSF yaw estimator value
 	float EKFGSF_tas_default{15.0f};                ///< default airspeed value assumed during fixed wing flight if no airspeed measurement available (m/s)
+	int32_t EKFGSF_decimation{1};                   ///< number of IMU samples per EKF-GSF update while the main filter yaw is trusted
 	const unsigned EKFGSF_reset_delay{1000000};     ///< Number of uSec of bad innovations on main filter in immediate post-takeoff phase before yaw is reset to EKF-GSF value
 	const float EKFGSF_yaw_err_max{0.262f};         ///< Composite yaw 1-sigma uncertainty threshold used to check for convergence (rad)
 	const unsigned EKFGSF_reset_count_limit{3};     ///< Maximum number of times the yaw can be reset to the EKF-GSF yaw estimator value
@@ -45,6 +45,8 @@
 
 void Ekf::controlFusionModes()
 {
+	ECL_STAGE_TIMER(ControlFusionModes);
+
 	// Store the status to enable change detection
 	_control_status_prev.value = _control_status.value;
 
@@ -186,6 +188,8 @@ void Ekf::controlFusionModes()
 
 void Ekf::controlExternalVisionFusion()
 {
+	ECL_STAGE_TIMER(ExternalVisionFusion);
+
 	// Check for new external vision data
 	if (_ev_data_ready) {
 
@@ -392,6 +396,8 @@ void Ekf::controlExternalVisionFusion()
 
 void Ekf::controlOpticalFlowFusion()
 {
+	ECL_STAGE_TIMER(OpticalFlowFusion);
+
 	// Check if on ground motion is un-suitable for use of optical flow
 	if (!_control_status.flags.in_air) {
 		updateOnGroundMotionForOpticalFlowChecks();
@@ -642,6 +648,8 @@ void Ekf::controlGpsYawFusion(const gpsSample &gps_sample, bool gps_checks_passi
 
 void Ekf::controlAirDataFusion()
 {
+	ECL_STAGE_TIMER(AirDataFusion);
+
 	// control activation and initialisation/reset of wind states required for airspeed fusion
 
 	// If both airspeed and sideslip fusion have timed out and we are not using a drag observation model then we no longer have valid wind estimates
@@ -696,6 +704,8 @@ void Ekf::controlAirDataFusion()
 
 void Ekf::controlBetaFusion()
 {
+	ECL_STAGE_TIMER(BetaFusion);
+
 	if (_control_status.flags.fake_pos) {
 		return;
 	}
@@ -721,6 +731,8 @@ void Ekf::controlBetaFusion()
 
 void Ekf::controlDragFusion()
 {
+	ECL_STAGE_TIMER(DragFusion);
+
 	if ((_params.fusion_mode & SensorFusionMask::USE_DRAG) && _drag_buffer &&
 	    !_control_status.flags.fake_pos && _control_status.flags.in_air && !_mag_inhibit_yaw_reset_req) {
 
@@ -742,6 +754,8 @@ void Ekf::controlDragFusion()
 
 void Ekf::controlAuxVelFusion()
 {
+	ECL_STAGE_TIMER(AuxVelFusion);
+
 	if (_auxvel_buffer) {
 		auxVelSample auxvel_sample_delayed;
 
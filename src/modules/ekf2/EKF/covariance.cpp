@@ -99,6 +99,8 @@ void Ekf::initialiseCovariance()
 
 void Ekf::predictCovariance()
 {
+	ECL_STAGE_TIMER(PredictCovariance);
+
 	// assign intermediate state variables
 	const float q0 = _state.quat_nominal(0);
 	const float q1 = _state.quat_nominal(1);
@@ -941,11 +943,6 @@ void Ekf::fixCovarianceErrors(bool force_symmetry)
 		P(i, i) = math::constrain(P(i, i), 0.0f, P_lim[3]);
 	}
 
-	// force symmetry on the quaternion, velocity and position state covariances
-	if (force_symmetry) {
-		P.makeRowColSymmetric<13>(0);
-	}
-
 	// the following states are optional and are deactivated when not required
 	// by ensuring the corresponding covariance matrix values are kept at zero
 
@@ -1035,10 +1032,6 @@ void Ekf::fixCovarianceErrors(bool force_symmetry)
 			_fault_status.flags.bad_acc_bias = false;
 			_warning_events.flags.invalid_accel_bias_cov_reset = true;
 			ECL_WARN("invalid accel bias - covariance reset");
-
-		} else if (force_symmetry) {
-			// ensure the covariance values are symmetrical
-			P.makeRowColSymmetric<3>(13);
 		}
 
 	}
@@ -1056,13 +1049,6 @@ void Ekf::fixCovarianceErrors(bool force_symmetry)
 		for (int i = 19; i <= 21; i++) {
 			P(i, i) = math::constrain(P(i, i), 0.0f, P_lim[6]);
 		}
-
-		// force symmetry
-		if (force_symmetry) {
-			P.makeRowColSymmetric<3>(16);
-			P.makeRowColSymmetric<3>(19);
-		}
-
 	}
 
 	// wind velocity states
@@ -1074,27 +1060,121 @@ void Ekf::fixCovarianceErrors(bool force_symmetry)
 		for (int i = 22; i <= 23; i++) {
 			P(i, i) = math::constrain(P(i, i), 0.0f, P_lim[7]);
 		}
+	}
+
+	// force symmetry on the covariances of all active states
+	if (force_symmetry) {
+		makeCovarianceBlocksSymmetric(COV_BLOCK_ALL);
+	}
+}
+
+void Ekf::makeCovarianceBlocksSymmetric(uint8_t blocks)
+{
+	// quaternion, velocity, position and delta angle bias states
+	if (blocks & COV_BLOCK_NAV) {
+		P.makeRowColSymmetric<13>(0);
+	}
+
+	// the optional states are kept at zero when deactivated, they are symmetric by construction
+	if ((blocks & COV_BLOCK_DVEL_BIAS)
+	    && (!_accel_bias_inhibit[0] || !_accel_bias_inhibit[1] || !_accel_bias_inhibit[2])) {
+		P.makeRowColSymmetric<3>(13);
+	}
+
+	if (_control_status.flags.mag_3D) {
+		if (blocks & COV_BLOCK_MAG_I) {
+			P.makeRowColSymmetric<3>(16);
+		}
 
-		// force symmetry
-		if (force_symmetry) {
-			P.makeRowColSymmetric<2>(22);
+		if (blocks & COV_BLOCK_MAG_B) {
+			P.makeRowColSymmetric<3>(19);
 		}
 	}
+
+	if ((blocks & COV_BLOCK_WIND) && _control_status.flags.wind) {
+		P.makeRowColSymmetric<2>(22);
+	}
+}
+
+void Ekf::maintainCovarianceAfterFusion(const Vector24f &K)
+{
+	if (_params.cov_maintenance != static_cast<int32_t>(CovarianceMaintenance::INCREMENTAL)) {
+		fixCovarianceErrors(true);
+		return;
+	}
+
+	// a correction K*H*P can only make the pairs (i, j) and (j, i) unequal if K(i) or K(j) is non-zero,
+	// so making the rows and columns of the states with a non-zero gain symmetric is sufficient
+	static constexpr uint8_t block_of_state[_k_num_states] {
+		COV_BLOCK_NAV, COV_BLOCK_NAV, COV_BLOCK_NAV, COV_BLOCK_NAV, COV_BLOCK_NAV, COV_BLOCK_NAV, COV_BLOCK_NAV,
+		COV_BLOCK_NAV, COV_BLOCK_NAV, COV_BLOCK_NAV, COV_BLOCK_NAV, COV_BLOCK_NAV, COV_BLOCK_NAV,
+		COV_BLOCK_DVEL_BIAS, COV_BLOCK_DVEL_BIAS, COV_BLOCK_DVEL_BIAS,
+		COV_BLOCK_MAG_I, COV_BLOCK_MAG_I, COV_BLOCK_MAG_I,
+		COV_BLOCK_MAG_B, COV_BLOCK_MAG_B, COV_BLOCK_MAG_B,
+		COV_BLOCK_WIND, COV_BLOCK_WIND
+	};
+
+	for (unsigned i = 0; i < _k_num_states; i++) {
+		if (fabsf(K(i)) > 0.f) {
+			_cov_blocks_touched |= block_of_state[i];
+		}
+	}
+
+	// the variances still need to be constrained immediately as they are used by the next fusion step
+	fixCovarianceErrors(false);
 }
 
-// if the covariance correction will result in a negative variance, then
-// the covariance matrix is unhealthy and must be corrected
-bool Ekf::checkAndFixCovarianceUpdate(const SquareMatrix24f &KHP)
+void Ekf::maintainTouchedCovariances()
 {
+	if (_params.cov_maintenance != static_cast<int32_t>(CovarianceMaintenance::INCREMENTAL)) {
+		_cov_blocks_touched = 0;
+		_cov_updates_since_sweep = 0;
+		return;
+	}
+
+	_cov_updates_since_sweep++;
+
+	if ((_params.cov_sweep_interval > 0) && (_cov_updates_since_sweep >= _params.cov_sweep_interval)) {
+		// periodic full sweep over the whole matrix
+		fixCovarianceErrors(true);
+		_cov_updates_since_sweep = 0;
+
+	} else if (_cov_blocks_touched != 0) {
+		makeCovarianceBlocksSymmetric(_cov_blocks_touched);
+	}
+
+	_cov_blocks_touched = 0;
+}
+
+bool Ekf::applyCovarianceCorrection(const Vector24f &K, const Vector24f &HP)
+{
+	// if the covariance correction will result in a negative variance, then
+	// the covariance matrix is unhealthy and must be corrected
 	bool healthy = true;
 
 	for (int i = 0; i < _k_num_states; i++) {
-		if (P(i, i) < KHP(i, i)) {
+		if (P(i, i) < K(i) * HP(i)) {
 			P.uncorrelateCovarianceSetVariance<1>(i, 0.0f);
 			healthy = false;
 		}
 	}
 
+	if (healthy) {
+		// the correction is applied row by row without forming the 24x24 KHP matrix,
+		// the inner loop is contiguous in memory and independent per element so that the
+		// compiler can vectorize it while computing exactly the same products as K * HP
+		float HP_array[_k_num_states];
+		HP.copyTo(HP_array);
+
+		for (unsigned row = 0; row < _k_num_states; row++) {
+			const float K_row = K(row);
+
+			for (unsigned col = 0; col < _k_num_states; col++) {
+				P(row, col) -= K_row * HP_array[col];
+			}
+		}
+	}
+
 	return healthy;
 }
 
@@ -85,11 +85,16 @@ void Ekf::reset()
 
 	_prev_dvel_bias_var.zero();
 
+	_cov_blocks_touched = 0;
+	_cov_updates_since_sweep = 0;
+
 	resetGpsDriftCheckFilters();
 }
 
 bool Ekf::update()
 {
+	ECL_STAGE_TIMER(Update);
+
 	bool updated = false;
 
 	if (!_filter_initialised) {
@@ -109,6 +114,9 @@ bool Ekf::update()
 		// control fusion of observation data
 		controlFusionModes();
 
+		// make the covariances touched by the fusion steps symmetric (incremental maintenance only)
+		maintainTouchedCovariances();
+
 		// run a separate filter for terrain estimation
 		runTerrainEstimator();
 
@@ -238,6 +246,8 @@ bool Ekf::initialiseTilt()
 
 void Ekf::predictState()
 {
+	ECL_STAGE_TIMER(PredictState);
+
 	// apply imu bias corrections
 	const Vector3f delta_ang_bias_scaled = (_state.delta_ang_bias / _dt_ekf_avg) * _imu_sample_delayed.delta_ang_dt;
 	Vector3f corrected_delta_ang = _imu_sample_delayed.delta_ang - delta_ang_bias_scaled;
@@ -303,6 +313,8 @@ void Ekf::predictState()
 */
 void Ekf::calculateOutputStates(const imuSample &imu)
 {
+	ECL_STAGE_TIMER(OutputPredictor);
+
 	// Use full rate IMU data at the current time horizon
 
 	// correct delta angles for bias offsets
@@ -48,7 +48,9 @@
 #include "EKFGSF_yaw.h"
 #include "bias_estimator.hpp"
 #include "height_bias_estimator.hpp"
+#include "stage_timing.hpp"
 
+#include <lib/world_magnetic_model/geo_mag_declination.h>
 #include <uORB/topics/estimator_aid_source_1d.h>
 #include <uORB/topics/estimator_aid_source_2d.h>
 #include <uORB/topics/estimator_aid_source_3d.h>
@@ -422,6 +424,11 @@ public:
 
 	const auto &aid_src_aux_vel() const { return _aid_src_aux_vel; }
 
+#if defined(ECL_EKF_STAGE_TIMING)
+	const estimator::StageTimings &getStageTimings() const { return _stage_timings; }
+	void resetStageTimings() { _stage_timings.reset(); }
+#endif // ECL_EKF_STAGE_TIMING
+
 private:
 
 	// set the internal states and status to their default value
@@ -587,6 +594,8 @@ private:
 	// Variables used to publish the WGS-84 location of the EKF local NED origin
 	float _gps_alt_ref{NAN};		///< WGS-84 height (m)
 
+	GeoMagTile _geo_mag_tile{};		///< world magnetic model tile for the last GPS position
+
 	// Variables used by the initial filter alignment
 	bool _is_first_imu_sample{true};
 	uint32_t _baro_counter{0};		///< number of baro samples read during initialisation
@@ -627,6 +636,23 @@ private:
 	bool _baro_hgt_faulty{false};		///< true if baro data have been declared faulty TODO: move to fault flags
 	bool _gps_intermittent{true};           ///< true if data into the buffer is intermittent
 
+	// covariance blocks tracked for incremental covariance maintenance
+	enum CovarianceBlock : uint8_t {
+		COV_BLOCK_NAV       = (1 << 0), ///< quaternion, velocity, position and delta angle bias (0..12)
+		COV_BLOCK_DVEL_BIAS = (1 << 1), ///< delta velocity bias (13..15)
+		COV_BLOCK_MAG_I     = (1 << 2), ///< earth magnetic field (16..18)
+		COV_BLOCK_MAG_B     = (1 << 3), ///< body magnetic field (19..21)
+		COV_BLOCK_WIND      = (1 << 4), ///< wind velocity (22..23)
+		COV_BLOCK_ALL       = 0x1F
+	};
+
+	uint8_t _cov_blocks_touched{0};		///< covariance blocks modified by measurement updates since the last maintenance
+	uint16_t _cov_updates_since_sweep{0};	///< number of filter updates since the last full covariance sweep
+
+#if defined(ECL_EKF_STAGE_TIMING)
+	estimator::StageTimings _stage_timings {};	///< per-stage execution time accounting (benchmark builds only)
+#endif // ECL_EKF_STAGE_TIMING
+
 	// imu fault status
 	uint64_t _time_bad_vert_accel{0};	///< last time a bad vertical accel was detected (uSec)
 	uint64_t _time_good_vert_accel{0};	///< last time a good vertical accel was detected (uSec)
@@ -805,29 +831,21 @@ private:
 
 	Vector3f getVisionVelocityVarianceInEkfFrame() const;
 
-	// matrix vector multiplication for computing K<24,1> * H<1,24> * P<24,24>
+	// matrix vector multiplication for computing H<1,24> * P<24,24>
 	// that is optimized by exploring the sparsity in H
 	template <size_t ...Idxs>
-	SquareMatrix24f computeKHP(const Vector24f &K, const SparseVector24f<Idxs...> &H) const
+	Vector24f computeHP(const SparseVector24f<Idxs...> &H) const
 	{
-		// K(HP) and (KH)P are equivalent (matrix multiplication is associative)
-		// but K(HP) is computationally much less expensive
-		Vector24f HP;
+		// accumulate in a plain array, the inner loop can then be vectorized by the compiler
+		float HP[_k_num_states] {};
 		for (unsigned i = 0; i < H.non_zeros(); i++) {
 			const size_t row = H.index(i);
 			for (unsigned col = 0; col < _k_num_states; col++) {
-				HP(col) = HP(col) + H.atCompressedIndex(i) * P(row, col);
+				HP[col] = HP[col] + H.atCompressedIndex(i) * P(row, col);
 			}
 		}
 
-		SquareMatrix24f KHP;
-		for (unsigned row = 0; row < _k_num_states; row++) {
-			for (unsigned col = 0; col < _k_num_states; col++) {
-				KHP(row, col) = K(row) * HP(col);
-			}
-		}
-
-		return KHP;
+		return Vector24f(HP);
 	}
 
 	// measurement update with a single measurement
@@ -842,17 +860,12 @@ private:
 		}
 
 		// apply covariance correction via P_new = (I -K*H)*P
-		// first calculate expression for KHP
-		// then calculate P - KHP
-		const SquareMatrix24f KHP = computeKHP(K, H);
-
-		const bool is_healthy = checkAndFixCovarianceUpdate(KHP);
+		// K(HP) and (KH)P are equivalent (matrix multiplication is associative)
+		// but K(HP) is computationally much less expensive
+		const bool is_healthy = applyCovarianceCorrection(K, computeHP(H));
 
 		if (is_healthy) {
-			// apply the covariance corrections
-			P -= KHP;
-
-			fixCovarianceErrors(true);
+			maintainCovarianceAfterFusion(K);
 
 			// apply the state corrections
 			fuse(K, innovation);
@@ -861,14 +874,26 @@ private:
 		return is_healthy;
 	}
 
-	// if the covariance correction will result in a negative variance, then
-	// the covariance matrix is unhealthy and must be corrected
-	bool checkAndFixCovarianceUpdate(const SquareMatrix24f &KHP);
+	// apply the covariance correction P_new = P - K*HP, where HP = H*P
+	// returns false and does not apply the correction if it would result in a negative variance,
+	// the covariance matrix is then unhealthy and the offending states are decorrelated
+	bool applyCovarianceCorrection(const Vector24f &K, const Vector24f &HP);
 
 	// limit the diagonal of the covariance matrix
 	// force symmetry when the argument is true
 	void fixCovarianceErrors(bool force_symmetry);
 
+	// covariance maintenance after a measurement update with the kalman gain K
+	// in incremental mode only the variances are constrained and the blocks touched by K are recorded
+	void maintainCovarianceAfterFusion(const Vector24f &K);
+
+	// make the covariance blocks touched since the last call symmetric (incremental mode only)
+	// and periodically run a full sweep of the covariance matrix
+	void maintainTouchedCovariances();
+
+	// force symmetry on the rows and columns of the selected and active covariance blocks
+	void makeCovarianceBlocksSymmetric(uint8_t blocks);
+
 	// constrain the ekf states
 	void constrainStates();
 
@@ -1680,6 +1680,8 @@ bool Ekf::getDataEKFGSF(float *yaw_composite, float *yaw_variance, float yaw[N_M
 
 void Ekf::runYawEKFGSF()
 {
+	ECL_STAGE_TIMER(YawEstimator);
+
 	float TAS = 0.f;
 
 	if (_control_status.flags.fixed_wing) {
@@ -1691,6 +1693,15 @@ void Ekf::runYawEKFGSF()
 		}
 	}
 
+	// the emergency yaw estimator can run at a reduced rate while the main filter yaw is aided
+	// and consistent with it, and is returned to full rate as soon as this is no longer the case
+	const bool is_yaw_trusted = _control_status.flags.yaw_align
+				    && (_control_status.flags.mag_hdg || _control_status.flags.mag_3D
+					|| _control_status.flags.gps_yaw || _control_status.flags.ev_yaw)
+				    && !isYawFailure();
+
+	_yawEstimator.setDecimation(is_yaw_trusted ? (uint8_t)math::constrain(_params.EKFGSF_decimation, (int32_t)1, (int32_t)10) : 1);
+
 	const Vector3f imu_gyro_bias = getGyroBias();
 	_yawEstimator.update(_imu_sample_delayed, _control_status.flags.in_air, TAS, imu_gyro_bias);
 }
@@ -40,6 +40,8 @@
 
 void Ekf::controlFakeHgtFusion()
 {
+	ECL_STAGE_TIMER(FakeHgtFusion);
+
 	auto &fake_hgt = _aid_src_fake_hgt;
 
 	// clear
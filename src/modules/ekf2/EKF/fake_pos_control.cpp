@@ -40,6 +40,8 @@
 
 void Ekf::controlFakePosFusion()
 {
+	ECL_STAGE_TIMER(FakePosFusion);
+
 	auto &fake_pos = _aid_src_fake_pos;
 
 	// clear
@@ -89,9 +89,10 @@ bool Ekf::collect_gps(const gpsMessage &gps)
 		const bool declination_was_valid = PX4_ISFINITE(_mag_declination_gps);
 
 		// set the magnetic field data returned by the geo library using the current GPS position
-		_mag_declination_gps = get_mag_declination_radians(lat, lon);
-		_mag_inclination_gps = get_mag_inclination_radians(lat, lon);
-		_mag_strength_gps = get_mag_strength_gauss(lat, lon);
+		const GeoMagTile::Field mag_field = _geo_mag_tile.lookup(lat, lon);
+		_mag_declination_gps = mag_field.declination;
+		_mag_inclination_gps = mag_field.inclination;
+		_mag_strength_gps = mag_field.strength;
 
 		// request a reset of the yaw using the new declination
 		if ((_params.mag_fusion_type != MagFuseType::NONE)
@@ -117,9 +118,10 @@ bool Ekf::collect_gps(const gpsMessage &gps)
 			const double lon = gps.lon * 1.0e-7;
 
 			// set the magnetic field data returned by the geo library using the current GPS position
-			_mag_declination_gps = get_mag_declination_radians(lat, lon);
-			_mag_inclination_gps = get_mag_inclination_radians(lat, lon);
-			_mag_strength_gps = get_mag_strength_gauss(lat, lon);
+			const GeoMagTile::Field mag_field = _geo_mag_tile.lookup(lat, lon);
+			_mag_declination_gps = mag_field.declination;
+			_mag_inclination_gps = mag_field.inclination;
+			_mag_strength_gps = mag_field.strength;
 
 			// request mag yaw reset if there's a mag declination for the first time
 			if (_params.mag_fusion_type != MagFuseType::NONE) {
@@ -41,6 +41,8 @@
 
 void Ekf::controlGpsFusion()
 {
+	ECL_STAGE_TIMER(GpsFusion);
+
 	if (!((_params.gnss_ctrl & GnssCtrl::HPOS) || (_params.gnss_ctrl & GnssCtrl::VEL))) {
 		stopGpsFusion();
 		return;
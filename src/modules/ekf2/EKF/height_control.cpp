@@ -39,6 +39,8 @@
 
 void Ekf::controlHeightFusion()
 {
+	ECL_STAGE_TIMER(HeightFusion);
+
 	checkVerticalAccelerationHealth();
 
 	updateGroundEffect();
@@ -41,6 +41,8 @@
 
 void Ekf::controlMagFusion()
 {
+	ECL_STAGE_TIMER(MagFusion);
+
 	bool mag_data_ready = false;
 
 	magSample mag_sample;
@@ -638,36 +638,18 @@ bool Ekf::fuseYaw(const float innovation, const float variance, estimator_aid_so
 	}
 
 	// apply covariance correction via P_new = (I -K*H)*P
-	// first calculate expression for KHP
-	// then calculate P - KHP
-	SquareMatrix24f KHP;
-	float KH[4];
-
-	for (unsigned row = 0; row < _k_num_states; row++) {
-
-		KH[0] = Kfusion(row) * H_YAW(0);
-		KH[1] = Kfusion(row) * H_YAW(1);
-		KH[2] = Kfusion(row) * H_YAW(2);
-		KH[3] = Kfusion(row) * H_YAW(3);
-
-		for (unsigned column = 0; column < _k_num_states; column++) {
-			float tmp = KH[0] * P(0, column);
-			tmp += KH[1] * P(1, column);
-			tmp += KH[2] * P(2, column);
-			tmp += KH[3] * P(3, column);
-			KHP(row, column) = tmp;
-		}
-	}
+	SparseVector24f<0,1,2,3> Hfusion;
+	Hfusion.at<0>() = H_YAW(0);
+	Hfusion.at<1>() = H_YAW(1);
+	Hfusion.at<2>() = H_YAW(2);
+	Hfusion.at<3>() = H_YAW(3);
 
-	const bool healthy = checkAndFixCovarianceUpdate(KHP);
+	const bool healthy = applyCovarianceCorrection(Kfusion, computeHP(Hfusion));
 
 	_fault_status.flags.bad_hdg = !healthy;
 
 	if (healthy) {
-		// apply the covariance corrections
-		P -= KHP;
-
-		fixCovarianceErrors(true);
+		maintainCovarianceAfterFusion(Kfusion);
 
 		// apply the state corrections
 		fuse(Kfusion, aid_src_status.innovation);
@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file stage_timing.hpp
+ * @brief Optional per-stage execution time accounting for the EKF
+ *
+ * Only active when the library is compiled with ECL_EKF_STAGE_TIMING defined
+ * (see test/benchmark). In regular builds ECL_STAGE_TIMER() expands to nothing.
+ */
+
+#ifndef EKF_STAGE_TIMING_HPP
+#define EKF_STAGE_TIMING_HPP
+
+#include <stdint.h>
+
+#if defined(ECL_EKF_STAGE_TIMING)
+# include <chrono>
+#endif
+
+namespace estimator
+{
+
+enum class Stage : uint8_t {
+	Update = 0,
+	PredictState,
+	PredictCovariance,
+	ControlFusionModes,
+	YawEstimator,
+	MagFusion,
+	OpticalFlowFusion,
+	GpsFusion,
+	AirDataFusion,
+	BetaFusion,
+	DragFusion,
+	HeightFusion,
+	ExternalVisionFusion,
+	AuxVelFusion,
+	ZeroInnovationHeadingUpdate,
+	ZeroVelocityUpdate,
+	FakePosFusion,
+	FakeHgtFusion,
+	TerrainEstimator,
+	OutputPredictor,
+	Count
+};
+
+static constexpr const char *stage_name(Stage stage)
+{
+	switch (stage) {
+	case Stage::Update: return "update";
+
+	case Stage::PredictState: return "predict state";
+
+	case Stage::PredictCovariance: return "predict covariance";
+
+	case Stage::ControlFusionModes: return "control fusion modes";
+
+	case Stage::YawEstimator: return "yaw estimator (GSF)";
+
+	case Stage::MagFusion: return "mag fusion";
+
+	case Stage::OpticalFlowFusion: return "optical flow fusion";
+
+	case Stage::GpsFusion: return "gps fusion";
+
+	case Stage::AirDataFusion: return "airspeed fusion";
+
+	case Stage::BetaFusion: return "sideslip fusion";
+
+	case Stage::DragFusion: return "drag fusion";
+
+	case Stage::HeightFusion: return "height fusion";
+
+	case Stage::ExternalVisionFusion: return "external vision fusion";
+
+	case Stage::AuxVelFusion: return "aux velocity fusion";
+
+	case Stage::ZeroInnovationHeadingUpdate: return "zero innovation heading update";
+
+	case Stage::ZeroVelocityUpdate: return "zero velocity update";
+
+	case Stage::FakePosFusion: return "fake position fusion";
+
+	case Stage::FakeHgtFusion: return "fake height fusion";
+
+	case Stage::TerrainEstimator: return "terrain estimator";
+
+	case Stage::OutputPredictor: return "output predictor";
+
+	case Stage::Count: break;
+	}
+
+	return "unknown";
+}
+
+struct StageTimings {
+	static constexpr int kNumStages = static_cast<int>(Stage::Count);
+
+	uint64_t elapsed_ns[kNumStages] {};	///< accumulated execution time (nanoseconds)
+	uint32_t count[kNumStages] {};		///< number of executions
+
+	void reset()
+	{
+		for (int i = 0; i < kNumStages; i++) {
+			elapsed_ns[i] = 0;
+			count[i] = 0;
+		}
+	}
+};
+
+#if defined(ECL_EKF_STAGE_TIMING)
+
+class ScopedStageTimer
+{
+public:
+	ScopedStageTimer(StageTimings &timings, Stage stage) :
+		_timings(timings),
+		_stage(static_cast<int>(stage)),
+		_start(std::chrono::steady_clock::now())
+	{}
+
+	~ScopedStageTimer()
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - _start;
+		_timings.elapsed_ns[_stage] += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+		_timings.count[_stage]++;
+	}
+
+private:
+	StageTimings &_timings;
+	const int _stage;
+	const std::chrono::steady_clock::time_point _start;
+};
+
+# define ECL_STAGE_TIMER(stage) const estimator::ScopedStageTimer _stage_timer{_stage_timings, estimator::Stage::stage}
+#else
+# define ECL_STAGE_TIMER(stage)
+#endif // ECL_EKF_STAGE_TIMING
+
+} // namespace estimator
+
+#endif // !EKF_STAGE_TIMING_HPP
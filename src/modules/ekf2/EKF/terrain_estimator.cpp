@@ -50,6 +50,8 @@ void Ekf::initHagl()
 
 void Ekf::runTerrainEstimator()
 {
+	ECL_STAGE_TIMER(TerrainEstimator);
+
 	// If we are on ground, store the local position and time to use as a reference
 	if (!_control_status.flags.in_air) {
 		_last_on_ground_posD = _state.pos(2);
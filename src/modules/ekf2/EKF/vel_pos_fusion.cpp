@@ -266,34 +266,19 @@ bool Ekf::fuseVelPosHeight(const float innov, const float innov_var, const int o
 		Kfusion(row) = P(row, state_index) / innov_var;
 	}
 
-	SquareMatrix24f KHP;
+	// H is a unit vector selecting the observed state, so H*P is the corresponding row of P
+	Vector24f HP;
 
-	for (unsigned row = 0; row < _k_num_states; row++) {
-		for (unsigned column = 0; column < _k_num_states; column++) {
-			KHP(row, column) = Kfusion(row) * P(state_index, column);
-		}
+	for (unsigned column = 0; column < _k_num_states; column++) {
+		HP(column) = P(state_index, column);
 	}
 
-	// if the covariance correction will result in a negative variance, then
-	// the covariance matrix is unhealthy and must be corrected
-	bool healthy = true;
-
-	for (int i = 0; i < _k_num_states; i++) {
-		if (P(i, i) < KHP(i, i)) {
-			// zero rows and columns
-			P.uncorrelateCovarianceSetVariance<1>(i, 0.0f);
-
-			healthy = false;
-		}
-	}
+	const bool healthy = applyCovarianceCorrection(Kfusion, HP);
 
 	setVelPosStatus(obs_index, healthy);
 
 	if (healthy) {
-		// apply the covariance corrections
-		P -= KHP;
-
-		fixCovarianceErrors(true);
+		maintainCovarianceAfterFusion(Kfusion);
 
 		// apply the state corrections
 		fuse(Kfusion, innov);
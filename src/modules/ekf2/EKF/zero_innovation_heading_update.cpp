@@ -40,6 +40,8 @@
 
 void Ekf::controlZeroInnovationHeadingUpdate()
 {
+	ECL_STAGE_TIMER(ZeroInnovationHeadingUpdate);
+
 	const bool yaw_aiding = _control_status.flags.mag_hdg || _control_status.flags.mag_3D
 				|| _control_status.flags.ev_yaw || _control_status.flags.gps_yaw;
 
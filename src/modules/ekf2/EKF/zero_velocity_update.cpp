@@ -40,6 +40,8 @@
 
 void Ekf::controlZeroVelocityUpdate()
 {
+	ECL_STAGE_TIMER(ZeroVelocityUpdate);
+
 	// Fuse zero velocity at a limited rate (every 200 milliseconds)
 	const bool zero_velocity_update_data_ready = isTimedOut(_time_last_zero_velocity_fuse, (uint64_t)2e5);
 
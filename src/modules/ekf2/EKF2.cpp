@@ -166,7 +166,10 @@ EKF2::EKF2(bool multi_mode, const px4::wq_config_t &config, bool replay_mode):
 	_param_ekf2_pcoef_z(_params->static_pressure_coef_z),
 	_param_ekf2_mag_check(_params->check_mag_strength),
 	_param_ekf2_synthetic_mag_z(_params->synthesize_mag_z),
-	_param_ekf2_gsf_tas_default(_params->EKFGSF_tas_default)
+	_param_ekf2_gsf_tas_default(_params->EKFGSF_tas_default),
+	_param_ekf2_gsf_decim(_params->EKFGSF_decimation),
+	_param_ekf2_cov_mode(_params->cov_maintenance),
+	_param_ekf2_cov_sweep(_params->cov_sweep_interval)
 {
 	// advertise expected minimal topic set immediately to ensure logging
 	_attitude_pub.advertise();
@@ -610,7 +610,13 @@ private:
 
 		// Used by EKF-GSF experimental yaw estimator
 		(ParamExtFloat<px4::params::EKF2_GSF_TAS>)
-		_param_ekf2_gsf_tas_default	///< default value of true airspeed assumed during fixed wing operation
+		_param_ekf2_gsf_tas_default,	///< default value of true airspeed assumed during fixed wing operation
+		(ParamExtInt<px4::params::EKF2_GSF_DECIM>)
+		_param_ekf2_gsf_decim,	///< EKF-GSF decimation factor while the main filter yaw is trusted
+
+		(ParamExtInt<px4::params::EKF2_COV_MODE>) _param_ekf2_cov_mode,	///< covariance maintenance mode
+		(ParamExtInt<px4::params::EKF2_COV_SWEEP>)
+		_param_ekf2_cov_sweep	///< number of filter updates between full covariance sweeps
 
 	)
 };
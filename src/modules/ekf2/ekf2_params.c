@@ -1431,3 +1431,44 @@ PARAM_DEFINE_INT32(EKF2_SYNT_MAG_Z, 0);
  * @decimal 1
  */
 PARAM_DEFINE_FLOAT(EKF2_GSF_TAS, 15.0f);
+
+/**
+ * EKF-GSF yaw estimator decimation factor
+ *
+ * Number of IMU samples that are accumulated before the EKF-GSF yaw estimator is updated while the main filter
+ * yaw is aligned, aided by magnetometer, GNSS yaw or external vision data, and consistent with the EKF-GSF estimate.
+ * The estimator returns to full rate as soon as these conditions are no longer met.
+ * Set to 1 to always run the estimator at full rate.
+ *
+ * @group EKF2
+ * @min 1
+ * @max 10
+ */
+PARAM_DEFINE_INT32(EKF2_GSF_DECIM, 1);
+
+/**
+ * Covariance matrix maintenance mode
+ *
+ * Selects how the covariance matrix is kept within limits and symmetric after measurement updates.
+ * Full: the variances are constrained and the whole matrix is made symmetric after every single measurement update.
+ * Incremental: the variances are constrained after every measurement update, but only the blocks
+ * of states that have been corrected are made symmetric, once per filter update. A full sweep is
+ * additionally performed every EKF2_COV_SWEEP filter updates. This reduces the computational load.
+ *
+ * @group EKF2
+ * @value 0 Full
+ * @value 1 Incremental
+ */
+PARAM_DEFINE_INT32(EKF2_COV_MODE, 0);
+
+/**
+ * Covariance matrix full sweep interval
+ *
+ * Number of filter updates between full covariance sweeps when EKF2_COV_MODE is set to incremental.
+ * Set to zero to disable the periodic full sweep.
+ *
+ * @group EKF2
+ * @min 0
+ * @max 1000
+ */
+PARAM_DEFINE_INT32(EKF2_COV_SWEEP, 100);
@@ -0,0 +1,197 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file ekf2_benchmark.cpp
+ * Headless EKF2 throughput benchmark.
+ *
+ * Runs the estimator as fast as possible over the bundled replay data and
+ * synthetic long flights generated by the sensor simulator, and reports the
+ * execution time per IMU update and per filter stage (prediction, covariance
+ * and each fusion type).
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#include "EKF/ekf.h"
+#include "sensor_simulator/sensor_simulator.h"
+#include "sensor_simulator/ekf_wrapper.h"
+
+using namespace estimator;
+
+namespace
+{
+
+struct Scenario {
+	const char *name;
+	std::function<void(SensorSimulator &, EkfWrapper &, std::shared_ptr<Ekf> &)> setup;
+	std::function<void(SensorSimulator &)> run;
+};
+
+void printReport(const char *name, const StageTimings &timings, double wall_time_s, double simulated_time_s)
+{
+	const uint32_t imu_updates = timings.count[static_cast<int>(Stage::Update)];
+
+	printf("\n[%s] %u IMU updates, %.1f s simulated in %.3f s wall time (%.0fx real time)\n",
+	       name, imu_updates, simulated_time_s, wall_time_s, simulated_time_s / wall_time_s);
+	printf("  %-32s %10s %12s %12s %12s\n", "stage", "calls", "total [ms]", "ns/call", "ns/IMU upd");
+
+	for (int i = 0; i < StageTimings::kNumStages; i++) {
+		if (timings.count[i] == 0) {
+			continue;
+		}
+
+		const double total_ns = static_cast<double>(timings.elapsed_ns[i]);
+
+		printf("  %-32s %10u %12.3f %12.1f %12.1f\n",
+		       stage_name(static_cast<Stage>(i)), timings.count[i], total_ns * 1e-6,
+		       total_ns / timings.count[i], (imu_updates > 0) ? total_ns / imu_updates : 0.0);
+	}
+}
+
+void runScenario(const Scenario &scenario)
+{
+	std::shared_ptr<Ekf> ekf = std::make_shared<Ekf>();
+	SensorSimulator sensor_simulator(ekf);
+	EkfWrapper ekf_wrapper(ekf);
+
+	scenario.setup(sensor_simulator, ekf_wrapper, ekf);
+
+	// only account for the benchmarked part, not the alignment phase
+	ekf->resetStageTimings();
+	const uint64_t time_start_us = sensor_simulator.getTime();
+
+	const auto wall_start = std::chrono::steady_clock::now();
+	scenario.run(sensor_simulator);
+	const auto wall_elapsed = std::chrono::steady_clock::now() - wall_start;
+
+	printReport(scenario.name, ekf->getStageTimings(),
+		    std::chrono::duration<double>(wall_elapsed).count(),
+		    (sensor_simulator.getTime() - time_start_us) * 1e-6);
+}
+
+void setupReplay(SensorSimulator &sensor_simulator, EkfWrapper &ekf_wrapper, const char *file)
+{
+	sensor_simulator.loadSensorDataFromFile(file);
+	sensor_simulator.startGps();
+	ekf_wrapper.enableGpsFusion();
+}
+
+void setupSynthetic(SensorSimulator &sensor_simulator, std::shared_ptr<Ekf> &ekf)
+{
+	// run briefly to init, then align on ground (same as the unit tests)
+	ekf->init(0);
+	sensor_simulator.runSeconds(0.1f);
+	ekf->set_in_air_status(false);
+	ekf->set_vehicle_at_rest(true);
+	sensor_simulator.runSeconds(7.f);
+}
+
+void usage(const char *name)
+{
+	printf("usage: %s [-s <synthetic flight duration in seconds>]\n", name);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	float synthetic_duration_s = 600.f;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-s") && (i + 1 < argc)) {
+			synthetic_duration_s = strtof(argv[++i], nullptr);
+
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	const Scenario scenarios[] {
+		{
+			"replay iris_gps",
+			[](SensorSimulator & sim, EkfWrapper & wrapper, std::shared_ptr<Ekf> &) { setupReplay(sim, wrapper, TEST_DATA_PATH"/replay_data/iris_gps.csv"); },
+			[](SensorSimulator & sim) { sim.runReplaySeconds(35.f); }
+		},
+		{
+			"replay ekf_gsf_reset",
+			[](SensorSimulator & sim, EkfWrapper & wrapper, std::shared_ptr<Ekf> &) { setupReplay(sim, wrapper, TEST_DATA_PATH"/replay_data/ekf_gsf_reset.csv"); },
+			[](SensorSimulator & sim) { sim.runReplaySeconds(39.f); }
+		},
+		{
+			"synthetic gps",
+			[](SensorSimulator & sim, EkfWrapper & wrapper, std::shared_ptr<Ekf> &ekf)
+			{
+				setupSynthetic(sim, ekf);
+				sim.startGps();
+				wrapper.enableGpsFusion();
+				sim.runSeconds(11.f);
+				ekf->set_in_air_status(true);
+				ekf->set_vehicle_at_rest(false);
+			},
+			[synthetic_duration_s](SensorSimulator & sim) { sim.runSeconds(synthetic_duration_s); }
+		},
+		{
+			"synthetic flow and range finder",
+			[](SensorSimulator & sim, EkfWrapper & wrapper, std::shared_ptr<Ekf> &ekf)
+			{
+				setupSynthetic(sim, ekf);
+				const float distance_to_ground = 5.f;
+				ekf->set_optical_flow_limits(5.f, 0.f, 50.f);
+				sim._trajectory[2].setCurrentPosition(-distance_to_ground);
+				sim._rng.setData(distance_to_ground, 100);
+				sim._rng.setLimits(0.1f, 9.f);
+				sim.startRangeFinder();
+				sim._flow.setData(sim._flow.dataAtRest());
+				wrapper.enableFlowFusion();
+				sim.startFlow();
+				ekf->set_in_air_status(true);
+				ekf->set_vehicle_at_rest(false);
+				sim.runTrajectorySeconds(5.f);
+			},
+			[synthetic_duration_s](SensorSimulator & sim) { sim.runTrajectorySeconds(synthetic_duration_s); }
+		},
+	};
+
+	for (const Scenario &scenario : scenarios) {
+		runScenario(scenario);
+	}
+
+	return 0;
+}
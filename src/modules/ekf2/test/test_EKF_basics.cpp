@@ -210,6 +210,33 @@ TEST_F(EkfBasicsTest, accelBiasEstimation)
 			<< "gyro_bias = " << gyro_bias(0) << ", " << gyro_bias(1) << ", " << gyro_bias(2);
 }
 
+TEST_F(EkfBasicsTest, incrementalCovarianceMaintenance)
+{
+	// GIVEN: initialized EKF with default IMU, baro and mag input
+	// WHEN: the covariance matrix is only made symmetric once per filter update
+	//       and fusing GPS measurements with an accel bias
+	const Vector3f accel_bias_sim = {0.0f, 0.0f, 0.1f};
+	_ekf->getParamHandle()->cov_maintenance = static_cast<int32_t>(CovarianceMaintenance::INCREMENTAL);
+	_ekf->getParamHandle()->cov_sweep_interval = 0;
+
+	_sensor_simulator.startGps();
+	_sensor_simulator.setImuBias(accel_bias_sim, Vector3f(0.0f, 0.0f, 0.0f));
+	_ekf->set_min_required_gps_health_time(1e6);
+	_sensor_simulator.runSeconds(30);
+
+	// THEN: the covariance matrix should stay symmetric
+	matrix::SquareMatrix<float, 24> P = _ekf->covariances();
+	EXPECT_TRUE(P.isBlockSymmetric<24>(0));
+
+	// AND: the estimation should be as good as with the full maintenance
+	const Vector3f accel_bias = _ekf->getAccelBias();
+	const Vector3f vel = _ekf->getVelocity();
+	EXPECT_TRUE(matrix::isEqual(vel, Vector3f{}, 0.02f))
+			<< "vel = " << vel(0) << ", " << vel(1) << ", " << vel(2);
+	EXPECT_TRUE(matrix::isEqual(accel_bias, accel_bias_sim, 0.01f))
+			<< "accel_bias = " << accel_bias(0) << ", " << accel_bias(1) << ", " << accel_bias(2);
+}
+
 TEST_F(EkfBasicsTest, reset_ekf_global_origin_gps_initialized)
 {
 	_latitude_new  = 15.0000005;
@@ -114,3 +114,59 @@ TEST_F(EKFYawEstimatorTest, inAirYawAlignment)
 	EXPECT_TRUE(_ekf->local_position_is_valid());
 	EXPECT_TRUE(_ekf->global_position_is_valid());
 }
+
+TEST(EKFGSFYawTest, decimatedBankConverges)
+{
+	// GIVEN: two yaw estimators, one of them running at a quarter of the IMU rate
+	EKFGSF_yaw yaw_estimator;
+	EKFGSF_yaw yaw_estimator_decimated;
+	yaw_estimator_decimated.setDecimation(4);
+
+	// AND: a level vehicle with a heading far from North
+	const float yaw = math::radians(-130.f);
+	const Dcmf R_to_earth{Eulerf(0.f, 0.f, yaw)};
+	const Vector3f gravity(0.f, 0.f, CONSTANTS_ONE_G);
+
+	imuSample imu_sample{};
+	imu_sample.delta_ang_dt = 0.004f;
+	imu_sample.delta_vel_dt = 0.004f;
+
+	const Vector3f gyro_bias{};
+	Vector2f vel_NE{};
+
+	const auto run = [&](const Vector3f & accel_earth, bool run_EKF, int n_samples) {
+		imu_sample.delta_vel = R_to_earth.transpose() * (accel_earth - gravity) * imu_sample.delta_vel_dt;
+
+		for (int i = 0; i < n_samples; i++) {
+			imu_sample.time_us += 4000;
+			vel_NE += accel_earth.xy() * imu_sample.delta_vel_dt;
+
+			// 10 Hz velocity measurements
+			if (i % 25 == 0) {
+				yaw_estimator.setVelocity(vel_NE, 0.5f);
+				yaw_estimator_decimated.setVelocity(vel_NE, 0.5f);
+			}
+
+			yaw_estimator.update(imu_sample, run_EKF, 0.f, gyro_bias);
+			yaw_estimator_decimated.update(imu_sample, run_EKF, 0.f, gyro_bias);
+		}
+	};
+
+	// WHEN: the estimators are aligned at rest and the vehicle then accelerates in the horizontal plane
+	run(Vector3f(), false, 500);
+	run(Vector3f(1.f, -1.f, 0.f), true, 1000);
+
+	// THEN: both estimators converge to the true heading
+	const float tolerance_rad = math::radians(5.f);
+	EXPECT_TRUE(yaw_estimator.isActive());
+	EXPECT_TRUE(yaw_estimator_decimated.isActive());
+	EXPECT_NEAR(wrap_pi(yaw_estimator.getYaw() - yaw), 0.f, tolerance_rad);
+	EXPECT_NEAR(wrap_pi(yaw_estimator_decimated.getYaw() - yaw), 0.f, tolerance_rad);
+	EXPECT_LT(yaw_estimator_decimated.getYawVar(), tolerance_rad);
+
+	// AND: returning to full rate carries on from the decimated solution without a reinitialisation
+	yaw_estimator_decimated.setDecimation(1);
+	run(Vector3f(1.f, -1.f, 0.f), true, 1);
+	EXPECT_TRUE(yaw_estimator_decimated.isActive());
+	EXPECT_NEAR(wrap_pi(yaw_estimator_decimated.getYaw() - yaw), 0.f, tolerance_rad);
+}
@@ -39,6 +39,9 @@
 
 using namespace matrix;
 
+// sliding DFT damping factor per sample, keeps the recursion stable in the presence of rounding errors
+static constexpr float SDFT_DAMPING = 0.99999f;
+
 GyroFFT::GyroFFT() :
 	ModuleParams(nullptr),
 	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::hp_default)
@@ -57,6 +60,7 @@ GyroFFT::~GyroFFT()
 	perf_free(_cycle_perf);
 	perf_free(_cycle_interval_perf);
 	perf_free(_fft_perf);
+	perf_free(_sdft_perf);
 	perf_free(_gyro_generation_gap_perf);
 	perf_free(_gyro_fifo_generation_gap_perf);
 
@@ -67,12 +71,19 @@ GyroFFT::~GyroFFT()
 	delete[] _fft_input_buffer;
 	delete[] _fft_outupt_buffer;
 	delete[] _peak_magnitudes_all;
+	delete[] _sdft_bins_x;
+	delete[] _sdft_bins_y;
+	delete[] _sdft_bins_z;
+	delete[] _sdft_twiddle;
+	delete[] _sdft_spectrum;
 }
 
 bool GyroFFT::init()
 {
 	bool buffers_allocated = false;
 
+	_sliding_dft = (_param_imu_gyro_fft_mod.get() == 1);
+
 	// arm_rfft_init_q15(&_rfft_q15, _imu_gyro_fft_len, 0, 1) manually inlined to save flash
 	_rfft_q15.pTwiddleAReal = (q15_t *) realCoefAQ15;
 	_rfft_q15.pTwiddleBReal = (q15_t *) realCoefBQ15;
@@ -141,10 +152,25 @@ bool GyroFFT::init()
 	if (buffers_allocated) {
 		_imu_gyro_fft_len = _param_imu_gyro_fft_len.get();
 
-		// init Hanning window
-		for (int n = 0; n < _imu_gyro_fft_len; n++) {
-			const float hanning_value = 0.5f * (1.f - cosf(2.f * M_PI_F * n / (_imu_gyro_fft_len - 1)));
-			arm_float_to_q15(&hanning_value, &_hanning_window[n], 1);
+		if (_sliding_dft) {
+			// init sliding DFT twiddle factors exp(j 2 pi k / N)
+			for (int k = 0; k <= _imu_gyro_fft_len / 2; k++) {
+				_sdft_twiddle[2 * k]     = cosf(2.f * M_PI_F * k / _imu_gyro_fft_len);
+				_sdft_twiddle[2 * k + 1] = sinf(2.f * M_PI_F * k / _imu_gyro_fft_len);
+			}
+
+			_sdft_damping_n = powf(SDFT_DAMPING, _imu_gyro_fft_len);
+
+			_sdft_perf = perf_alloc(PC_ELAPSED, MODULE_NAME": sliding DFT");
+
+			ResetSlidingDFT();
+
+		} else {
+			// init Hanning window
+			for (int n = 0; n < _imu_gyro_fft_len; n++) {
+				const float hanning_value = 0.5f * (1.f - cosf(2.f * M_PI_F * n / (_imu_gyro_fft_len - 1)));
+				arm_float_to_q15(&hanning_value, &_hanning_window[n], 1);
+			}
 		}
 
 		if (!SensorSelectionUpdate(true)) {
@@ -161,6 +187,11 @@ bool GyroFFT::init()
 	delete[] _hanning_window;
 	delete[] _fft_input_buffer;
 	delete[] _fft_outupt_buffer;
+	delete[] _sdft_bins_x;
+	delete[] _sdft_bins_y;
+	delete[] _sdft_bins_z;
+	delete[] _sdft_twiddle;
+	delete[] _sdft_spectrum;
 
 	return false;
 }
@@ -266,7 +297,8 @@ static inline float tau(float x)
 	return (0.25f * p1 - sqrtf(6.f) / 24.f * p2);
 }
 
-float GyroFFT::EstimatePeakFrequencyBin(q15_t fft[], int peak_index)
+template<typename T>
+float GyroFFT::EstimatePeakFrequencyBin(T fft[], int peak_index)
 {
 	if (peak_index >= 2) {
 		// find peak location using Quinn's Second Estimator (2020-06-14: http://dspguru.com/dsp/howtos/how-to-interpolate-fft-peak/)
@@ -314,14 +346,7 @@ void GyroFFT::Run()
 	perf_begin(_cycle_perf);
 	perf_count(_cycle_interval_perf);
 
-	// Check if parameters have changed
-	if (_parameter_update_sub.updated()) {
-		// clear update
-		parameter_update_s param_update;
-		_parameter_update_sub.copy(&param_update);
-
-		updateParams();
-	}
+	ParametersUpdate();
 
 	const bool selection_updated = SensorSelectionUpdate();
 	VehicleIMUStatusUpdate(selection_updated);
@@ -339,6 +364,7 @@ void GyroFFT::Run()
 				_fft_buffer_index[0] = 0;
 				_fft_buffer_index[1] = 0;
 				_fft_buffer_index[2] = 0;
+				ResetSlidingDFT();
 
 				perf_count(_gyro_fifo_generation_gap_perf);
 			}
@@ -350,6 +376,7 @@ void GyroFFT::Run()
 				_fft_buffer_index[0] = 0;
 				_fft_buffer_index[1] = 0;
 				_fft_buffer_index[2] = 0;
+				ResetSlidingDFT();
 
 				_fifo_last_scale = sensor_gyro_fifo.scale;
 			}
@@ -368,6 +395,7 @@ void GyroFFT::Run()
 				_fft_buffer_index[0] = 0;
 				_fft_buffer_index[1] = 0;
 				_fft_buffer_index[2] = 0;
+				ResetSlidingDFT();
 
 				perf_count(_gyro_generation_gap_perf);
 			}
@@ -392,8 +420,30 @@ void GyroFFT::Run()
 	perf_end(_cycle_perf);
 }
 
+void GyroFFT::ParametersUpdate(bool force)
+{
+	// Check if parameters have changed
+	if (_parameter_update_sub.updated() || force) {
+		// clear update
+		parameter_update_s param_update;
+		_parameter_update_sub.copy(&param_update);
+
+		updateParams();
+
+		if (_sliding_dft) {
+			// IMU_GYRO_FFT_MIN/MAX may have changed
+			UpdateSlidingDFTBinRange();
+		}
+	}
+}
+
 void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N)
 {
+	if (_sliding_dft) {
+		UpdateSlidingDFT(timestamp_sample, input, N);
+		return;
+	}
+
 	q15_t *gyro_data_buffer[] {_gyro_data_buffer_x, _gyro_data_buffer_y, _gyro_data_buffer_z};
 
 	for (int axis = 0; axis < 3; axis++) {
@@ -415,7 +465,7 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 
 				_fft_updated = true;
 
-				FindPeaks(timestamp_sample, axis, _fft_outupt_buffer);
+				FindPeaks(timestamp_sample, axis, _fft_outupt_buffer, 1, _imu_gyro_fft_len / 2);
 
 				// reset
 				// shift buffer (3/4 overlap)
@@ -429,23 +479,136 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 	}
 }
 
-void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer)
+void GyroFFT::ResetSlidingDFT()
+{
+	if (_sliding_dft) {
+		for (int n = 0; n < _imu_gyro_fft_len; n++) {
+			_gyro_data_buffer_x[n] = 0;
+			_gyro_data_buffer_y[n] = 0;
+			_gyro_data_buffer_z[n] = 0;
+		}
+
+		for (int i = 0; i < _imu_gyro_fft_len + 2; i++) {
+			_sdft_bins_x[i] = 0.f;
+			_sdft_bins_y[i] = 0.f;
+			_sdft_bins_z[i] = 0.f;
+			_sdft_spectrum[i] = 0.f;
+		}
+
+		_sdft_buffer_index = 0;
+		_sdft_samples = 0;
+	}
+}
+
+void GyroFFT::UpdateSlidingDFT(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N)
+{
+	if (fabsf(_gyro_sample_rate_hz / _imu_gyro_fft_len - _sdft_resolution_hz) > FLT_EPSILON) {
+		UpdateSlidingDFTBinRange();
+	}
+
+	perf_begin(_sdft_perf);
+
+	q15_t *gyro_data_buffer[] {_gyro_data_buffer_x, _gyro_data_buffer_y, _gyro_data_buffer_z};
+	float *sdft_bins[] {_sdft_bins_x, _sdft_bins_y, _sdft_bins_z};
+
+	for (int n = 0; n < N; n++) {
+		for (int axis = 0; axis < 3; axis++) {
+			// convert int16_t -> q15_t (scaling isn't relevant), replace oldest sample in window
+			const q15_t sample = input[axis][n] / 2;
+			const float delta = sample - _sdft_damping_n * gyro_data_buffer[axis][_sdft_buffer_index];
+			gyro_data_buffer[axis][_sdft_buffer_index] = sample;
+
+			// X[k] = exp(j 2 pi k / N) * (r * X[k] + x[n] - r^N * x[n - N])
+			float *bins = sdft_bins[axis];
+
+			for (int k = _sdft_bin_start; k <= _sdft_bin_end; k++) {
+				const float real = SDFT_DAMPING * bins[2 * k] + delta;
+				const float imag = SDFT_DAMPING * bins[2 * k + 1];
+
+				const float twiddle_real = _sdft_twiddle[2 * k];
+				const float twiddle_imag = _sdft_twiddle[2 * k + 1];
+
+				bins[2 * k]     = real * twiddle_real - imag * twiddle_imag;
+				bins[2 * k + 1] = real * twiddle_imag + imag * twiddle_real;
+			}
+		}
+
+		_sdft_buffer_index = (_sdft_buffer_index + 1) % _imu_gyro_fft_len;
+
+		if (_sdft_samples < _imu_gyro_fft_len) {
+			_sdft_samples++;
+		}
+	}
+
+	perf_end(_sdft_perf);
+
+	// estimate peaks at a constant rate (IMU_GYRO_FFT_RAT) once the window is full
+	if (_sdft_samples >= _imu_gyro_fft_len) {
+		const float peaks_interval_us = 1e6f / math::constrain(_param_imu_gyro_fft_rat.get(), 10.f, 1000.f);
+
+		if (timestamp_sample >= _sdft_last_peaks + (hrt_abstime)peaks_interval_us) {
+			SlidingDFTFindPeaks(timestamp_sample);
+			_sdft_last_peaks = timestamp_sample;
+		}
+	}
+}
+
+void GyroFFT::UpdateSlidingDFTBinRange()
+{
+	// only update the bins from IMU_GYRO_FFT_MIN to IMU_GYRO_FFT_MAX,
+	// plus 2 bins on each side for the frequency domain window and the peak interpolation
+	_sdft_resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+
+	const int bin_start = math::max((int)floorf(_param_imu_gyro_fft_min.get() / _sdft_resolution_hz) - 2, 0);
+	const int bin_end = math::min((int)ceilf(_param_imu_gyro_fft_max.get() / _sdft_resolution_hz) + 2, _imu_gyro_fft_len / 2);
+
+	if ((bin_start != _sdft_bin_start) || (bin_end != _sdft_bin_end)) {
+		// bins newly in range haven't been tracked, restart the window
+		_sdft_bin_start = bin_start;
+		_sdft_bin_end = bin_end;
+
+		ResetSlidingDFT();
+	}
+}
+
+void GyroFFT::SlidingDFTFindPeaks(const hrt_abstime &timestamp_sample)
+{
+	perf_begin(_fft_perf);
+
+	float *sdft_bins[] {_sdft_bins_x, _sdft_bins_y, _sdft_bins_z};
+
+	for (int axis = 0; axis < 3; axis++) {
+		const float *bins = sdft_bins[axis];
+
+		// Hann window applied in the frequency domain, Xw[k] = 0.5 X[k] - 0.25 (X[k - 1] + X[k + 1])
+		for (int k = _sdft_bin_start + 1; k < _sdft_bin_end; k++) {
+			_sdft_spectrum[2 * k]     = 0.5f * bins[2 * k]     - 0.25f * (bins[2 * (k - 1)]     + bins[2 * (k + 1)]);
+			_sdft_spectrum[2 * k + 1] = 0.5f * bins[2 * k + 1] - 0.25f * (bins[2 * (k - 1) + 1] + bins[2 * (k + 1) + 1]);
+		}
+
+		// peak candidates need both neighbours of the windowed spectrum
+		FindPeaks(timestamp_sample, axis, _sdft_spectrum, _sdft_bin_start + 2, _sdft_bin_end - 1);
+	}
+
+	perf_end(_fft_perf);
+}
+
+template<typename T>
+void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, T spectrum[], int bin_start, int bin_end)
 {
 	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
 
 	// sum total energy across all used buckets for SNR
 	float bin_mag_sum = 0;
 
-	// FFT output buffer is ordered [real[0], imag[0], real[1], imag[1], real[2], imag[2] ... real[(N/2)-1], imag[(N/2)-1]
-	for (uint16_t fft_index = 2; fft_index < _imu_gyro_fft_len; fft_index += 2) {
+	// spectrum is ordered [real[0], imag[0], real[1], imag[1], real[2], imag[2] ... real[(N/2)-1], imag[(N/2)-1]
+	for (int bin_index = bin_start; bin_index < bin_end; bin_index++) {
 
-		const float real = fft_outupt_buffer[fft_index];
-		const float imag = fft_outupt_buffer[fft_index + 1];
+		const float real = spectrum[2 * bin_index];
+		const float imag = spectrum[2 * bin_index + 1];
 
 		const float fft_magnitude = sqrtf(real * real + imag * imag);
 
-		int bin_index = fft_index / 2;
-
 		_peak_magnitudes_all[bin_index] = fft_magnitude;
 		bin_mag_sum += fft_magnitude;
 	}
@@ -460,7 +623,7 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 		float largest_peak = 0;
 		int largest_peak_index = 0;
 
-		for (int bin_index = 1; bin_index < _imu_gyro_fft_len; bin_index++) {
+		for (int bin_index = bin_start; bin_index < bin_end; bin_index++) {
 
 			const float freq_hz = bin_index * resolution_hz;
 
@@ -504,12 +667,12 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 	for (int peak_new = 0; peak_new < MAX_NUM_PEAKS; peak_new++) {
 		if (raw_peak_index[peak_new] > 0) {
 
-			const float adjusted_bin = 0.5f * EstimatePeakFrequencyBin(fft_outupt_buffer, 2 * raw_peak_index[peak_new]);
+			const float adjusted_bin = 0.5f * EstimatePeakFrequencyBin(spectrum, 2 * raw_peak_index[peak_new]);
 
 			if (PX4_ISFINITE(adjusted_bin)) {
 				const float freq_adjusted = resolution_hz * adjusted_bin;
 
-				const float snr = 10.f * log10f((_imu_gyro_fft_len - 1) * peak_magnitude[peak_new] /
+				const float snr = 10.f * log10f((2 * (bin_end - bin_start) + 1) * peak_magnitude[peak_new] /
 								(bin_mag_sum - peak_magnitude[peak_new]));
 
 				if (PX4_ISFINITE(freq_adjusted)
@@ -703,9 +866,16 @@ int GyroFFT::task_spawn(int argc, char *argv[])
 int GyroFFT::print_status()
 {
 	PX4_INFO("gyro sample rate: %.3f Hz", (double)_gyro_sample_rate_hz);
+
+	if (_sliding_dft) {
+		PX4_INFO("sliding DFT bins: %d - %d (%.1f - %.1f Hz)", _sdft_bin_start, _sdft_bin_end,
+			 (double)(_sdft_bin_start * _sdft_resolution_hz), (double)(_sdft_bin_end * _sdft_resolution_hz));
+	}
+
 	perf_print_counter(_cycle_perf);
 	perf_print_counter(_cycle_interval_perf);
 	perf_print_counter(_fft_perf);
+	perf_print_counter(_sdft_perf);
 	perf_print_counter(_gyro_generation_gap_perf);
 	perf_print_counter(_gyro_fifo_generation_gap_perf);
 	return 0;
@@ -58,6 +58,8 @@
 
 using namespace time_literals;
 
+class GyroFFTTest;
+
 class GyroFFT : public ModuleBase<GyroFFT>, public ModuleParams, public px4::ScheduledWorkItem
 {
 public:
@@ -79,15 +81,27 @@ public:
 	bool init();
 
 private:
+	friend class ::GyroFFTTest;
+
 	static constexpr int MAX_SENSOR_COUNT = 4;
 
 	static constexpr int MAX_NUM_PEAKS = sizeof(sensor_gyro_fft_s::peak_frequencies_x) / sizeof(
 			sensor_gyro_fft_s::peak_frequencies_x[0]);
 
 	void Run() override;
-	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer);
-	inline float EstimatePeakFrequencyBin(q15_t fft[], int peak_index);
+
+	template<typename T>
+	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, T spectrum[], int bin_start, int bin_end);
+
+	template<typename T>
+	inline float EstimatePeakFrequencyBin(T fft[], int peak_index);
+
+	void ParametersUpdate(bool force = false);
 	inline void Publish();
+	void ResetSlidingDFT();
+	void UpdateSlidingDFT(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
+	void SlidingDFTFindPeaks(const hrt_abstime &timestamp_sample);
+	void UpdateSlidingDFTBinRange();
 	bool SensorSelectionUpdate(bool force = false);
 	void Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
 	inline void UpdateOutput(const hrt_abstime &timestamp_sample, int axis, float peak_frequencies[MAX_NUM_PEAKS],
@@ -100,12 +114,28 @@ private:
 		_gyro_data_buffer_x = new q15_t[N];
 		_gyro_data_buffer_y = new q15_t[N];
 		_gyro_data_buffer_z = new q15_t[N];
+
+		_peak_magnitudes_all = new float[N];
+
+		if (_sliding_dft) {
+			// complex bins 0 to N/2 (interleaved real, imag)
+			_sdft_bins_x = new float[N + 2];
+			_sdft_bins_y = new float[N + 2];
+			_sdft_bins_z = new float[N + 2];
+			_sdft_twiddle = new float[N + 2];
+			_sdft_spectrum = new float[N + 2];
+
+			return (_gyro_data_buffer_x && _gyro_data_buffer_y && _gyro_data_buffer_z
+				&& _peak_magnitudes_all
+				&& _sdft_bins_x && _sdft_bins_y && _sdft_bins_z
+				&& _sdft_twiddle
+				&& _sdft_spectrum);
+		}
+
 		_hanning_window = new q15_t[N];
 		_fft_input_buffer = new q15_t[N];
 		_fft_outupt_buffer = new q15_t[N * 2];
 
-		_peak_magnitudes_all = new float[N];
-
 		return (_gyro_data_buffer_x && _gyro_data_buffer_y && _gyro_data_buffer_z
 			&& _hanning_window
 			&& _fft_input_buffer
@@ -125,6 +155,7 @@ private:
 	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": cycle")};
 	perf_counter_t _cycle_interval_perf{perf_alloc(PC_INTERVAL, MODULE_NAME": cycle interval")};
 	perf_counter_t _fft_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": FFT")};
+	perf_counter_t _sdft_perf{nullptr};
 	perf_counter_t _gyro_generation_gap_perf{nullptr};
 	perf_counter_t _gyro_fifo_generation_gap_perf{nullptr};
 
@@ -143,6 +174,23 @@ private:
 
 	float *_peak_magnitudes_all{nullptr};
 
+	// sliding DFT (IMU_GYRO_FFT_MOD)
+	float *_sdft_bins_x{nullptr};
+	float *_sdft_bins_y{nullptr};
+	float *_sdft_bins_z{nullptr};
+	float *_sdft_twiddle{nullptr};
+	float *_sdft_spectrum{nullptr};
+
+	float _sdft_damping_n{1.f}; // damping applied to the sample leaving the window
+	float _sdft_resolution_hz{0.f};
+	int _sdft_bin_start{0};
+	int _sdft_bin_end{0};
+	int _sdft_buffer_index{0};
+	int _sdft_samples{0};
+	hrt_abstime _sdft_last_peaks{0};
+
+	bool _sliding_dft{false};
+
 	float _gyro_sample_rate_hz{8000}; // 8 kHz default
 
 	float _fifo_last_scale{0};
@@ -166,7 +214,9 @@ private:
 		(ParamInt<px4::params::IMU_GYRO_FFT_LEN>) _param_imu_gyro_fft_len,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MIN>) _param_imu_gyro_fft_min,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MAX>) _param_imu_gyro_fft_max,
-		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr
+		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr,
+		(ParamInt<px4::params::IMU_GYRO_FFT_MOD>) _param_imu_gyro_fft_mod,
+		(ParamFloat<px4::params::IMU_GYRO_FFT_RAT>) _param_imu_gyro_fft_rat
 	)
 };
 
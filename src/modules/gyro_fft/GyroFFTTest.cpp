@@ -0,0 +1,277 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * Test the sliding DFT (IMU_GYRO_FFT_MOD) against the block FFT with a known sinusoid.
+ *
+ * to run: make tests TESTFILTER=GyroFFT
+ */
+
+#define MODULE_NAME "gyro_fft"
+
+#include <gtest/gtest.h>
+#include "GyroFFT.hpp"
+
+#include <drivers/drv_hrt.h>
+#include <lib/parameters/param.h>
+#include <uORB/Publication.hpp>
+#include <uORB/PublicationMulti.hpp>
+
+#include <cmath>
+#include <complex>
+
+using namespace time_literals;
+
+static constexpr uint32_t DEVICE_ID = 1;
+static constexpr float SAMPLE_RATE_HZ = 1000.f;
+static constexpr int32_t FFT_LEN = 256;
+static constexpr float AMPLITUDE = 16000.f;
+static constexpr uint8_t SAMPLES_PER_UPDATE = 4; // FIFO style updates
+
+class GyroFFTTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		param_control_autosave(false);
+		param_reset_all();
+
+		int32_t fft_len = FFT_LEN;
+		param_set(param_find("IMU_GYRO_FFT_LEN"), &fft_len);
+
+		// select a gyro so that init() doesn't need to schedule
+		sensor_gyro_s sensor_gyro{};
+		sensor_gyro.device_id = DEVICE_ID;
+		sensor_gyro.timestamp = hrt_absolute_time();
+		_sensor_gyro_pub.publish(sensor_gyro);
+
+		sensor_selection_s sensor_selection{};
+		sensor_selection.gyro_device_id = DEVICE_ID;
+		sensor_selection.timestamp = hrt_absolute_time();
+		_sensor_selection_pub.publish(sensor_selection);
+	}
+
+	// create a GyroFFT instance in block FFT (0) or sliding DFT (1) mode
+	static GyroFFT *create(int32_t mode)
+	{
+		param_set(param_find("IMU_GYRO_FFT_MOD"), &mode);
+
+		GyroFFT *gyro_fft = new GyroFFT();
+
+		if (gyro_fft->init()) {
+			gyro_fft->_gyro_sample_rate_hz = SAMPLE_RATE_HZ;
+			return gyro_fft;
+		}
+
+		delete gyro_fft;
+		return nullptr;
+	}
+
+	// x axis gyro sample n (int16 FIFO scale) of a sinusoid at frequency_hz
+	static int16_t sample(int n, float frequency_hz)
+	{
+		const double phase = 2. * M_PI * fmod((double)n * frequency_hz / SAMPLE_RATE_HZ, 1.);
+		return (int16_t)lround(AMPLITUDE * sin(phase));
+	}
+
+	// run one cycle of samples [n, n + SAMPLES_PER_UPDATE) without scheduling
+	static void update(GyroFFT &gyro_fft, int n, float frequency_hz)
+	{
+		int16_t x[SAMPLES_PER_UPDATE];
+		int16_t y[SAMPLES_PER_UPDATE] {};
+		int16_t z[SAMPLES_PER_UPDATE] {};
+
+		for (int i = 0; i < SAMPLES_PER_UPDATE; i++) {
+			x[i] = sample(n + i, frequency_hz);
+		}
+
+		int16_t *input[] {x, y, z};
+		const hrt_abstime timestamp_sample = 1_s + (n + SAMPLES_PER_UPDATE - 1) * 1_ms;
+
+		gyro_fft._fft_updated = false;
+		gyro_fft.Update(timestamp_sample, input, SAMPLES_PER_UPDATE);
+	}
+
+	// x axis peak frequency with the highest SNR, NAN if none
+	static float peakFrequency(const GyroFFT &gyro_fft)
+	{
+		float peak_frequency = NAN;
+		float peak_snr = -INFINITY;
+
+		for (int i = 0; i < GyroFFT::MAX_NUM_PEAKS; i++) {
+			const float frequency = gyro_fft._sensor_gyro_fft.peak_frequencies_x[i];
+			const float snr = gyro_fft._sensor_gyro_fft.peak_snr_x[i];
+
+			if (PX4_ISFINITE(frequency) && (snr > peak_snr)) {
+				peak_frequency = frequency;
+				peak_snr = snr;
+			}
+		}
+
+		return peak_frequency;
+	}
+
+	static float resolution(const GyroFFT &gyro_fft) { return gyro_fft._gyro_sample_rate_hz / gyro_fft._imu_gyro_fft_len; }
+
+	// private state of GyroFFT (TEST_F bodies aren't friends)
+	static bool slidingDFT(const GyroFFT &gyro_fft) { return gyro_fft._sliding_dft; }
+	static int fftLength(const GyroFFT &gyro_fft) { return gyro_fft._imu_gyro_fft_len; }
+	static float dampingN(const GyroFFT &gyro_fft) { return gyro_fft._sdft_damping_n; }
+	static int binStart(const GyroFFT &gyro_fft) { return gyro_fft._sdft_bin_start; }
+	static int binEnd(const GyroFFT &gyro_fft) { return gyro_fft._sdft_bin_end; }
+	static int windowSamples(const GyroFFT &gyro_fft) { return gyro_fft._sdft_samples; }
+	static const float *binsX(const GyroFFT &gyro_fft) { return gyro_fft._sdft_bins_x; }
+	static float fftMax(const GyroFFT &gyro_fft) { return gyro_fft._param_imu_gyro_fft_max.get(); }
+	static void parametersUpdate(GyroFFT &gyro_fft) { gyro_fft.ParametersUpdate(true); }
+
+	uORB::PublicationMulti<sensor_gyro_s> _sensor_gyro_pub{ORB_ID(sensor_gyro)};
+	uORB::Publication<sensor_selection_s> _sensor_selection_pub{ORB_ID(sensor_selection)};
+};
+
+TEST_F(GyroFFTTest, SlidingMatchesBlock)
+{
+	// GIVEN: a block FFT and a sliding DFT instance and a sinusoid between IMU_GYRO_FFT_MIN and IMU_GYRO_FFT_MAX
+	GyroFFT *block = create(0);
+	GyroFFT *sliding = create(1);
+	ASSERT_NE(block, nullptr);
+	ASSERT_NE(sliding, nullptr);
+	ASSERT_FALSE(slidingDFT(*block));
+	ASSERT_TRUE(slidingDFT(*sliding));
+
+	const float frequency_hz = 80.f;
+	const float resolution_hz = resolution(*sliding);
+
+	// WHEN: both are fed the same 2 seconds of samples
+	for (int n = 0; n < 2000; n += SAMPLES_PER_UPDATE) {
+		update(*block, n, frequency_hz);
+		update(*sliding, n, frequency_hz);
+	}
+
+	// THEN: both report the sinusoid in the same bin
+	const float block_peak_hz = peakFrequency(*block);
+	const float sliding_peak_hz = peakFrequency(*sliding);
+
+	EXPECT_NEAR(block_peak_hz, frequency_hz, 0.5f * resolution_hz);
+	EXPECT_NEAR(sliding_peak_hz, frequency_hz, 0.5f * resolution_hz);
+	EXPECT_EQ(lroundf(block_peak_hz / resolution_hz), lroundf(sliding_peak_hz / resolution_hz));
+	EXPECT_NEAR(block_peak_hz, sliding_peak_hz, 0.5f * resolution_hz);
+
+	delete block;
+	delete sliding;
+}
+
+TEST_F(GyroFFTTest, SlidingRecursionBounded)
+{
+	// GIVEN: a sliding DFT instance
+	GyroFFT *sliding = create(1);
+	ASSERT_NE(sliding, nullptr);
+
+	const float frequency_hz = 80.f;
+
+	// WHEN: it runs for 10 minutes
+	const int samples = 10 * 60 * (int)SAMPLE_RATE_HZ;
+
+	for (int n = 0; n < samples; n += SAMPLES_PER_UPDATE) {
+		update(*sliding, n, frequency_hz);
+	}
+
+	// THEN: every bin still matches the damped DFT of the last window, X[k] = sum r^m x[n - m] exp(j 2 pi k m / N)
+	const int N = fftLength(*sliding);
+	const double r = pow(dampingN(*sliding), 1. / N);
+	float max_magnitude = 0.f;
+
+	for (int k = binStart(*sliding); k <= binEnd(*sliding); k++) {
+		std::complex<double> expected{};
+
+		for (int m = 0; m < N; m++) {
+			const double sample_q15 = sample(samples - 1 - m, frequency_hz) / 2; // int16_t -> q15_t as in GyroFFT
+			expected += pow(r, m) * sample_q15 * std::polar(1., 2. * M_PI * k * m / N);
+		}
+
+		const float real = binsX(*sliding)[2 * k];
+		const float imag = binsX(*sliding)[2 * k + 1];
+		const float magnitude = sqrtf(real * real + imag * imag);
+
+		ASSERT_TRUE(PX4_ISFINITE(magnitude));
+		EXPECT_NEAR(magnitude, std::abs(expected), 1e-4 * N * AMPLITUDE) << "bin " << k;
+
+		max_magnitude = fmaxf(max_magnitude, magnitude);
+	}
+
+	// bounded by the window sum, but not decayed (80 Hz is half way between bins)
+	EXPECT_LE(max_magnitude, N * AMPLITUDE / 2);
+	EXPECT_GT(max_magnitude, 0.25f * N * AMPLITUDE / 2);
+
+	// and the peak is still tracked
+	EXPECT_NEAR(peakFrequency(*sliding), frequency_hz, 0.5f * resolution(*sliding));
+
+	delete sliding;
+}
+
+TEST_F(GyroFFTTest, SlidingBinRangeFollowsParameters)
+{
+	// GIVEN: a sliding DFT instance and a sinusoid above the default IMU_GYRO_FFT_MAX
+	GyroFFT *sliding = create(1);
+	ASSERT_NE(sliding, nullptr);
+
+	const float frequency_hz = 250.f;
+	const float resolution_hz = resolution(*sliding);
+
+	int n = 0;
+
+	for (; n < 1000; n += SAMPLES_PER_UPDATE) {
+		update(*sliding, n, frequency_hz);
+	}
+
+	ASSERT_LT(fftMax(*sliding), frequency_hz);
+	EXPECT_LT(binEnd(*sliding) * resolution_hz, frequency_hz);
+	EXPECT_FALSE(fabsf(peakFrequency(*sliding) - frequency_hz) < resolution_hz);
+
+	// WHEN: IMU_GYRO_FFT_MAX is raised at runtime
+	float fft_max = 300.f;
+	param_set(param_find("IMU_GYRO_FFT_MAX"), &fft_max);
+	parametersUpdate(*sliding);
+
+	// THEN: the bin range covers the new limit and the sinusoid is found once the window refills
+	EXPECT_GE(binEnd(*sliding) * resolution_hz, fft_max);
+	EXPECT_EQ(windowSamples(*sliding), 0);
+
+	for (; n < 2000; n += SAMPLES_PER_UPDATE) {
+		update(*sliding, n, frequency_hz);
+	}
+
+	EXPECT_NEAR(peakFrequency(*sliding), frequency_hz, 0.5f * resolution_hz);
+
+	delete sliding;
+}
@@ -83,3 +83,29 @@ PARAM_DEFINE_INT32(IMU_GYRO_FFT_LEN, 512);
 * @group Sensors
 */
 PARAM_DEFINE_FLOAT(IMU_GYRO_FFT_SNR, 10.f);
+
+/**
+* IMU gyro FFT mode.
+*
+* Block FFT computes the full spectrum once per window (3/4 overlap).
+* Sliding DFT updates the bins between IMU_GYRO_FFT_MIN and IMU_GYRO_FFT_MAX
+* with every gyro sample and estimates the peaks at IMU_GYRO_FFT_RAT.
+*
+* @value 0 Block FFT
+* @value 1 Sliding DFT
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_MOD, 0);
+
+/**
+* IMU gyro FFT sliding DFT peak update rate.
+*
+* Rate at which the peaks are estimated and published in sliding DFT mode (IMU_GYRO_FFT_MOD).
+*
+* @min 10
+* @max 1000
+* @unit Hz
+* @group Sensors
+*/
+PARAM_DEFINE_FLOAT(IMU_GYRO_FFT_RAT, 100.f);
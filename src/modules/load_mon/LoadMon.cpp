@@ -59,6 +59,7 @@ LoadMon::~LoadMon()
 {
 	ScheduleClear();
 	perf_free(_cycle_perf);
+	delete _perf_export;
 }
 
 int LoadMon::task_spawn(int argc, char *argv[])
@@ -81,6 +82,10 @@ int LoadMon::task_spawn(int argc, char *argv[])
 
 void LoadMon::start()
 {
+	if (_param_sys_perf_exp.get()) {
+		_perf_export = new PerfExport();
+	}
+
 	ScheduleOnInterval(500_ms); // 2 Hz
 }
 
@@ -101,6 +106,12 @@ void LoadMon::Run()
 
 	cpuload();
 
+	work_item_stats();
+
+	if (_perf_export) {
+		_perf_export->update();
+	}
+
 #if defined(__PX4_NUTTX)
 
 	if (_param_sys_stck_en.get()) {
@@ -120,6 +131,41 @@ void LoadMon::Run()
 	perf_end(_cycle_perf);
 }
 
+void LoadMon::work_item_stats()
+{
+	// a few items per cycle, all of them are covered within a few seconds
+	static constexpr int ITEMS_PER_CYCLE = work_item_stats_s::ORB_QUEUE_LENGTH;
+
+	for (int i = 0; i < ITEMS_PER_CYCLE; i++) {
+		px4::work_item_stats_t stats;
+
+		if (!px4::WorkQueueManagerItemStats(_work_item_index, stats)) {
+			if (_work_item_index == 0) {
+				// no work items at all
+				return;
+			}
+
+			// wrap around
+			_work_item_index = 0;
+			continue;
+		}
+
+		_work_item_index++;
+
+		work_item_stats_s work_item_stats{};
+		memcpy(work_item_stats.item_name, stats.item_name, sizeof(work_item_stats.item_name));
+		memcpy(work_item_stats.wq_name, stats.wq_name, sizeof(work_item_stats.wq_name));
+		static_assert(sizeof(work_item_stats.latency_histogram) == sizeof(stats.latency.count), "histogram size mismatch");
+		memcpy(work_item_stats.latency_histogram, stats.latency.count, sizeof(work_item_stats.latency_histogram));
+		memcpy(work_item_stats.runtime_histogram, stats.runtime.count, sizeof(work_item_stats.runtime_histogram));
+		work_item_stats.latency_max_us = stats.latency.max;
+		work_item_stats.runtime_max_us = stats.runtime.max;
+		work_item_stats.wq_utilization = stats.wq_utilization;
+		work_item_stats.timestamp = hrt_absolute_time();
+		_work_item_stats_pub.publish(work_item_stats);
+	}
+}
+
 void LoadMon::cpuload()
 {
 #if defined(__PX4_LINUX)
@@ -47,6 +47,9 @@
 #include <uORB/Publication.hpp>
 #include <uORB/topics/cpuload.h>
 #include <uORB/topics/task_stack_info.h>
+#include <uORB/topics/work_item_stats.h>
+
+#include "PerfExport.hpp"
 
 #if defined(__PX4_LINUX)
 #include <sys/times.h>
@@ -81,6 +84,15 @@ private:
 	/** Do a calculation of the CPU load and publish it. */
 	void cpuload();
 
+	/** Publish the execution statistics of the next few work items. */
+	void work_item_stats();
+
+	unsigned _work_item_index{0};
+
+	uORB::Publication<work_item_stats_s> _work_item_stats_pub{ORB_ID(work_item_stats)};
+
+	PerfExport *_perf_export{nullptr}; ///< only allocated if enabled
+
 	/* Stack check only available on Nuttx */
 #if defined(__PX4_NUTTX)
 	/* Calculate stack usage */
@@ -105,7 +117,8 @@ private:
 	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": cycle")};
 
 	DEFINE_PARAMETERS(
-		(ParamBool<px4::params::SYS_STCK_EN>) _param_sys_stck_en
+		(ParamBool<px4::params::SYS_STCK_EN>) _param_sys_stck_en,
+		(ParamBool<px4::params::SYS_PERF_EXP>) _param_sys_perf_exp
 	)
 };
 
@@ -0,0 +1,245 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "PerfExport.hpp"
+
+#include <drivers/drv_hrt.h>
+#include <stdlib.h>
+
+namespace load_mon
+{
+
+PerfExport::~PerfExport()
+{
+	free(_snapshots);
+	free(_exported);
+}
+
+void PerfExport::update()
+{
+	// size the buffers before taking the perf lock, nothing is allocated or published while holding it
+	unsigned count = 0;
+	perf_iterate_all(count_callback, &count);
+
+	if (!reserve(count + SPARE_ENTRIES)) {
+		return;
+	}
+
+	_num_snapshots = 0;
+	perf_iterate_all(snapshot_callback, this);
+
+	// number the counters with the same name by allocation (oldest first)
+	qsort(_snapshots, _num_snapshots, sizeof(Entry), compare_name);
+
+	for (unsigned i = 0; i < _num_snapshots; i++) {
+		const bool same_name = (i > 0) && (_snapshots[i].name_hash == _snapshots[i - 1].name_hash);
+		_snapshots[i].instance = same_name ? _snapshots[i - 1].instance + 1 : 0;
+	}
+
+	_publications = 0;
+	_perf_counters.num_counters = 0;
+
+	for (unsigned i = 0; i < _num_snapshots; i++) {
+		add(_snapshots[i]);
+	}
+
+	if (_perf_counters.num_counters > 0) {
+		publish();
+	}
+
+	// the snapshots become the exported state, counters that were freed drop out
+	qsort(_snapshots, _num_snapshots, sizeof(Entry), compare_handle);
+
+	Entry *exported = _exported;
+	_exported = _snapshots;
+	_num_exported = _num_snapshots;
+	_snapshots = exported;
+	_num_snapshots = 0;
+}
+
+void PerfExport::count_callback(perf_counter_t, void *user)
+{
+	(*static_cast<unsigned *>(user))++;
+}
+
+void PerfExport::snapshot_callback(perf_counter_t handle, void *user)
+{
+	PerfExport *self = static_cast<PerfExport *>(user);
+
+	if (self->_num_snapshots >= self->_capacity) {
+		// allocated since counting, picked up by the next update
+		return;
+	}
+
+	perf_counter_snapshot_t snapshot;
+	perf_snapshot(handle, &snapshot);
+
+	Entry &entry = self->_snapshots[self->_num_snapshots];
+	entry.handle = handle;
+	entry.name_hash = snapshot.name_hash;
+	entry.events = (uint32_t)snapshot.event_count;
+	entry.elapsed = (uint32_t)snapshot.time_total;
+	entry.elapsed_max = snapshot.time_most;
+	entry.order = self->_num_snapshots++;
+}
+
+int PerfExport::compare_name(const void *a, const void *b)
+{
+	const Entry *ea = static_cast<const Entry *>(a);
+	const Entry *eb = static_cast<const Entry *>(b);
+
+	if (ea->name_hash != eb->name_hash) {
+		return (ea->name_hash < eb->name_hash) ? -1 : 1;
+	}
+
+	// the perf counter list is newest first
+	return (ea->order > eb->order) ? -1 : (ea->order < eb->order);
+}
+
+int PerfExport::compare_handle(const void *a, const void *b)
+{
+	const uintptr_t ha = (uintptr_t) static_cast<const Entry *>(a)->handle;
+	const uintptr_t hb = (uintptr_t) static_cast<const Entry *>(b)->handle;
+
+	return (ha < hb) ? -1 : (ha > hb);
+}
+
+bool PerfExport::reserve(unsigned count)
+{
+	if (count <= _capacity) {
+		return true;
+	}
+
+	Entry *snapshots = (Entry *)realloc(_snapshots, count * sizeof(Entry));
+
+	if (snapshots == nullptr) {
+		return false;
+	}
+
+	_snapshots = snapshots;
+
+	Entry *exported = (Entry *)realloc(_exported, count * sizeof(Entry));
+
+	if (exported == nullptr) {
+		return false;
+	}
+
+	_exported = exported;
+	_capacity = count;
+	return true;
+}
+
+const PerfExport::Entry *PerfExport::find_exported(perf_counter_t handle) const
+{
+	// binary search for the first entry >= handle
+	unsigned lo = 0;
+	unsigned hi = _num_exported;
+
+	while (lo < hi) {
+		const unsigned mid = (lo + hi) / 2;
+
+		if ((uintptr_t)_exported[mid].handle < (uintptr_t)handle) {
+			lo = mid + 1;
+
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo < _num_exported && _exported[lo].handle == handle) {
+		return &_exported[lo];
+	}
+
+	return nullptr;
+}
+
+void PerfExport::add(Entry &entry)
+{
+	const Entry *previous = find_exported(entry.handle);
+
+	if ((previous != nullptr) && (previous->name_hash == entry.name_hash)) {
+		entry.exported_events = previous->exported_events;
+		entry.exported_elapsed = previous->exported_elapsed;
+
+	} else {
+		// new counter (or a new one at the address of a freed one), everything since its creation is a change
+		entry.exported_events = 0;
+		entry.exported_elapsed = 0;
+	}
+
+	if ((entry.events == entry.exported_events) || (_publications >= MAX_PUBLICATIONS)) {
+		// unchanged, or the changes are kept for the next update
+		return;
+	}
+
+	const unsigned i = _perf_counters.num_counters++;
+	_perf_counters.name_hash[i] = entry.name_hash;
+	_perf_counters.instance[i] = entry.instance;
+
+	if (entry.events < entry.exported_events) {
+		// reset (or set) since the previous export
+		_perf_counters.events[i] = entry.events;
+		_perf_counters.elapsed[i] = entry.elapsed;
+
+	} else {
+		_perf_counters.events[i] = entry.events - entry.exported_events;
+		_perf_counters.elapsed[i] = entry.elapsed - entry.exported_elapsed;
+	}
+
+	_perf_counters.elapsed_max[i] = entry.elapsed_max;
+
+	entry.exported_events = entry.events;
+	entry.exported_elapsed = entry.elapsed;
+
+	if (_perf_counters.num_counters == perf_counters_s::MAX_COUNTERS) {
+		publish();
+	}
+}
+
+void PerfExport::publish()
+{
+	for (unsigned i = _perf_counters.num_counters; i < perf_counters_s::MAX_COUNTERS; i++) {
+		_perf_counters.name_hash[i] = 0;
+		_perf_counters.instance[i] = 0;
+		_perf_counters.events[i] = 0;
+		_perf_counters.elapsed[i] = 0;
+		_perf_counters.elapsed_max[i] = 0;
+	}
+
+	_perf_counters.timestamp = hrt_absolute_time();
+	_perf_counters_pub.publish(_perf_counters);
+	_perf_counters.num_counters = 0;
+	_publications++;
+}
+
+} // namespace load_mon
@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <lib/perf/perf_counter.h>
+#include <uORB/Publication.hpp>
+#include <uORB/topics/perf_counters.h>
+
+namespace load_mon
+{
+
+/**
+ * Publishes the changes of all perf counters since the previous export.
+ *
+ * Each update takes a snapshot of all counters under the perf lock and then computes the
+ * deltas and publishes outside of it. The last exported event count and elapsed time are
+ * kept per counter handle, so only deltas are published and only for counters with new
+ * events. If more counters changed than fit into the publications of one update, the rest
+ * keeps accumulating and goes out with the next update.
+ */
+class PerfExport
+{
+public:
+	PerfExport() = default;
+	~PerfExport();
+
+	void update();
+
+private:
+	static constexpr unsigned MAX_PUBLICATIONS = perf_counters_s::ORB_QUEUE_LENGTH;
+
+	/// headroom for counters allocated between counting and taking the snapshots
+	static constexpr unsigned SPARE_ENTRIES = 8;
+
+	struct Entry {
+		perf_counter_t handle; ///< only a key, not dereferenced outside of perf_iterate_all()
+		uint32_t name_hash;
+		uint32_t events;       ///< current event count (truncated, only differences matter)
+		uint32_t elapsed;      ///< current total elapsed time
+		uint32_t elapsed_max;
+		uint32_t order;        ///< position in the perf counter list, newest first
+		uint32_t exported_events;  ///< event count at the previous export
+		uint32_t exported_elapsed; ///< total elapsed time at the previous export
+		uint8_t instance;
+	};
+
+	static void count_callback(perf_counter_t handle, void *user);
+	static void snapshot_callback(perf_counter_t handle, void *user);
+
+	static int compare_name(const void *a, const void *b);
+	static int compare_handle(const void *a, const void *b);
+
+	bool reserve(unsigned count);
+	const Entry *find_exported(perf_counter_t handle) const;
+	void add(Entry &entry);
+	void publish();
+
+	Entry *_snapshots{nullptr}; ///< counters of the current update
+	unsigned _num_snapshots{0};
+
+	Entry *_exported{nullptr};  ///< counters of the previous update, sorted by handle
+	unsigned _num_exported{0};
+
+	unsigned _capacity{0};
+
+	perf_counters_s _perf_counters{};
+	unsigned _publications{0};
+
+	uORB::Publication<perf_counters_s> _perf_counters_pub{ORB_ID(perf_counters)};
+};
+
+} // namespace load_mon
@@ -38,3 +38,16 @@
  * @group System
  */
 PARAM_DEFINE_INT32(SYS_STCK_EN, 1);
+
+/**
+ * Stream perf counters
+ *
+ * If enabled, the changes of all perf counters are published twice per second
+ * on the perf_counters topic, which is logged. This allows to plot the timing of
+ * modules and drivers over a whole flight.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group System
+ */
+PARAM_DEFINE_INT32(SYS_PERF_EXP, 0);
@@ -220,4 +220,152 @@ private:
 
 };
 
+/**
+ * Integrator with multiple output channels sharing one accumulation pass.
+ *
+ * Each channel has its own reset interval and sample count, eg vehicle_imu at 200 Hz and a high rate
+ * consumer at 1 kHz, while the trapezoidal integration of each sample is only done once.
+ * Every channel produces the same result as a separate Integrator (or IntegratorConing if CONING)
+ * with the same configuration.
+ */
+template<size_t CHANNELS, bool CONING = false>
+class IntegratorMultiRate
+{
+public:
+	IntegratorMultiRate() = default;
+	~IntegratorMultiRate() = default;
+
+	static constexpr size_t channels() { return CHANNELS; }
+
+	/**
+	 * Put an item into the integral of all channels.
+	 *
+	 * @param val		Item to put.
+	 * @param dt		Time since the previous item in seconds.
+	 */
+	inline void put(const matrix::Vector3f &val, const float dt)
+	{
+		if (dt > Integrator::DT_MIN) {
+			// Use trapezoidal integration to calculate the delta integral
+			const matrix::Vector3f delta_alpha{(val + _last_val) *dt * 0.5f};
+			const matrix::Vector3f last_delta_alpha_6{_last_delta_alpha * (1.f / 6.f)};
+			_last_val = val;
+
+			for (auto &channel : _channels) {
+				if (channel.integral_dt + dt < Integrator::DT_MAX) {
+					channel.integrated_samples++;
+					channel.integral_dt += dt;
+
+					if (CONING) {
+						// Calculate coning corrections (see IntegratorConing)
+						channel.beta += ((channel.last_alpha + last_delta_alpha_6) % delta_alpha) * 0.5f;
+						channel.last_alpha = channel.alpha;
+					}
+
+					// accumulate delta integrals
+					channel.alpha += delta_alpha;
+
+				} else {
+					channel.reset();
+				}
+			}
+
+			_last_delta_alpha = delta_alpha;
+
+		} else {
+			reset();
+			_last_val = val;
+		}
+	}
+
+	/**
+	 * Set reset interval of a channel during runtime. This won't reset the integrator.
+	 *
+	 * @param channel		Output channel.
+	 * @param reset_interval	New reset time interval for the integrator in microseconds.
+	 */
+	void set_reset_interval(size_t channel, uint32_t reset_interval_us) { _channels[channel].reset_interval_min = reset_interval_us * 1e-6f; }
+
+	/**
+	 * Set required samples for reset of a channel. This won't reset the integrator.
+	 *
+	 * @param channel		Output channel.
+	 * @param reset_samples		New required samples for the integrator reset.
+	 */
+	void set_reset_samples(size_t channel, uint8_t reset_samples) { _channels[channel].reset_samples_min = reset_samples; }
+	uint8_t get_reset_samples(size_t channel) const { return _channels[channel].reset_samples_min; }
+
+	/**
+	 * Is the channel ready to reset?
+	 *
+	 * @return		true if the channel has sufficient data (minimum interval & samples satisfied) to reset.
+	 */
+	inline bool integral_ready(size_t channel) const { return _channels[channel].ready(); }
+
+	float integral_dt(size_t channel) const { return _channels[channel].integral_dt; }
+
+	const matrix::Vector3f &accumulated_coning_corrections(size_t channel) const { return _channels[channel].beta; }
+
+	void reset()
+	{
+		for (auto &channel : _channels) {
+			channel.reset();
+		}
+	}
+
+	/* Reset a channel and return its current (coning corrected) integral & integration time
+	 *
+	 * @param channel	Output channel.
+	 * @param integral_dt	Get the dt in us of the current integration.
+	 * @return		true if integral valid
+	 */
+	bool reset(size_t channel, matrix::Vector3f &integral, uint16_t &integral_dt)
+	{
+		Channel &c = _channels[channel];
+
+		if (c.ready()) {
+			integral = c.alpha + c.beta;
+			integral_dt = roundf(c.integral_dt * 1e6f); // seconds to microseconds
+
+			c.reset();
+
+			return true;
+		}
+
+		return false;
+	}
+
+private:
+	struct Channel {
+		bool ready() const { return (integrated_samples >= reset_samples_min) || (integral_dt >= reset_interval_min); }
+
+		void reset()
+		{
+			alpha.zero();
+			beta.zero();
+			last_alpha.zero();
+			integral_dt = 0;
+			integrated_samples = 0;
+		}
+
+		matrix::Vector3f alpha{0.f, 0.f, 0.f};      /**< integrated value before coning corrections are applied */
+		matrix::Vector3f beta{0.f, 0.f, 0.f};       /**< accumulated coning corrections */
+		matrix::Vector3f last_alpha{0.f, 0.f, 0.f}; /**< previous value of alpha */
+		float integral_dt{0};
+
+		float reset_interval_min{0.001f}; /**< the interval after which the content will be published and the channel reset */
+		uint8_t reset_samples_min{1};
+
+		uint8_t integrated_samples{0};
+	};
+
+	Channel _channels[CHANNELS] {};
+
+	matrix::Vector3f _last_val{0.f, 0.f, 0.f};         /**< previous input */
+	matrix::Vector3f _last_delta_alpha{0.f, 0.f, 0.f}; /**< integral from previous previous sampling interval */
+};
+
+template<size_t CHANNELS>
+using IntegratorConingMultiRate = IntegratorMultiRate<CHANNELS, true>;
+
 }; // namespace sensors
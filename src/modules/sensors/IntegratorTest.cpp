@@ -0,0 +1,199 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Test code for the multi rate coning integrator
+ * Run this test only using make tests TESTFILTER=Integrator
+ */
+
+#include <gtest/gtest.h>
+#include <matrix/matrix/math.hpp>
+
+#include "Integrator.hpp"
+
+using matrix::Vector3f;
+
+using namespace sensors;
+
+class IntegratorTest : public ::testing::Test
+{
+public:
+	// rotating about all axes with a varying rate to get non zero coning corrections
+	Vector3f getSample(int n) const
+	{
+		const float t = n * DT;
+		return Vector3f{sinf(10.f * t), cosf(7.f * t), 0.5f * sinf(3.f * t + 1.f)};
+	}
+
+	static constexpr float DT = 0.001f; // 1 kHz
+};
+
+TEST_F(IntegratorTest, MultiRateMatchesSingleRate)
+{
+	// GIVEN: a 1 kHz (every sample) and a 250 Hz (every 4 samples) channel and equivalent single rate integrators
+	IntegratorConingMultiRate<2> multi_rate{};
+	multi_rate.set_reset_samples(0, 1);
+	multi_rate.set_reset_interval(0, 1000);
+	multi_rate.set_reset_samples(1, 4);
+	multi_rate.set_reset_interval(1, 4000);
+
+	IntegratorConing fast{};
+	fast.set_reset_samples(1);
+	fast.set_reset_interval(1000);
+
+	IntegratorConing slow{};
+	slow.set_reset_samples(4);
+	slow.set_reset_interval(4000);
+
+	int slow_resets = 0;
+
+	for (int n = 0; n < 1000; n++) {
+		// WHEN: the same samples are integrated
+		const Vector3f sample{getSample(n)};
+		multi_rate.put(sample, DT);
+		fast.put(sample, DT);
+		slow.put(sample, DT);
+
+		// THEN: every channel matches the single rate integrator with the same configuration
+		for (int channel = 0; channel < 2; channel++) {
+			IntegratorConing &reference = (channel == 0) ? fast : slow;
+
+			EXPECT_EQ(multi_rate.integral_ready(channel), reference.integral_ready());
+
+			Vector3f integral_reference;
+			uint16_t integral_dt_reference = 0;
+			const bool reference_reset = reference.reset(integral_reference, integral_dt_reference);
+
+			Vector3f integral;
+			uint16_t integral_dt = 0;
+			ASSERT_EQ(multi_rate.reset(channel, integral, integral_dt), reference_reset);
+
+			if (reference_reset) {
+				EXPECT_EQ(integral_dt, integral_dt_reference);
+				EXPECT_NEAR(integral(0), integral_reference(0), 1e-7f);
+				EXPECT_NEAR(integral(1), integral_reference(1), 1e-7f);
+				EXPECT_NEAR(integral(2), integral_reference(2), 1e-7f);
+
+				if (channel == 1) {
+					slow_resets++;
+				}
+			}
+		}
+	}
+
+	EXPECT_EQ(slow_resets, 250);
+}
+
+TEST_F(IntegratorTest, MultiRateWithoutConingMatchesIntegrator)
+{
+	// GIVEN: a 1 kHz and a 200 Hz channel without coning corrections and equivalent single rate integrators
+	IntegratorMultiRate<2> multi_rate{};
+	multi_rate.set_reset_samples(0, 1);
+	multi_rate.set_reset_interval(0, 1000);
+	multi_rate.set_reset_samples(1, 5);
+	multi_rate.set_reset_interval(1, 5000);
+
+	Integrator fast{};
+	fast.set_reset_samples(1);
+	fast.set_reset_interval(1000);
+
+	Integrator slow{};
+	slow.set_reset_samples(5);
+	slow.set_reset_interval(5000);
+
+	for (int n = 0; n < 1000; n++) {
+		// WHEN: the same samples are integrated
+		const Vector3f sample{getSample(n)};
+		multi_rate.put(sample, DT);
+		fast.put(sample, DT);
+		slow.put(sample, DT);
+
+		// THEN: every channel matches the single rate integrator with the same configuration
+		for (int channel = 0; channel < 2; channel++) {
+			Integrator &reference = (channel == 0) ? fast : slow;
+
+			Vector3f integral_reference;
+			uint16_t integral_dt_reference = 0;
+			const bool reference_reset = reference.reset(integral_reference, integral_dt_reference);
+
+			Vector3f integral;
+			uint16_t integral_dt = 0;
+			ASSERT_EQ(multi_rate.reset(channel, integral, integral_dt), reference_reset);
+
+			if (reference_reset) {
+				EXPECT_EQ(integral_dt, integral_dt_reference);
+				EXPECT_NEAR(integral(0), integral_reference(0), 1e-7f);
+				EXPECT_NEAR(integral(1), integral_reference(1), 1e-7f);
+				EXPECT_NEAR(integral(2), integral_reference(2), 1e-7f);
+			}
+		}
+
+		EXPECT_EQ(multi_rate.accumulated_coning_corrections(1), Vector3f{});
+	}
+}
+
+TEST_F(IntegratorTest, MultiRateSlowChannelAccumulatesFastIntervals)
+{
+	// GIVEN: a fast channel reset every sample and a slow channel reset every 10 samples
+	IntegratorConingMultiRate<2> multi_rate{};
+	multi_rate.set_reset_samples(0, 1);
+	multi_rate.set_reset_samples(1, 10);
+	multi_rate.set_reset_interval(1, 10000);
+
+	Vector3f fast_sum{};
+	uint32_t fast_dt_sum = 0;
+
+	for (int n = 0; n < 10; n++) {
+		multi_rate.put(getSample(n), DT);
+
+		Vector3f integral;
+		uint16_t integral_dt = 0;
+
+		if (multi_rate.reset(0, integral, integral_dt)) {
+			fast_sum += integral;
+			fast_dt_sum += integral_dt;
+		}
+	}
+
+	// WHEN: the slow channel is read
+	Vector3f integral;
+	uint16_t integral_dt = 0;
+	ASSERT_TRUE(multi_rate.reset(1, integral, integral_dt));
+
+	// THEN: it covers the same interval as all fast outputs, the integral only differs by the coning corrections
+	EXPECT_EQ(integral_dt, fast_dt_sum);
+	EXPECT_NEAR(integral(0), fast_sum(0), 1e-4f);
+	EXPECT_NEAR(integral(1), fast_sum(1), 1e-4f);
+	EXPECT_NEAR(integral(2), fast_sum(2), 1e-4f);
+	EXPECT_FALSE(multi_rate.integral_ready(1));
+}
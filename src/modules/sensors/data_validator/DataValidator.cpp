@@ -63,20 +63,29 @@ void DataValidator::put(uint64_t timestamp, const float val[dimensions], uint32_
 	_error_count = error_count_in;
 	_priority = priority_in;
 
-	for (unsigned i = 0; i < dimensions; i++) {
-		if (PX4_ISFINITE(val[i])) {
-			if (_time_last == 0) {
+	if (_time_last == 0) {
+		for (unsigned i = 0; i < dimensions; i++) {
+			if (PX4_ISFINITE(val[i])) {
 				_mean[i] = 0;
 				_lp[i] = val[i];
 				_M2[i] = 0;
+				_value[i] = val[i];
+			}
+		}
 
-			} else {
-				float lp_val = val[i] - _lp[i];
+	} else {
+		// per sample gains shared by all axes
+		const float mean_gain = 1.f / _event_count;
+		const float var_gain = 1.f / (_event_count - 1);
 
-				float delta_val = lp_val - _mean[i];
-				_mean[i] += delta_val / _event_count;
+		for (unsigned i = 0; i < dimensions; i++) {
+			if (PX4_ISFINITE(val[i])) {
+				const float lp_val = val[i] - _lp[i];
+
+				const float delta_val = lp_val - _mean[i];
+				_mean[i] += delta_val * mean_gain;
 				_M2[i] += delta_val * (lp_val - _mean[i]);
-				_rms[i] = sqrtf(_M2[i] / (_event_count - 1));
+				_rms[i] = sqrtf(_M2[i] * var_gain);
 
 				if (fabsf(_value[i] - val[i]) < 0.000001f) {
 					_value_equal_count++;
@@ -84,12 +93,12 @@ void DataValidator::put(uint64_t timestamp, const float val[dimensions], uint32_
 				} else {
 					_value_equal_count = 0;
 				}
-			}
 
-			// XXX replace with better filter, make it auto-tune to update rate
-			_lp[i] = _lp[i] * 0.99f + 0.01f * val[i];
+				// XXX replace with better filter, make it auto-tune to update rate
+				_lp[i] = _lp[i] * 0.99f + 0.01f * val[i];
 
-			_value[i] = val[i];
+				_value[i] = val[i];
+			}
 		}
 	}
 
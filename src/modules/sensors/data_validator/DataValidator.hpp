@@ -66,19 +66,6 @@ public:
 	 */
 	void put(uint64_t timestamp, const float val[dimensions], uint32_t error_count, uint8_t priority);
 
-	/**
-	 * Get the next sibling in the group
-	 *
-	 * @return		the next sibling
-	 */
-	DataValidator *sibling() { return _sibling; }
-
-	/**
-	 * Set the sibling to the next node in the group
-	 *
-	 */
-	void setSibling(DataValidator *new_sibling) { _sibling = new_sibling; }
-
 	/**
 	 * Get the confidence of this validator
 	 * @return		the confidence between 0 and 1
@@ -186,8 +173,6 @@ private:
 	unsigned _value_equal_count_threshold{
 		VALUE_EQUAL_COUNT_DEFAULT}; /**< when to consider an equal count as a problem */
 
-	DataValidator *_sibling{nullptr}; /**< sibling in the group */
-
 	static const constexpr unsigned NORETURN_ERRCOUNT =
 		10000; /**< if the error count reaches this value, return sensor as invalid */
 	static const constexpr float ERROR_DENSITY_WINDOW = 100.0f; /**< window in measurement counts for errors */
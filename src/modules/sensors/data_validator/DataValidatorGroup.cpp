@@ -44,65 +44,33 @@
 #include <px4_platform_common/log.h>
 
 #include <float.h>
+#include <lib/mathlib/mathlib.h>
 
-DataValidatorGroup::DataValidatorGroup(unsigned siblings)
+DataValidatorGroup::DataValidatorGroup(unsigned siblings) :
+	_num_validators(math::min(siblings, MAX_VALIDATORS))
 {
-
-	DataValidator *next = nullptr;
-	DataValidator *prev = nullptr;
-
-	for (unsigned i = 0; i < siblings; i++) {
-		next = new DataValidator();
-
-		if (i == 0) {
-			_first = next;
-
-		} else {
-			prev->setSibling(next);
-		}
-
-		prev = next;
-	}
-
-	_last = next;
-
-	if (_first) {
-		_timeout_interval_us = _first->get_timeout();
+	if (siblings > MAX_VALIDATORS) {
+		PX4_ERR("%u validators requested, limited to %u", siblings, MAX_VALIDATORS);
 	}
-}
 
-DataValidatorGroup::~DataValidatorGroup()
-{
-	while (_first) {
-		DataValidator *next = _first->sibling();
-		delete (_first);
-		_first = next;
-	}
+	_timeout_interval_us = _validators[0].get_timeout();
 }
 
 DataValidator *DataValidatorGroup::add_new_validator()
 {
-
-	DataValidator *validator = new DataValidator();
-
-	if (!validator) {
+	if (_num_validators >= MAX_VALIDATORS) {
 		return nullptr;
 	}
 
-	_last->setSibling(validator);
-	_last = validator;
-	_last->set_timeout(_timeout_interval_us);
-	return _last;
+	DataValidator *validator = &_validators[_num_validators++];
+	validator->set_timeout(_timeout_interval_us);
+	return validator;
 }
 
 void DataValidatorGroup::set_timeout(uint32_t timeout_interval_us)
 {
-
-	DataValidator *next = _first;
-
-	while (next != nullptr) {
-		next->set_timeout(timeout_interval_us);
-		next = next->sibling();
+	for (unsigned i = 0; i < _num_validators; i++) {
+		_validators[i].set_timeout(timeout_interval_us);
 	}
 
 	_timeout_interval_us = timeout_interval_us;
@@ -110,37 +78,25 @@ void DataValidatorGroup::set_timeout(uint32_t timeout_interval_us)
 
 void DataValidatorGroup::set_equal_value_threshold(uint32_t threshold)
 {
-
-	DataValidator *next = _first;
-
-	while (next != nullptr) {
-		next->set_equal_value_threshold(threshold);
-		next = next->sibling();
+	for (unsigned i = 0; i < _num_validators; i++) {
+		_validators[i].set_equal_value_threshold(threshold);
 	}
 }
 
 void DataValidatorGroup::put(unsigned index, uint64_t timestamp, const float val[3], uint32_t error_count,
 			     uint8_t priority)
 {
-
-	DataValidator *next = _first;
-	unsigned i = 0;
-
-	while (next != nullptr) {
-		if (i == index) {
-			next->put(timestamp, val, error_count, priority);
-			break;
-		}
-
-		next = next->sibling();
-		i++;
+	if (index < _num_validators) {
+		_validators[index].put(timestamp, val, error_count, priority);
 	}
 }
 
 float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 {
-
-	DataValidator *next = _first;
+	// evaluate all validators first, the confidences are kept for get_sensor_confidence()
+	for (unsigned i = 0; i < _num_validators; i++) {
+		_confidence[i] = _validators[i].confidence(timestamp);
+	}
 
 	// XXX This should eventually also include voting
 	int pre_check_best = _curr_best;
@@ -149,17 +105,15 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 	float max_confidence = -1.0f;
 	int max_priority = -1000;
 	int max_index = -1;
-	DataValidator *best = nullptr;
 
-	int i = 0;
-
-	while (next != nullptr) {
-		float confidence = next->confidence(timestamp);
+	if ((pre_check_best >= 0) && ((unsigned)pre_check_best < _num_validators)) {
+		pre_check_prio = _validators[pre_check_best].priority();
+		pre_check_confidence = _confidence[pre_check_best];
+	}
 
-		if (i == pre_check_best) {
-			pre_check_prio = next->priority();
-			pre_check_confidence = confidence;
-		}
+	for (unsigned i = 0; i < _num_validators; i++) {
+		const float confidence = _confidence[i];
+		const int priority = _validators[i].priority();
 
 		/*
 		 * Switch if:
@@ -167,19 +121,17 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 		 * 2) the confidence is less than 1% different and the priority is higher
 		 */
 		if ((((max_confidence < MIN_REGULAR_CONFIDENCE) && (confidence >= MIN_REGULAR_CONFIDENCE)) ||
-		     (confidence > max_confidence && (next->priority() >= max_priority)) ||
-		     (fabsf(confidence - max_confidence) < 0.01f && (next->priority() > max_priority))) &&
+		     (confidence > max_confidence && (priority >= max_priority)) ||
+		     (fabsf(confidence - max_confidence) < 0.01f && (priority > max_priority))) &&
 		    (confidence > 0.0f)) {
 			max_index = i;
 			max_confidence = confidence;
-			max_priority = next->priority();
-			best = next;
+			max_priority = priority;
 		}
-
-		next = next->sibling();
-		i++;
 	}
 
+	DataValidator *best = (max_index >= 0) ? &_validators[max_index] : nullptr;
+
 	/* the current best sensor is not matching the previous best sensor,
 	 * or the only sensor went bad */
 	if (max_index != _curr_best || ((max_confidence < FLT_EPSILON) && (_curr_best >= 0))) {
@@ -228,14 +180,13 @@ void DataValidatorGroup::print()
 	PX4_INFO_RAW("validator: best: %d, prev best: %d, failsafe: %s (%u events)\n", _curr_best, _prev_best,
 		     (_toggle_count > 0) ? "YES" : "NO", _toggle_count);
 
-	DataValidator *next = _first;
-	unsigned i = 0;
+	for (unsigned i = 0; i < _num_validators; i++) {
+		DataValidator &validator = _validators[i];
 
-	while (next != nullptr) {
-		if (next->used()) {
-			uint32_t flags = next->state();
+		if (validator.used()) {
+			uint32_t flags = validator.state();
 
-			PX4_INFO_RAW("sensor #%u, prio: %d, state:%s%s%s%s%s%s\n", i, next->priority(),
+			PX4_INFO_RAW("sensor #%u, prio: %d, state:%s%s%s%s%s%s\n", i, validator.priority(),
 				     ((flags & DataValidator::ERROR_FLAG_NO_DATA) ? " OFF" : ""),
 				     ((flags & DataValidator::ERROR_FLAG_STALE_DATA) ? " STALE" : ""),
 				     ((flags & DataValidator::ERROR_FLAG_TIMEOUT) ? " TOUT" : ""),
@@ -243,27 +194,19 @@ void DataValidatorGroup::print()
 				     ((flags & DataValidator::ERROR_FLAG_HIGH_ERRDENSITY) ? " EDNST" : ""),
 				     ((flags == DataValidator::ERROR_FLAG_NO_ERROR) ? " OK" : ""));
 
-			next->print();
+			validator.print();
 		}
-
-		next = next->sibling();
-		i++;
 	}
 }
 
 int DataValidatorGroup::failover_index()
 {
-	DataValidator *next = _first;
-	unsigned i = 0;
+	if ((_prev_best >= 0) && ((unsigned)_prev_best < _num_validators)) {
+		const DataValidator &validator = _validators[_prev_best];
 
-	while (next != nullptr) {
-		if (next->used() && (next->state() != DataValidator::ERROR_FLAG_NO_ERROR) &&
-		    (i == (unsigned)_prev_best)) {
-			return i;
+		if (validator.used() && (validator.state() != DataValidator::ERROR_FLAG_NO_ERROR)) {
+			return _prev_best;
 		}
-
-		next = next->sibling();
-		i++;
 	}
 
 	return -1;
@@ -271,53 +214,31 @@ int DataValidatorGroup::failover_index()
 
 uint32_t DataValidatorGroup::failover_state()
 {
+	if ((_prev_best >= 0) && ((unsigned)_prev_best < _num_validators)) {
+		const DataValidator &validator = _validators[_prev_best];
 
-	DataValidator *next = _first;
-	unsigned i = 0;
-
-	while (next != nullptr) {
-		if (next->used() && (next->state() != DataValidator::ERROR_FLAG_NO_ERROR) &&
-		    (i == (unsigned)_prev_best)) {
-			return next->state();
+		if (validator.used()) {
+			return validator.state();
 		}
-
-		next = next->sibling();
-		i++;
 	}
 
 	return DataValidator::ERROR_FLAG_NO_ERROR;
 }
 
-uint32_t DataValidatorGroup::get_sensor_state(unsigned index)
+uint32_t DataValidatorGroup::get_sensor_state(unsigned index) const
 {
-	DataValidator *next = _first;
-	unsigned i = 0;
-
-	while (next != nullptr) {
-		if (i == index) {
-			return next->state();
-		}
-
-		next = next->sibling();
-		i++;
+	if (index < _num_validators) {
+		return _validators[index].state();
 	}
 
 	// sensor index not found
 	return UINT32_MAX;
 }
 
-uint8_t DataValidatorGroup::get_sensor_priority(unsigned index)
+uint8_t DataValidatorGroup::get_sensor_priority(unsigned index) const
 {
-	DataValidator *next = _first;
-	unsigned i = 0;
-
-	while (next != nullptr) {
-		if (i == index) {
-			return next->priority();
-		}
-
-		next = next->sibling();
-		i++;
+	if (index < _num_validators) {
+		return _validators[index].priority();
 	}
 
 	// sensor index not found
@@ -43,18 +43,22 @@
 
 #include "DataValidator.hpp"
 
+#include <uORB/uORB.h>
+
 class DataValidatorGroup
 {
 public:
 	/**
-	 * @param siblings initial number of DataValidator's. Must be > 0.
+	 * @param siblings initial number of DataValidator's. Must be > 0 and <= MAX_VALIDATORS.
 	 */
 	DataValidatorGroup(unsigned siblings);
-	~DataValidatorGroup();
+	~DataValidatorGroup() = default;
+
+	static constexpr unsigned MAX_VALIDATORS = 4; ///< sensors of one type (MAX_SENSOR_COUNT of the sensors module)
 
 	/**
 	 * Create a new Validator (with index equal to the number of currently existing validators)
-	 * @return the newly created DataValidator or nullptr on error
+	 * @return the newly created DataValidator or nullptr if the group is full
 	 */
 	DataValidator *add_new_validator();
 
@@ -102,14 +106,26 @@ public:
 	 *
 	 * @return		bitmask with error states of the sensor
 	 */
-	uint32_t get_sensor_state(unsigned index);
+	uint32_t get_sensor_state(unsigned index) const;
 
 	/**
 	 * Get the priority of the sensor with the specified index
 	 *
 	 * @return		priority
 	 */
-	uint8_t get_sensor_priority(unsigned index);
+	uint8_t get_sensor_priority(unsigned index) const;
+
+	/**
+	 * Get the confidence of the sensor with the specified index as evaluated by the last get_best()
+	 *
+	 * @return		confidence between 0 and 1, 0 if the index is invalid
+	 */
+	float get_sensor_confidence(unsigned index) const { return (index < _num_validators) ? _confidence[index] : 0.f; }
+
+	/**
+	 * Get the number of validators in the group
+	 */
+	unsigned get_validator_count() const { return _num_validators; }
 
 	/**
 	 * Print the validator value
@@ -132,8 +148,11 @@ public:
 	void set_equal_value_threshold(uint32_t threshold);
 
 private:
-	DataValidator *_first{nullptr}; /**< first node in the group */
-	DataValidator *_last{nullptr};  /**< last node in the group */
+	DataValidator _validators[MAX_VALIDATORS]; /**< contiguous validator storage, indexed by sensor index */
+
+	float _confidence[MAX_VALIDATORS] {}; /**< per sensor confidence from the last get_best() */
+
+	unsigned _num_validators{0}; /**< number of validators in use */
 
 	uint32_t _timeout_interval_us{0}; /**< currently set timeout */
 
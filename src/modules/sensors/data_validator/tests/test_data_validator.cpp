@@ -54,8 +54,6 @@ void test_init()
 	const uint32_t timeout_usec = 2000;//from original private value
 
 	DataValidator *validator = new DataValidator;
-	// initially there should be no siblings
-	assert(nullptr == validator->sibling());
 	// initially we should have zero confidence
 	assert(0.0f == validator->confidence(fake_timestamp));
 	// initially the error count should be zero
@@ -67,11 +65,6 @@ void test_init()
 	validator->set_timeout(timeout_usec);
 	assert(validator->get_timeout() == timeout_usec);
 
-
-	DataValidator *sibling_validator = new DataValidator;
-	validator->setSibling(sibling_validator);
-	assert(sibling_validator == validator->sibling());
-
 	//verify that with no data, confidence is zero and error mask is set
 	assert(0.0f == validator->confidence(fake_timestamp + 1));
 	uint32_t state = validator->state();
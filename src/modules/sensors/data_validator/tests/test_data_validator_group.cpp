@@ -50,7 +50,7 @@
 const uint32_t base_timeout_usec = 2000;//from original private value
 const int equal_value_count = 100; //default is private VALUE_EQUAL_COUNT_DEFAULT
 const uint64_t base_timestamp = 666;
-const unsigned base_num_siblings = 4;
+const unsigned base_num_siblings = 2; // leaves room for the validators added by the tests
 
 
 /**
@@ -231,6 +231,11 @@ void test_put()
 	//printf("cur_val12 %p \n", cur_val2);
 	assert(best_val == cur_val2[0]);
 
+	//the confidences evaluated by get_best are available per sensor
+	assert(1.0f == group->get_sensor_confidence(val1_idx));
+	assert(1.0f == group->get_sensor_confidence(val2_idx));
+	assert(0.0f == group->get_sensor_confidence(num_siblings));
+
 	delete group; //force cleanup
 }
 
@@ -222,6 +222,22 @@ PARAM_DEFINE_INT32(SENS_EXT_I2C_PRB, 1);
  */
 PARAM_DEFINE_INT32(SENS_IMU_MODE, 1);
 
+/**
+ * Sensors hub IMU batched processing
+ *
+ * Process all IMUs (vehicle_imu) in a single work item triggered by the updates of
+ * every IMU, instead of a separate work item for each IMU. Reduces scheduling overhead if the
+ * IMUs are sampled at similar rates. Only the scheduling is shared, every IMU is still
+ * calibrated and integrated separately and publishes the same vehicle_imu.
+ * With SENS_IMU_MODE 0 all IMUs are then processed in the first INS work queue.
+ *
+ * @boolean
+ * @category system
+ * @reboot_required true
+ * @group Sensors
+ */
+PARAM_DEFINE_INT32(SENS_IMU_BATCH, 0);
+
 /**
  * Enable internal barometers
  *
@@ -460,13 +460,19 @@ void Sensors::InitializeVehicleIMU()
 				// if the sensors module is responsible for voting (SENS_IMU_MODE 1) then run every VehicleIMU in the same WQ
 				//   otherwise each VehicleIMU runs in a corresponding INSx WQ
 				const bool multi_mode = (_param_sens_imu_mode.get() == 0);
-				const px4::wq_config_t &wq_config = multi_mode ? px4::ins_instance_to_wq(i) : px4::wq_configurations::INS0;
 
-				VehicleIMU *imu = new VehicleIMU(i, i, i, wq_config);
+				// batched mode (SENS_IMU_BATCH): every VehicleIMU is processed by the work item of the first one,
+				//   which is scheduled by the gyro updates of all of them (not only the first IMU)
+				VehicleIMU *batch_leader = (_param_sens_imu_batch.get() && (i > 0)) ? _vehicle_imu_list[0] : nullptr;
+
+				const px4::wq_config_t &wq_config = (multi_mode && !_param_sens_imu_batch.get()) ? px4::ins_instance_to_wq(i) :
+								    px4::wq_configurations::INS0;
+
+				VehicleIMU *imu = new VehicleIMU(i, i, i, wq_config, batch_leader);
 
 				if (imu != nullptr) {
-					// Start VehicleIMU instance and store
-					if (imu->Start()) {
+					// Start VehicleIMU instance (or add it to the first instance in batched mode) and store
+					if (batch_leader ? batch_leader->AddBatchedInstance(imu) : imu->Start()) {
 						_vehicle_imu_list[i] = imu;
 
 					} else {
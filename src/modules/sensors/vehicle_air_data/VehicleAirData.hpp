@@ -82,6 +82,7 @@ private:
 	float PressureToAltitude(float pressure_pa, float temperature = 15.f) const;
 
 	static constexpr int MAX_SENSOR_COUNT = 4;
+	static_assert(MAX_SENSOR_COUNT <= DataValidatorGroup::MAX_VALIDATORS, "DataValidatorGroup too small");
 
 	uORB::Publication<sensors_status_s> _sensors_status_baro_pub{ORB_ID(sensors_status_baro)};
 
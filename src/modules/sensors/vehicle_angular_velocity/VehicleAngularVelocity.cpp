@@ -57,6 +57,9 @@ VehicleAngularVelocity::~VehicleAngularVelocity()
 	perf_free(_cycle_perf);
 	perf_free(_filter_reset_perf);
 	perf_free(_selection_changed_perf);
+	perf_free(_filter_cascade_perf);
+	perf_free(_fifo_ring_overrun_perf);
+	perf_free(_fifo_ring_stale_perf);
 
 #if !defined(CONSTRAINED_FLASH)
 	delete[] _dynamic_notch_filter_esc_rpm;
@@ -161,7 +164,7 @@ bool VehicleAngularVelocity::UpdateSampleRate()
 
 void VehicleAngularVelocity::ResetFilters(const hrt_abstime &time_now_us)
 {
-	if ((_filter_sample_rate_hz > 0) && PX4_ISFINITE(_filter_sample_rate_hz)) {
+	if ((_filter_sample_rate_hz > 0) && PX4_ISFINITE(_filter_sample_rate_hz) && AllocateFilterCascade()) {
 
 		const Vector3f angular_velocity_uncalibrated{GetResetAngularVelocity()};
 		const Vector3f angular_acceleration_uncalibrated{GetResetAngularAcceleration()};
@@ -196,6 +199,13 @@ void VehicleAngularVelocity::ResetFilters(const hrt_abstime &time_now_us)
 		UpdateDynamicNotchEscRpm(time_now_us, true);
 		UpdateDynamicNotchFFT(time_now_us, true);
 
+		UpdateFilterCascade();
+
+		// angular velocity low pass is the last stage of the filter cascade
+		for (int axis = 0; axis < 3; axis++) {
+			_filter_cascade.reset(_filter_cascade.stages() - 1, axis, angular_velocity_uncalibrated(axis));
+		}
+
 		_angular_velocity_raw_prev = angular_velocity_uncalibrated;
 
 		_reset_filters = false;
@@ -296,6 +306,9 @@ bool VehicleAngularVelocity::SensorSelectionUpdate(const hrt_abstime &time_now_u
 							_bias.zero();
 							_fifo_available = true;
 
+							// read the FIFO in place from the driver if it's in the same address space
+							_fifo_ring_reader.attach(GyroFIFORing::get(i));
+
 							perf_count(_selection_changed_perf);
 							PX4_DEBUG("selecting sensor_gyro_fifo:%" PRIu8 " %" PRIu32, i, _selected_sensor_device_id);
 							return true;
@@ -337,6 +350,7 @@ bool VehicleAngularVelocity::SensorSelectionUpdate(const hrt_abstime &time_now_u
 							_reset_filters = true;
 							_bias.zero();
 							_fifo_available = false;
+							_fifo_ring_reader.detach();
 
 							perf_count(_selection_changed_perf);
 							PX4_DEBUG("selecting sensor_gyro:%" PRIu8 " %" PRIu32, i, _selected_sensor_device_id);
@@ -450,6 +464,9 @@ void VehicleAngularVelocity::ParametersUpdate(bool force)
 
 				_dynamic_notch_filter_esc_rpm = new NotchFilterHarmonic[esc_rpm_harmonics];
 
+				// resize the filter cascade
+				_reset_filters = true;
+
 				if (_dynamic_notch_filter_esc_rpm) {
 					_esc_rpm_harmonics = esc_rpm_harmonics;
 
@@ -492,6 +509,91 @@ void VehicleAngularVelocity::ParametersUpdate(bool force)
 	}
 }
 
+bool VehicleAngularVelocity::AllocateFilterCascade()
+{
+	// notch filter 0, notch filter 1 and low pass filter
+	int num_stages = 3;
+
+#if !defined(CONSTRAINED_FLASH)
+	num_stages += MAX_NUM_ESCS * _esc_rpm_harmonics + MAX_NUM_FFT_PEAKS;
+#endif // !CONSTRAINED_FLASH
+
+	if (_filter_cascade.stages() != num_stages) {
+		if (!_filter_cascade.allocate(num_stages)) {
+			PX4_ERR("gyro filter cascade allocation failed");
+			return false;
+		}
+
+		_filter_cascade_update = true;
+	}
+
+	return true;
+}
+
+void VehicleAngularVelocity::UpdateFilterCascadeStage(int stage, int axis, math::NotchFilter<float> &notch_filter,
+		bool enabled)
+{
+	if (enabled && (notch_filter.getNotchFreq() > 0.f)) {
+		float a[3];
+		float b[3];
+		notch_filter.getCoefficients(a, b);
+		_filter_cascade.setCoefficients(stage, axis, a, b);
+
+		if (!notch_filter.initialized()) {
+			// the cascade holds the filter state, reset it with the next sample
+			_filter_cascade.reset(stage, axis);
+			notch_filter.reset(0.f);
+		}
+
+	} else {
+		_filter_cascade.disable(stage, axis);
+	}
+}
+
+void VehicleAngularVelocity::UpdateFilterCascade()
+{
+	// stages in the order the filters are applied
+	int stage = 0;
+
+#if !defined(CONSTRAINED_FLASH)
+
+	// dynamic notch filters from ESC RPM
+	for (int esc = 0; esc < MAX_NUM_ESCS; esc++) {
+		for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
+			for (int axis = 0; axis < 3; axis++) {
+				UpdateFilterCascadeStage(stage, axis, _dynamic_notch_filter_esc_rpm[harmonic][axis][esc], _esc_available[esc]);
+			}
+
+			stage++;
+		}
+	}
+
+	// dynamic notch filters from FFT
+	for (int peak = MAX_NUM_FFT_PEAKS - 1; peak >= 0; peak--) {
+		for (int axis = 0; axis < 3; axis++) {
+			UpdateFilterCascadeStage(stage, axis, _dynamic_notch_filter_fft[axis][peak], _dynamic_notch_fft_available);
+		}
+
+		stage++;
+	}
+
+#endif // !CONSTRAINED_FLASH
+
+	for (int axis = 0; axis < 3; axis++) {
+		// general notch filter 0 (IMU_GYRO_NF0_FRQ) and 1 (IMU_GYRO_NF1_FRQ)
+		UpdateFilterCascadeStage(stage, axis, _notch_filter0_velocity[axis], true);
+		UpdateFilterCascadeStage(stage + 1, axis, _notch_filter1_velocity[axis], true);
+
+		// general low-pass filter (IMU_GYRO_CUTOFF), passes through when disabled
+		float a[3];
+		float b[3];
+		_lp_filter_velocity[axis].getCoefficients(a, b);
+		_filter_cascade.setCoefficients(stage + 2, axis, a, b);
+	}
+
+	_filter_cascade_update = false;
+}
+
 Vector3f VehicleAngularVelocity::GetResetAngularVelocity() const
 {
 	if (_last_publish != 0) {
@@ -533,6 +635,8 @@ void VehicleAngularVelocity::DisableDynamicNotchEscRpm()
 #if !defined(CONSTRAINED_FLASH)
 
 	if (_dynamic_notch_filter_esc_rpm) {
+		_filter_cascade_update = true;
+
 		for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
 			for (int axis = 0; axis < 3; axis++) {
 				for (int esc = 0; esc < MAX_NUM_ESCS; esc++) {
@@ -552,6 +656,8 @@ void VehicleAngularVelocity::DisableDynamicNotchFFT()
 #if !defined(CONSTRAINED_FLASH)
 
 	if (_dynamic_notch_fft_available) {
+		_filter_cascade_update = true;
+
 		for (int axis = 0; axis < 3; axis++) {
 			for (int peak = 0; peak < MAX_NUM_FFT_PEAKS; peak++) {
 				_dynamic_notch_filter_fft[axis][peak].disable();
@@ -571,6 +677,9 @@ void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(const hrt_abstime &time_no
 	const bool enabled = _dynamic_notch_filter_esc_rpm && (_param_imu_gyro_dnf_en.get() & DynamicNotch::EscRpm);
 
 	if (enabled && (_esc_status_sub.updated() || force)) {
+		if (force) {
+			_filter_cascade_update = true;
+		}
 
 		esc_status_s esc_status;
 
@@ -578,44 +687,75 @@ void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(const hrt_abstime &time_no
 
 			static constexpr float FREQ_MIN = 10.f; // TODO: configurable
 
+			// keep the frequency error of the highest harmonic within a fraction of the notch bandwidth
+			static constexpr float FREQ_HYSTERESIS = 0.05f;
+			const float bandwidth = _param_imu_gyro_dnf_bw.get();
+			const float hysteresis_hz = FREQ_HYSTERESIS * bandwidth / _esc_rpm_harmonics;
+
 			for (size_t esc = 0; esc < math::min(esc_status.esc_count, (uint8_t)MAX_NUM_ESCS); esc++) {
 				const esc_report_s &esc_report = esc_status.esc[esc];
 
 				// only update if ESC RPM range seems valid
 				if ((esc_report.esc_rpm != 0) && (time_now_us < esc_report.timestamp + DYNAMIC_NOTCH_FITLER_TIMEOUT)) {
 
-					bool esc_enabled = false;
-					bool update = force || !_esc_available[esc]; // force parameter update or notch was previously disabled
-
 					const float esc_hz = abs(esc_report.esc_rpm) / 60.f;
 
-					for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
-						const float frequency_hz = esc_hz * (harmonic + 1);
+					// force parameter update, notch was previously disabled or frequency changed beyond hysteresis
+					const bool reconfigure = force || !_esc_available[esc];
+					const bool update = reconfigure || (fabsf(esc_hz - _esc_rpm_notch_hz[esc]) > hysteresis_hz);
+
+					bool esc_enabled = _esc_available[esc];
+
+					if (update) {
+						esc_enabled = false;
+						_esc_rpm_notch_hz[esc] = esc_hz;
+						_filter_cascade_update = true;
 
-						// for each ESC harmonic determine if enabled/disabled from first notch (x axis)
-						auto &nfx = _dynamic_notch_filter_esc_rpm[harmonic][0][esc];
+						// cosine of the harmonics from the fundamental, cos((k + 1) w) = 2 cos(w) cos(k w) - cos((k - 1) w)
+						const float cos_fundamental = cosf(2.f * M_PI_F * esc_hz / _filter_sample_rate_hz);
+						float cos_harmonic_prev = 1.f;
+						float cos_harmonic = cos_fundamental;
+
+						for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
+							const float frequency_hz = esc_hz * (harmonic + 1);
+
+							// for each ESC harmonic determine if enabled/disabled from first notch (x axis)
+							auto &nfx = _dynamic_notch_filter_esc_rpm[harmonic][0][esc];
+
+							if (frequency_hz > FREQ_MIN) {
+								// full update (trigonometry) only if not configured yet or bandwidth changed
+								const bool full_update = reconfigure || (nfx.getNotchFreq() <= 0.f)
+											 || (fabsf(nfx.getBandwidth() - bandwidth) > 0.01f);
 
-						if (frequency_hz > FREQ_MIN) {
-							// update filter parameters if frequency changed or forced
-							if (update || !nfx.initialized() || (fabsf(nfx.getNotchFreq() - frequency_hz) > 0.1f)) {
 								for (int axis = 0; axis < 3; axis++) {
 									auto &nf = _dynamic_notch_filter_esc_rpm[harmonic][axis][esc];
-									nf.setParameters(_filter_sample_rate_hz, frequency_hz, _param_imu_gyro_dnf_bw.get());
+
+									if (full_update) {
+										nf.setParameters(_filter_sample_rate_hz, frequency_hz, bandwidth);
+
+									} else {
+										nf.setNotchFreq(frequency_hz, cos_harmonic);
+									}
+
 									perf_count(_dynamic_notch_filter_esc_rpm_update_perf);
 								}
-							}
 
-							esc_enabled = true;
+								esc_enabled = true;
 
-						} else {
-							// disable these notch filters (if they aren't already)
-							if (nfx.getNotchFreq() > 0.f) {
-								for (int axis = 0; axis < 3; axis++) {
-									auto &nf = _dynamic_notch_filter_esc_rpm[harmonic][axis][esc];
-									nf.disable();
-									perf_count(_dynamic_notch_filter_esc_rpm_disable_perf);
+							} else {
+								// disable these notch filters (if they aren't already)
+								if (nfx.getNotchFreq() > 0.f) {
+									for (int axis = 0; axis < 3; axis++) {
+										auto &nf = _dynamic_notch_filter_esc_rpm[harmonic][axis][esc];
+										nf.disable();
+										perf_count(_dynamic_notch_filter_esc_rpm_disable_perf);
+									}
 								}
 							}
+
+							const float cos_harmonic_next = 2.f * cos_fundamental * cos_harmonic - cos_harmonic_prev;
+							cos_harmonic_prev = cos_harmonic;
+							cos_harmonic = cos_harmonic_next;
 						}
 					}
 
@@ -635,6 +775,7 @@ void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(const hrt_abstime &time_no
 			if (_esc_available[esc] && (time_now_us > _last_esc_rpm_notch_update[esc] + DYNAMIC_NOTCH_FITLER_TIMEOUT)) {
 
 				_esc_available.set(esc, false);
+				_filter_cascade_update = true;
 
 				for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
 					for (int axis = 0; axis < 3; axis++) {
@@ -655,6 +796,7 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(const hrt_abstime &time_now_u
 	const bool enabled = _param_imu_gyro_dnf_en.get() & DynamicNotch::FFT;
 
 	if (enabled && (_sensor_gyro_fft_sub.updated() || force)) {
+		_filter_cascade_update = true;
 
 		if (!_dynamic_notch_fft_available) {
 			// force update filters if previously disabled
@@ -708,47 +850,65 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(const hrt_abstime &time_now_u
 #endif // !CONSTRAINED_FLASH
 }
 
-float VehicleAngularVelocity::FilterAngularVelocity(int axis, float data[], int N)
+void VehicleAngularVelocity::FilterAngularVelocity(float *const data[3], int N)
 {
-#if !defined(CONSTRAINED_FLASH)
+	// Apply dynamic notch filters (ESC RPM, FFT), general notch filters (IMU_GYRO_NF0_FRQ, IMU_GYRO_NF1_FRQ)
+	// and general low-pass filter (IMU_GYRO_CUTOFF) to all axes in a single pass
+	perf_begin(_filter_cascade_perf);
+	_filter_cascade.apply(data, N);
+	perf_end(_filter_cascade_perf);
 
-	// Apply dynamic notch filter from ESC RPM
-	if (_dynamic_notch_filter_esc_rpm) {
-		for (int esc = 0; esc < MAX_NUM_ESCS; esc++) {
-			if (_esc_available[esc]) {
-				for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
-					_dynamic_notch_filter_esc_rpm[harmonic][axis][esc].applyArray(data, N);
-				}
-			}
-		}
+	_filter_cascade_samples += N;
+}
+
+bool VehicleAngularVelocity::FIFORingValid()
+{
+	if (_fifo_ring_reader.attached() && !_fifo_ring_reader.writer_valid()) {
+		// driver stopped or restarted, the ring is stale
+		_fifo_ring_reader.detach();
+		perf_count(_fifo_ring_stale_perf);
 	}
 
-	// Apply dynamic notch filter from FFT
-	if (_dynamic_notch_fft_available) {
-		for (int peak = MAX_NUM_FFT_PEAKS - 1; peak >= 0; peak--) {
-			if (_dynamic_notch_filter_fft[axis][peak].getNotchFreq() > 0.f) {
-				_dynamic_notch_filter_fft[axis][peak].applyArray(data, N);
-			}
-		}
+	if (!_fifo_ring_reader.attached()) {
+		// (re)attach once a driver in the same address space feeds the ring, uORB otherwise
+		_fifo_ring_reader.attach(GyroFIFORing::get(_sensor_gyro_fifo_sub.get_instance()));
 	}
 
-#endif // !CONSTRAINED_FLASH
+	return _fifo_ring_reader.attached();
+}
+
+const sensor_gyro_fifo_s *VehicleAngularVelocity::NextFIFO(sensor_gyro_fifo_s &buffer)
+{
+	if (FIFORingValid()) {
+		// all updates are read in place from the driver FIFO ring
+		_sensor_gyro_fifo_sub.ack();
+
+		bool gap = false;
+		const sensor_gyro_fifo_s *fifo = _fifo_ring_reader.peek(gap);
 
-	// Apply general notch filter 0 (IMU_GYRO_NF0_FRQ)
-	if (_notch_filter0_velocity[axis].getNotchFreq() > 0.f) {
-		_notch_filter0_velocity[axis].applyArray(data, N);
+		if (gap) {
+			perf_count(_fifo_ring_overrun_perf);
+		}
+
+		return fifo;
 	}
 
-	// Apply general notch filter 1 (IMU_GYRO_NF1_FRQ)
-	if (_notch_filter1_velocity[axis].getNotchFreq() > 0.f) {
-		_notch_filter1_velocity[axis].applyArray(data, N);
+	return _sensor_gyro_fifo_sub.update(&buffer) ? &buffer : nullptr;
+}
+
+bool VehicleAngularVelocity::ReleaseFIFO()
+{
+	if (_fifo_ring_reader.attached() && !_fifo_ring_reader.release()) {
+		perf_count(_fifo_ring_overrun_perf);
+		return false;
 	}
 
-	// Apply general low-pass filter (IMU_GYRO_CUTOFF)
-	_lp_filter_velocity[axis].applyArray(data, N);
+	return true;
+}
 
-	// return last filtered sample
-	return data[N - 1];
+bool VehicleAngularVelocity::FIFOUpdated()
+{
+	return FIFORingValid() ? _fifo_ring_reader.available() : _sensor_gyro_fifo_sub.updated();
 }
 
 float VehicleAngularVelocity::FilterAngularAcceleration(int axis, float inverse_dt_s, float data[], int N)
@@ -803,37 +963,58 @@ void VehicleAngularVelocity::Run()
 	UpdateDynamicNotchEscRpm(time_now_us);
 	UpdateDynamicNotchFFT(time_now_us);
 
+	if (_filter_cascade_update) {
+		UpdateFilterCascade();
+	}
+
 	if (_fifo_available) {
 		// process all outstanding fifo messages
-		sensor_gyro_fifo_s sensor_fifo_data;
+		sensor_gyro_fifo_s sensor_fifo_buffer;
 
-		while (_sensor_gyro_fifo_sub.update(&sensor_fifo_data)) {
-			const float inverse_dt_s = 1e6f / sensor_fifo_data.dt;
-			const int N = sensor_fifo_data.samples;
-			static constexpr int FIFO_SIZE_MAX = sizeof(sensor_fifo_data.x) / sizeof(sensor_fifo_data.x[0]);
+		while (const sensor_gyro_fifo_s *sensor_fifo_data = NextFIFO(sensor_fifo_buffer)) {
+			const float inverse_dt_s = 1e6f / sensor_fifo_data->dt;
+			const int N = sensor_fifo_data->samples;
+			const hrt_abstime timestamp_sample = sensor_fifo_data->timestamp_sample;
+			static constexpr int FIFO_SIZE_MAX = sizeof(sensor_fifo_data->x) / sizeof(sensor_fifo_data->x[0]);
 
-			if ((sensor_fifo_data.dt > 0) && (N > 0) && (N <= FIFO_SIZE_MAX)) {
-				Vector3f angular_velocity_uncalibrated;
-				Vector3f angular_acceleration_uncalibrated;
+			const bool fifo_valid = (sensor_fifo_data->dt > 0) && (N > 0) && (N <= FIFO_SIZE_MAX);
 
-				int16_t *raw_data_array[] {sensor_fifo_data.x, sensor_fifo_data.y, sensor_fifo_data.z};
+			// copy raw int16 sensor samples to float arrays for filtering
+			float data_x[FIFO_SIZE_MAX];
+			float data_y[FIFO_SIZE_MAX];
+			float data_z[FIFO_SIZE_MAX];
+			float *const data[3] {data_x, data_y, data_z};
 
-				for (int axis = 0; axis < 3; axis++) {
-					// copy raw int16 sensor samples to float array for filtering
-					float data[FIFO_SIZE_MAX];
+			if (fifo_valid) {
+				const int16_t *raw_data_array[] {sensor_fifo_data->x, sensor_fifo_data->y, sensor_fifo_data->z};
 
+				for (int axis = 0; axis < 3; axis++) {
 					for (int n = 0; n < N; n++) {
-						data[n] = sensor_fifo_data.scale * raw_data_array[axis][n];
+						data[axis][n] = sensor_fifo_data->scale * raw_data_array[axis][n];
 					}
+				}
+			}
+
+			if (!ReleaseFIFO()) {
+				// overwritten by the driver while reading
+				continue;
+			}
+
+			if (fifo_valid) {
+				Vector3f angular_velocity_uncalibrated;
+				Vector3f angular_acceleration_uncalibrated;
+
+				FilterAngularVelocity(data, N);
 
+				for (int axis = 0; axis < 3; axis++) {
 					// save last filtered sample
-					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data, N);
-					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data, N);
+					angular_velocity_uncalibrated(axis) = data[axis][N - 1];
+					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data[axis], N);
 				}
 
 				// Publish
-				if (!_sensor_gyro_fifo_sub.updated()) {
-					if (CalibrateAndPublish(sensor_fifo_data.timestamp_sample,
+				if (!FIFOUpdated()) {
+					if (CalibrateAndPublish(timestamp_sample,
 								angular_velocity_uncalibrated,
 								angular_acceleration_uncalibrated)) {
 
@@ -862,15 +1043,18 @@ void VehicleAngularVelocity::Run()
 				Vector3f angular_velocity_uncalibrated;
 				Vector3f angular_acceleration_uncalibrated;
 
-				float raw_data_array[] {sensor_data.x, sensor_data.y, sensor_data.z};
+				// copy sensor sample to float arrays for filtering
+				float data_x[1] {sensor_data.x};
+				float data_y[1] {sensor_data.y};
+				float data_z[1] {sensor_data.z};
+				float *const data[3] {data_x, data_y, data_z};
 
-				for (int axis = 0; axis < 3; axis++) {
-					// copy sensor sample to float array for filtering
-					float data[1] {raw_data_array[axis]};
+				FilterAngularVelocity(data);
 
+				for (int axis = 0; axis < 3; axis++) {
 					// save last filtered sample
-					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data);
-					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data);
+					angular_velocity_uncalibrated(axis) = data[axis][0];
+					angular_acceleration_uncalibrated(axis) = FilterAngularAcceleration(axis, inverse_dt_s, data[axis]);
 				}
 
 				// Publish
@@ -942,9 +1126,18 @@ void VehicleAngularVelocity::PrintStatus()
 
 	_calibration.PrintStatus();
 
+	if (_filter_cascade_samples > 0) {
+		const double filter_time_us = (double)perf_mean(_filter_cascade_perf) * perf_event_count(_filter_cascade_perf) * 1e6;
+		PX4_INFO_RAW("[vehicle_angular_velocity] filter cascade: %d/%d stages active, %.3f us/sample\n",
+			     _filter_cascade.activeStages(), _filter_cascade.stages(), filter_time_us / _filter_cascade_samples);
+	}
+
 	perf_print_counter(_cycle_perf);
 	perf_print_counter(_filter_reset_perf);
 	perf_print_counter(_selection_changed_perf);
+	perf_print_counter(_filter_cascade_perf);
+	perf_print_counter(_fifo_ring_overrun_perf);
+	perf_print_counter(_fifo_ring_stale_perf);
 #if !defined(CONSTRAINED_FLASH)
 	perf_print_counter(_dynamic_notch_filter_esc_rpm_disable_perf);
 	perf_print_counter(_dynamic_notch_filter_esc_rpm_update_perf);
@@ -35,9 +35,11 @@
 
 #include <containers/Bitset.hpp>
 #include <lib/sensor_calibration/Gyroscope.hpp>
+#include <lib/drivers/gyroscope/GyroFIFORing.hpp>
 #include <lib/mathlib/math/Limits.hpp>
 #include <lib/matrix/matrix/math.hpp>
 #include <lib/mathlib/math/filter/AlphaFilter.hpp>
+#include <lib/mathlib/math/filter/BiquadCascade.hpp>
 #include <lib/mathlib/math/filter/LowPassFilter2p.hpp>
 #include <lib/mathlib/math/filter/NotchFilter.hpp>
 #include <px4_platform_common/log.h>
@@ -79,13 +81,22 @@ private:
 	bool CalibrateAndPublish(const hrt_abstime &timestamp_sample, const matrix::Vector3f &angular_velocity_uncalibrated,
 				 const matrix::Vector3f &angular_acceleration_uncalibrated);
 
-	inline float FilterAngularVelocity(int axis, float data[], int N = 1);
+	inline bool FIFORingValid();
+	inline const sensor_gyro_fifo_s *NextFIFO(sensor_gyro_fifo_s &buffer);
+	inline bool ReleaseFIFO();
+	inline bool FIFOUpdated();
+
+	inline void FilterAngularVelocity(float *const data[3], int N = 1);
 	inline float FilterAngularAcceleration(int axis, float inverse_dt_s, float data[], int N = 1);
 
 	void DisableDynamicNotchEscRpm();
 	void DisableDynamicNotchFFT();
 	void ParametersUpdate(bool force = false);
 
+	bool AllocateFilterCascade();
+	void UpdateFilterCascade();
+	void UpdateFilterCascadeStage(int stage, int axis, math::NotchFilter<float> &notch_filter, bool enabled);
+
 	void ResetFilters(const hrt_abstime &time_now_us);
 	void SensorBiasUpdate(bool force = false);
 	bool SensorSelectionUpdate(const hrt_abstime &time_now_us, bool force = false);
@@ -114,6 +125,7 @@ private:
 	uORB::SubscriptionCallbackWorkItem _sensor_selection_sub{this, ORB_ID(sensor_selection)};
 	uORB::SubscriptionCallbackWorkItem _sensor_sub{this, ORB_ID(sensor_gyro)};
 	uORB::SubscriptionCallbackWorkItem _sensor_gyro_fifo_sub{this, ORB_ID(sensor_gyro_fifo)};
+	GyroFIFORing::Reader _fifo_ring_reader{};
 
 	calibration::Gyroscope _calibration{};
 
@@ -153,6 +165,7 @@ private:
 	int _esc_rpm_harmonics{0};
 	px4::Bitset<MAX_NUM_ESCS> _esc_available{};
 	hrt_abstime _last_esc_rpm_notch_update[MAX_NUM_ESCS] {};
+	float _esc_rpm_notch_hz[MAX_NUM_ESCS] {}; // ESC frequency of the last notch update
 
 	perf_counter_t _dynamic_notch_filter_esc_rpm_update_perf{nullptr};
 	perf_counter_t _dynamic_notch_filter_esc_rpm_disable_perf{nullptr};
@@ -169,6 +182,12 @@ private:
 	bool _dynamic_notch_fft_available{false};
 #endif // !CONSTRAINED_FLASH
 
+	// all angular velocity filters above applied as a single cascade (filter order), the filter objects
+	// are used to compute the coefficients and the cascade holds the filter state
+	math::BiquadCascade _filter_cascade{};
+	bool _filter_cascade_update{true};
+	uint64_t _filter_cascade_samples{0};
+
 	// angular acceleration filter
 	AlphaFilter<float> _lp_filter_acceleration[3] {};
 
@@ -181,6 +200,9 @@ private:
 	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": gyro filter")};
 	perf_counter_t _filter_reset_perf{perf_alloc(PC_COUNT, MODULE_NAME": gyro filter reset")};
 	perf_counter_t _selection_changed_perf{perf_alloc(PC_COUNT, MODULE_NAME": gyro selection changed")};
+	perf_counter_t _filter_cascade_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": gyro filter cascade")};
+	perf_counter_t _fifo_ring_overrun_perf{perf_alloc(PC_COUNT, MODULE_NAME": gyro FIFO ring overrun")};
+	perf_counter_t _fifo_ring_stale_perf{perf_alloc(PC_COUNT, MODULE_NAME": gyro FIFO ring stale")};
 
 	DEFINE_PARAMETERS(
 #if !defined(CONSTRAINED_FLASH)
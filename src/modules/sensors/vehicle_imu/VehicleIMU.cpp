@@ -47,20 +47,23 @@ using math::constrain;
 namespace sensors
 {
 
-VehicleIMU::VehicleIMU(int instance, uint8_t accel_index, uint8_t gyro_index, const px4::wq_config_t &config) :
+VehicleIMU::VehicleIMU(int instance, uint8_t accel_index, uint8_t gyro_index, const px4::wq_config_t &config,
+		       VehicleIMU *batch_leader) :
 	ModuleParams(nullptr),
 	ScheduledWorkItem(MODULE_NAME, config),
 	_sensor_accel_sub(ORB_ID(sensor_accel), accel_index),
-	_sensor_gyro_sub(this, ORB_ID(sensor_gyro), gyro_index),
-	_instance(instance)
+	_sensor_gyro_sub((batch_leader != nullptr) ? static_cast<px4::WorkItem *>(batch_leader) : this, ORB_ID(sensor_gyro),
+			 gyro_index),
+	_instance(instance),
+	_batch_leader(batch_leader)
 {
 	_imu_integration_interval_us = 1e6f / _param_imu_integ_rate.get();
 
-	_accel_integrator.set_reset_interval(_imu_integration_interval_us);
-	_accel_integrator.set_reset_samples(sensor_accel_s::ORB_QUEUE_LENGTH);
+	_accel_integrator.set_reset_interval(CHANNEL_IMU, _imu_integration_interval_us);
+	_accel_integrator.set_reset_samples(CHANNEL_IMU, sensor_accel_s::ORB_QUEUE_LENGTH);
 
-	_gyro_integrator.set_reset_interval(_imu_integration_interval_us);
-	_gyro_integrator.set_reset_samples(sensor_gyro_s::ORB_QUEUE_LENGTH);
+	_gyro_integrator.set_reset_interval(CHANNEL_IMU, _imu_integration_interval_us);
+	_gyro_integrator.set_reset_samples(CHANNEL_IMU, sensor_gyro_s::ORB_QUEUE_LENGTH);
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 	// currently with lockstep every raw sample needs a corresponding vehicle_imu publication
@@ -73,6 +76,10 @@ VehicleIMU::VehicleIMU(int instance, uint8_t accel_index, uint8_t gyro_index, co
 	// advertise immediately to ensure consistent ordering
 	_vehicle_imu_pub.advertise();
 	_vehicle_imu_status_pub.advertise();
+
+	if (_param_imu_integ_fast.get() > 0) {
+		_vehicle_imu_fast_pub.advertise();
+	}
 }
 
 VehicleIMU::~VehicleIMU()
@@ -84,6 +91,10 @@ VehicleIMU::~VehicleIMU()
 
 	_vehicle_imu_pub.unadvertise();
 	_vehicle_imu_status_pub.unadvertise();
+
+	if (_vehicle_imu_fast_pub.advertised()) {
+		_vehicle_imu_fast_pub.unadvertise();
+	}
 }
 
 bool VehicleIMU::Start()
@@ -96,11 +107,36 @@ bool VehicleIMU::Start()
 	return true;
 }
 
+bool VehicleIMU::AddBatchedInstance(VehicleIMU *imu)
+{
+	const int batched_count = _batched_count.load();
+
+	if ((imu == nullptr) || (imu->_batch_leader != this) || (batched_count >= MAX_BATCHED_INSTANCES)) {
+		return false;
+	}
+
+	// force initial updates, the instance is then only updated from this work item
+	imu->ParametersUpdate(true);
+
+	// its gyro callback schedules this work item
+	imu->_sensor_gyro_sub.registerCallback();
+
+	// publish the instance before the count (read concurrently in Run())
+	_batched_instances[batched_count] = imu;
+	_batched_count.store(batched_count + 1);
+
+	return true;
+}
+
 void VehicleIMU::Stop()
 {
-	// clear all registered callbacks
+	// clear all registered callbacks, including the ones of batched instances scheduling this work item
 	_sensor_gyro_sub.unregisterCallback();
 
+	for (int i = 0; i < _batched_count.load(); i++) {
+		_batched_instances[i]->_sensor_gyro_sub.unregisterCallback();
+	}
+
 	Deinit();
 }
 
@@ -115,6 +151,7 @@ bool VehicleIMU::ParametersUpdate(bool force)
 		_parameter_update_sub.copy(&param_update);
 
 		const auto imu_integ_rate_prev = _param_imu_integ_rate.get();
+		const auto imu_integ_fast_prev = _param_imu_integ_fast.get();
 
 		updateParams();
 
@@ -156,7 +193,23 @@ bool VehicleIMU::ParametersUpdate(bool force)
 
 		_imu_integration_interval_us = 1e6f / imu_integration_rate_hz;
 
-		if (_param_imu_integ_rate.get() != imu_integ_rate_prev) {
+		// high rate vehicle_imu_fast (if enabled) at least at the vehicle_imu rate, at most 4 kHz
+		if (_param_imu_integ_fast.get() > 0) {
+			const int32_t imu_fast_rate_hz = constrain(_param_imu_integ_fast.get(), imu_integration_rate_hz, (int32_t)4000);
+
+			if (imu_fast_rate_hz != _param_imu_integ_fast.get()) {
+				PX4_WARN("IMU_INTEG_FAST updated %" PRId32 " -> %" PRIu32, _param_imu_integ_fast.get(), imu_fast_rate_hz);
+				_param_imu_integ_fast.set(imu_fast_rate_hz);
+				_param_imu_integ_fast.commit_no_notification();
+			}
+
+			_imu_fast_integration_interval_us = 1e6f / imu_fast_rate_hz;
+
+		} else {
+			_imu_fast_integration_interval_us = 0;
+		}
+
+		if ((_param_imu_integ_rate.get() != imu_integ_rate_prev) || (_param_imu_integ_fast.get() != imu_integ_fast_prev)) {
 			// force update
 			_update_integrator_config = true;
 		}
@@ -167,19 +220,49 @@ bool VehicleIMU::ParametersUpdate(bool force)
 
 void VehicleIMU::Run()
 {
-	const hrt_abstime now_us = hrt_absolute_time();
+	// backup schedule
+	ScheduleDelayed(UpdateAll(hrt_absolute_time()));
+}
+
+hrt_abstime VehicleIMU::UpdateAll(const hrt_abstime &now_us)
+{
+	hrt_abstime backup_schedule_us = UpdateInstance(now_us) ? _backup_schedule_timeout_us : 1_s;
 
+	// batched mode: process the other IMU instances in the same cycle. Only the scheduling is shared,
+	// every instance is still calibrated, integrated and published on its own exactly as if it had its
+	// own work item. The gyro callback of every instance schedules this work item, so an instance that
+	// fails or stops publishing (including this one) doesn't change the update rate of the others.
+	const int batched_count = _batched_count.load();
+
+	for (int i = 0; i < batched_count; i++) {
+		VehicleIMU *imu = _batched_instances[i];
+
+		if (imu->UpdateInstance(now_us)) {
+			backup_schedule_us = math::min(backup_schedule_us, (hrt_abstime)imu->_backup_schedule_timeout_us);
+		}
+	}
+
+	return backup_schedule_us;
+}
+
+bool VehicleIMU::UpdateInstance(const hrt_abstime &now_us)
+{
+	if (Update(now_us)) {
+		return true;
+	}
+
+	_sensor_gyro_sub.unregisterCallback();
+	return false;
+}
+
+bool VehicleIMU::Update(const hrt_abstime &now_us)
+{
 	const bool parameters_updated = ParametersUpdate();
 
 	if (!_accel_calibration.enabled() || !_gyro_calibration.enabled()) {
-		_sensor_gyro_sub.unregisterCallback();
-		ScheduleDelayed(1_s);
-		return;
+		return false;
 	}
 
-	// backup schedule
-	ScheduleDelayed(_backup_schedule_timeout_us);
-
 	// check vehicle status for changes to armed state
 	if (_vehicle_control_mode_sub.updated()) {
 		vehicle_control_mode_s vehicle_control_mode;
@@ -209,7 +292,7 @@ void VehicleIMU::Run()
 		}
 
 		// update gyro until integrator ready and not falling behind
-		if (!_gyro_integrator.integral_ready() || consume_all_gyro) {
+		if (!_gyro_integrator.integral_ready(CHANNEL_IMU) || consume_all_gyro) {
 			if (UpdateGyro()) {
 				updated = true;
 			}
@@ -218,7 +301,7 @@ void VehicleIMU::Run()
 
 		// update accel until integrator ready and caught up to gyro
 		while (_sensor_accel_sub.updated()
-		       && (!_accel_integrator.integral_ready() || !_intervals_configured || _data_gap
+		       && (!_accel_integrator.integral_ready(CHANNEL_IMU) || !_intervals_configured || _data_gap
 			   || (_accel_timestamp_sample_last < (_gyro_timestamp_sample_last - 0.5f * _accel_interval_us)))) {
 
 			if (UpdateAccel()) {
@@ -236,8 +319,16 @@ void VehicleIMU::Run()
 			continue;
 		}
 
+		// publish vehicle_imu_fast whenever its channel is ready, independent of vehicle_imu
+		if (_intervals_configured && (_imu_fast_integration_interval_us > 0)
+		    && _accel_integrator.integral_ready(CHANNEL_FAST) && _gyro_integrator.integral_ready(CHANNEL_FAST)) {
+
+			PublishFast();
+		}
+
 		// publish if both accel & gyro integrators are ready
-		if (_intervals_configured && _accel_integrator.integral_ready() && _gyro_integrator.integral_ready()) {
+		if (_intervals_configured && _accel_integrator.integral_ready(CHANNEL_IMU)
+		    && _gyro_integrator.integral_ready(CHANNEL_IMU)) {
 			if (Publish()) {
 				// record gyro publication latency and integrated samples
 				if (_gyro_update_latency_mean.count() > 10000) {
@@ -271,6 +362,8 @@ void VehicleIMU::Run()
 			SensorCalibrationSaveGyro();
 		}
 	}
+
+	return true;
 }
 
 bool VehicleIMU::UpdateAccel()
@@ -394,14 +487,17 @@ bool VehicleIMU::UpdateAccel()
 
 			if (clip_x > 0) {
 				_delta_velocity_clipping |= vehicle_imu_s::CLIPPING_X;
+				_delta_velocity_clipping_fast |= vehicle_imu_s::CLIPPING_X;
 			}
 
 			if (clip_y > 0) {
 				_delta_velocity_clipping |= vehicle_imu_s::CLIPPING_Y;
+				_delta_velocity_clipping_fast |= vehicle_imu_s::CLIPPING_Y;
 			}
 
 			if (clip_z > 0) {
 				_delta_velocity_clipping |= vehicle_imu_s::CLIPPING_Z;
+				_delta_velocity_clipping_fast |= vehicle_imu_s::CLIPPING_Z;
 			}
 
 			_publish_status = true;
@@ -592,10 +688,10 @@ bool VehicleIMU::Publish()
 	Vector3f delta_angle;
 	Vector3f delta_velocity;
 
-	const Vector3f accumulated_coning_corrections = _gyro_integrator.accumulated_coning_corrections();
+	const Vector3f accumulated_coning_corrections = _gyro_integrator.accumulated_coning_corrections(CHANNEL_IMU);
 
-	if (_accel_integrator.reset(delta_velocity, imu.delta_velocity_dt)
-	    && _gyro_integrator.reset(delta_angle, imu.delta_angle_dt)) {
+	if (_accel_integrator.reset(CHANNEL_IMU, delta_velocity, imu.delta_velocity_dt)
+	    && _gyro_integrator.reset(CHANNEL_IMU, delta_angle, imu.delta_angle_dt)) {
 
 		if (_accel_calibration.enabled() && _gyro_calibration.enabled()) {
 
@@ -682,6 +778,41 @@ bool VehicleIMU::Publish()
 	return updated;
 }
 
+bool VehicleIMU::PublishFast()
+{
+	vehicle_imu_s imu{};
+	Vector3f delta_angle;
+	Vector3f delta_velocity;
+
+	if (_accel_integrator.reset(CHANNEL_FAST, delta_velocity, imu.delta_velocity_dt)
+	    && _gyro_integrator.reset(CHANNEL_FAST, delta_angle, imu.delta_angle_dt)) {
+
+		// apply the same corrections as vehicle_imu (sensor corrections are updated in Publish())
+		const float gyro_dt_s = 1.e-6f * imu.delta_angle_dt;
+		const Vector3f delta_angle_corrected{_gyro_calibration.Correct(delta_angle / gyro_dt_s) * gyro_dt_s};
+
+		const float accel_dt_s = 1.e-6f * imu.delta_velocity_dt;
+		const Vector3f delta_velocity_corrected{_accel_calibration.Correct(delta_velocity / accel_dt_s) * accel_dt_s};
+
+		imu.timestamp_sample = _gyro_timestamp_sample_last;
+		imu.accel_device_id = _accel_calibration.device_id();
+		imu.gyro_device_id = _gyro_calibration.device_id();
+		delta_angle_corrected.copyTo(imu.delta_angle);
+		delta_velocity_corrected.copyTo(imu.delta_velocity);
+		imu.delta_velocity_clipping = _delta_velocity_clipping_fast;
+		imu.accel_calibration_count = _accel_calibration.calibration_count();
+		imu.gyro_calibration_count = _gyro_calibration.calibration_count();
+		imu.timestamp = hrt_absolute_time();
+		_vehicle_imu_fast_pub.publish(imu);
+
+		_delta_velocity_clipping_fast = 0;
+
+		return true;
+	}
+
+	return false;
+}
+
 void VehicleIMU::UpdateIntegratorConfiguration()
 {
 	if (PX4_ISFINITE(_accel_interval_us) && PX4_ISFINITE(_gyro_interval_us)) {
@@ -701,22 +832,41 @@ void VehicleIMU::UpdateIntegratorConfiguration()
 
 		// let the gyro set the configuration and scheduling
 		// relaxed minimum integration time required
-		_accel_integrator.set_reset_interval(roundf((accel_integral_samples - 0.5f) * _accel_interval_us));
-		_accel_integrator.set_reset_samples(accel_integral_samples);
+		_accel_integrator.set_reset_interval(CHANNEL_IMU, roundf((accel_integral_samples - 0.5f) * _accel_interval_us));
+		_accel_integrator.set_reset_samples(CHANNEL_IMU, accel_integral_samples);
 
-		_gyro_integrator.set_reset_interval(roundf((gyro_integral_samples - 0.5f) * _gyro_interval_us));
-		_gyro_integrator.set_reset_samples(gyro_integral_samples);
+		_gyro_integrator.set_reset_interval(CHANNEL_IMU, roundf((gyro_integral_samples - 0.5f) * _gyro_interval_us));
+		_gyro_integrator.set_reset_samples(CHANNEL_IMU, gyro_integral_samples);
+
+		// schedule on the gyro samples of the fastest published channel
+		uint8_t schedule_samples = gyro_integral_samples;
+
+		if (_imu_fast_integration_interval_us > 0) {
+			// high rate channel: same configuration as above, at most one vehicle_imu interval
+			const uint8_t gyro_fast_samples = math::constrain((int)roundf(_imu_fast_integration_interval_us / _gyro_interval_us),
+							  1, (int)gyro_integral_samples);
+			const uint32_t fast_interval_us = roundf(gyro_fast_samples * _gyro_interval_us);
+			const uint8_t accel_fast_samples = math::max(1, (int)roundf(fast_interval_us / _accel_interval_us));
+
+			_accel_integrator.set_reset_interval(CHANNEL_FAST, roundf((accel_fast_samples - 0.5f) * _accel_interval_us));
+			_accel_integrator.set_reset_samples(CHANNEL_FAST, accel_fast_samples);
+
+			_gyro_integrator.set_reset_interval(CHANNEL_FAST, roundf((gyro_fast_samples - 0.5f) * _gyro_interval_us));
+			_gyro_integrator.set_reset_samples(CHANNEL_FAST, gyro_fast_samples);
+
+			schedule_samples = gyro_fast_samples;
+		}
 
 		_backup_schedule_timeout_us = math::constrain((int)math::min(sensor_accel_s::ORB_QUEUE_LENGTH * _accel_interval_us,
 					      sensor_gyro_s::ORB_QUEUE_LENGTH * _gyro_interval_us) / 2, 1000, 20000);
 
 		// gyro: find largest integer multiple of gyro_integral_samples
 		for (int n = sensor_gyro_s::ORB_QUEUE_LENGTH; n > 0; n--) {
-			if (gyro_integral_samples > sensor_gyro_s::ORB_QUEUE_LENGTH) {
-				gyro_integral_samples /= 2;
+			if (schedule_samples > sensor_gyro_s::ORB_QUEUE_LENGTH) {
+				schedule_samples /= 2;
 			}
 
-			if (gyro_integral_samples % n == 0) {
+			if (schedule_samples % n == 0) {
 				_sensor_gyro_sub.set_required_updates(n);
 				_sensor_gyro_sub.registerCallback();
 
@@ -760,6 +910,10 @@ void VehicleIMU::PrintStatus()
 		     _accel_calibration.device_id(), (double)_accel_interval_us, (double)sqrtf(_accel_interval_best_variance),
 		     _gyro_calibration.device_id(), (double)_gyro_interval_us, (double)sqrtf(_gyro_interval_best_variance));
 
+	if (_batched_count.load() > 0) {
+		PX4_INFO_RAW("[vehicle_imu] %" PRIu8 " - batched instances: %d\n", _instance, _batched_count.load());
+	}
+
 	PX4_DEBUG("gyro update mean sample latency: %.6f s, publish latency %.6f s, gyro interval %.6f s",
 		  (double)_gyro_update_latency_mean.mean()(0), (double)_gyro_update_latency_mean.mean()(1),
 		  (double)(_gyro_interval_us * 1e-6f));
@@ -41,6 +41,7 @@
 #include <lib/perf/perf_counter.h>
 #include <lib/sensor_calibration/Accelerometer.hpp>
 #include <lib/sensor_calibration/Gyroscope.hpp>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/px4_config.h>
@@ -59,6 +60,8 @@
 
 using namespace time_literals;
 
+class VehicleIMUTest;
+
 namespace sensors
 {
 
@@ -66,19 +69,36 @@ class VehicleIMU : public ModuleParams, public px4::ScheduledWorkItem
 {
 public:
 	VehicleIMU() = delete;
-	VehicleIMU(int instance, uint8_t accel_index, uint8_t gyro_index, const px4::wq_config_t &config);
+	/**
+	 * @param batch_leader batched mode: instance that processes this one in its work item (see AddBatchedInstance())
+	 */
+	VehicleIMU(int instance, uint8_t accel_index, uint8_t gyro_index, const px4::wq_config_t &config,
+		   VehicleIMU *batch_leader = nullptr);
 
 	~VehicleIMU() override;
 
 	bool Start();
 	void Stop();
 
+	/**
+	 * Batched mode: process another (not started) instance, created with this instance as batch_leader,
+	 * in the work item of this instance. The gyro updates of every instance schedule the work item.
+	 * Only the scheduling is shared, the published vehicle_imu of every instance is unchanged.
+	 */
+	bool AddBatchedInstance(VehicleIMU *imu);
+
 	void PrintStatus();
 
 private:
+	friend class ::VehicleIMUTest;
+
 	bool ParametersUpdate(bool force = false);
 	bool Publish();
+	bool PublishFast();
 	void Run() override;
+	bool Update(const hrt_abstime &now_us);
+	hrt_abstime UpdateAll(const hrt_abstime &now_us); // this and all batched instances, returns backup schedule
+	bool UpdateInstance(const hrt_abstime &now_us);
 
 	bool UpdateAccel();
 	bool UpdateGyro();
@@ -93,6 +113,7 @@ private:
 	void SensorCalibrationSaveGyro();
 
 	uORB::PublicationMulti<vehicle_imu_s> _vehicle_imu_pub{ORB_ID(vehicle_imu)};
+	uORB::PublicationMulti<vehicle_imu_s> _vehicle_imu_fast_pub{ORB_ID(vehicle_imu_fast)};
 	uORB::PublicationMulti<vehicle_imu_status_s> _vehicle_imu_status_pub{ORB_ID(vehicle_imu_status)};
 
 	uORB::SubscriptionInterval _parameter_update_sub{ORB_ID(parameter_update), 1_s};
@@ -108,10 +129,15 @@ private:
 	calibration::Accelerometer _accel_calibration{};
 	calibration::Gyroscope _gyro_calibration{};
 
-	sensors::Integrator       _accel_integrator{};
-	sensors::IntegratorConing _gyro_integrator{};
+	// integrator output channels: vehicle_imu and the optional high rate vehicle_imu_fast
+	static constexpr size_t CHANNEL_IMU{0};
+	static constexpr size_t CHANNEL_FAST{1};
+
+	sensors::IntegratorMultiRate<2>       _accel_integrator{};
+	sensors::IntegratorConingMultiRate<2> _gyro_integrator{};
 
 	uint32_t _imu_integration_interval_us{5000};
+	uint32_t _imu_fast_integration_interval_us{0}; // 0 if vehicle_imu_fast is disabled
 
 	hrt_abstime _accel_timestamp_sample_last{0};
 	hrt_abstime _gyro_timestamp_sample_last{0};
@@ -150,6 +176,7 @@ private:
 
 	uint8_t     _delta_angle_clipping{0};
 	uint8_t     _delta_velocity_clipping{0};
+	uint8_t     _delta_velocity_clipping_fast{0};
 
 	hrt_abstime _last_accel_clipping_notify_time{0};
 	hrt_abstime _last_gyro_clipping_notify_time{0};
@@ -168,6 +195,12 @@ private:
 
 	const uint8_t _instance;
 
+	static constexpr int MAX_BATCHED_INSTANCES = ORB_MULTI_MAX_INSTANCES - 1;
+
+	VehicleIMU *_batched_instances[MAX_BATCHED_INSTANCES] {};
+	px4::atomic<int> _batched_count{0};
+	VehicleIMU *const _batch_leader; // batched mode: updated from the work item of this instance
+
 	bool _armed{false};
 
 	bool _accel_cal_available{false};
@@ -191,6 +224,7 @@ private:
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::IMU_INTEG_RATE>) _param_imu_integ_rate,
+		(ParamInt<px4::params::IMU_INTEG_FAST>) _param_imu_integ_fast,
 		(ParamBool<px4::params::SENS_IMU_AUTOCAL>) _param_sens_imu_autocal
 	)
 };
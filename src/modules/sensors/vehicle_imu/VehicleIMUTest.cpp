@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * Test that batched (SENS_IMU_BATCH) and separately scheduled VehicleIMU instances publish identical vehicle_imu.
+ *
+ * to run: make tests TESTFILTER=VehicleIMU
+ */
+
+#define MODULE_NAME "vehicle_imu"
+
+#include <gtest/gtest.h>
+#include "VehicleIMU.hpp"
+
+#include <uORB/PublicationMulti.hpp>
+
+using namespace sensors;
+using namespace time_literals;
+
+static constexpr int IMUS = 2;
+
+class VehicleIMUTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		param_control_autosave(false);
+		param_reset_all();
+
+		// advertise in order so that sensor_accel/sensor_gyro instance i is IMU i
+		for (int i = 0; i < IMUS; i++) {
+			_sensor_accel_pub[i].advertise();
+			_sensor_gyro_pub[i].advertise();
+		}
+	}
+
+	// run a cycle of the work item of imu (including its batched instances) without scheduling
+	static void update(VehicleIMU &imu, const hrt_abstime &now_us) { imu.UpdateAll(now_us); }
+
+	// publish one 1 kHz accel and gyro sample of an IMU
+	void publishSample(int imu, int n, const hrt_abstime &timestamp_sample)
+	{
+		const float t = n * 1e-3f;
+
+		sensor_accel_s accel{};
+		accel.timestamp_sample = timestamp_sample;
+		accel.device_id = 1 + imu;
+		accel.x = 0.5f * sinf(20.f * t + imu);
+		accel.y = 0.3f * cosf(13.f * t);
+		accel.z = -9.81f + 0.2f * sinf(7.f * t);
+		accel.temperature = 25.f;
+		accel.samples = 1;
+		accel.timestamp = timestamp_sample;
+		_sensor_accel_pub[imu].publish(accel);
+
+		sensor_gyro_s gyro{};
+		gyro.timestamp_sample = timestamp_sample;
+		gyro.device_id = 11 + imu;
+		gyro.x = sinf(10.f * t + imu);
+		gyro.y = cosf(7.f * t);
+		gyro.z = 0.5f * sinf(3.f * t + 1.f);
+		gyro.temperature = 25.f;
+		gyro.samples = 1;
+		gyro.timestamp = timestamp_sample;
+		_sensor_gyro_pub[imu].publish(gyro);
+	}
+
+	uORB::PublicationMulti<sensor_accel_s> _sensor_accel_pub[IMUS] {{ORB_ID(sensor_accel)}, {ORB_ID(sensor_accel)}};
+	uORB::PublicationMulti<sensor_gyro_s> _sensor_gyro_pub[IMUS] {{ORB_ID(sensor_gyro)}, {ORB_ID(sensor_gyro)}};
+};
+
+TEST_F(VehicleIMUTest, BatchedMatchesSeparate)
+{
+	// GIVEN: the batched IMUs (vehicle_imu instance 0 and 1) and the same IMUs with separate work items (instance 2 and 3)
+	VehicleIMU *batch_leader = new VehicleIMU(0, 0, 0, px4::wq_configurations::INS0);
+	VehicleIMU *batched = new VehicleIMU(1, 1, 1, px4::wq_configurations::INS0, batch_leader);
+	VehicleIMU *separate[IMUS] {
+		new VehicleIMU(2, 0, 0, px4::wq_configurations::INS0),
+		new VehicleIMU(3, 1, 1, px4::wq_configurations::INS0)
+	};
+
+	ASSERT_TRUE(batch_leader->Start());
+	ASSERT_TRUE(batch_leader->AddBatchedInstance(batched));
+	ASSERT_TRUE(separate[0]->Start());
+	ASSERT_TRUE(separate[1]->Start());
+
+	uORB::Subscription vehicle_imu_sub[2 * IMUS] {
+		{ORB_ID(vehicle_imu), 0}, {ORB_ID(vehicle_imu), 1},
+		{ORB_ID(vehicle_imu), 2}, {ORB_ID(vehicle_imu), 3}
+	};
+
+	int publications[IMUS] {};
+	hrt_abstime timestamp_sample = 1_s;
+
+	for (int n = 0; n < 2000; n++) {
+		timestamp_sample += 1_ms;
+
+		for (int imu = 0; imu < IMUS; imu++) {
+			publishSample(imu, n, timestamp_sample);
+		}
+
+		// WHEN: both are run at the same time every 5 samples (one 200 Hz vehicle_imu interval)
+		if (n % 5 == 4) {
+			const hrt_abstime now_us = timestamp_sample + 100;
+			update(*batch_leader, now_us);
+			update(*separate[0], now_us);
+			update(*separate[1], now_us);
+
+			// THEN: every IMU publishes the same vehicle_imu in both modes
+			for (int imu = 0; imu < IMUS; imu++) {
+				vehicle_imu_s imu_batched{};
+				vehicle_imu_s imu_separate{};
+				const bool batched_updated = vehicle_imu_sub[imu].update(&imu_batched);
+				const bool separate_updated = vehicle_imu_sub[IMUS + imu].update(&imu_separate);
+
+				ASSERT_EQ(batched_updated, separate_updated);
+
+				if (batched_updated) {
+					publications[imu]++;
+
+					EXPECT_EQ(imu_batched.accel_device_id, 1u + imu);
+					EXPECT_EQ(imu_batched.timestamp_sample, imu_separate.timestamp_sample);
+					EXPECT_EQ(imu_batched.accel_device_id, imu_separate.accel_device_id);
+					EXPECT_EQ(imu_batched.gyro_device_id, imu_separate.gyro_device_id);
+					EXPECT_EQ(imu_batched.delta_angle_dt, imu_separate.delta_angle_dt);
+					EXPECT_EQ(imu_batched.delta_velocity_dt, imu_separate.delta_velocity_dt);
+					EXPECT_EQ(imu_batched.delta_velocity_clipping, imu_separate.delta_velocity_clipping);
+
+					for (int axis = 0; axis < 3; axis++) {
+						EXPECT_EQ(imu_batched.delta_angle[axis], imu_separate.delta_angle[axis]);
+						EXPECT_EQ(imu_batched.delta_velocity[axis], imu_separate.delta_velocity[axis]);
+					}
+				}
+			}
+		}
+	}
+
+	for (int imu = 0; imu < IMUS; imu++) {
+		EXPECT_GT(publications[imu], 300);
+	}
+
+	// the leader also stops the batched instance, delete it first (as in sensors)
+	delete batch_leader;
+	delete batched;
+	delete separate[0];
+	delete separate[1];
+}
@@ -49,6 +49,24 @@
 */
 PARAM_DEFINE_INT32(IMU_INTEG_RATE, 200);
 
+/**
+* IMU high rate integration rate.
+*
+* Additionally publish vehicle_imu_fast at this rate for high rate consumers. The raw IMU data is
+* integrated once for both vehicle_imu and vehicle_imu_fast. Constrained to at least IMU_INTEG_RATE.
+* Set to 0 to disable.
+*
+* @min 0
+* @max 4000
+* @value 0 Disabled
+* @value 500 500 Hz
+* @value 1000 1000 Hz
+* @unit Hz
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_INTEG_FAST, 0);
+
 /**
  * IMU auto calibration
  *
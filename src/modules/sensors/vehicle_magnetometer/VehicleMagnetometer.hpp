@@ -96,6 +96,7 @@ private:
 	void UpdatePowerCompensation();
 
 	static constexpr int MAX_SENSOR_COUNT = 4;
+	static_assert(MAX_SENSOR_COUNT <= DataValidatorGroup::MAX_VALIDATORS, "DataValidatorGroup too small");
 
 	uORB::Publication<sensors_status_s> _sensors_status_mag_pub{ORB_ID(sensors_status_mag)};
 
@@ -63,6 +63,7 @@ namespace sensors
 {
 
 static constexpr uint8_t MAX_SENSOR_COUNT = 4;
+static_assert(MAX_SENSOR_COUNT <= DataValidatorGroup::MAX_VALIDATORS, "DataValidatorGroup too small");
 
 /**
  ** class VotedSensorsUpdate
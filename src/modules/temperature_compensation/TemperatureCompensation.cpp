@@ -52,6 +52,8 @@ int TemperatureCompensation::initialize_parameter_handles(ParameterHandles &para
 	char nbuf[16] {};
 	int ret = PX4_ERROR;
 
+	parameter_handles.temperature_delta = param_find("TC_TEMP_DELTA");
+
 	/* rate gyro calibration parameters */
 	parameter_handles.gyro_tc_enable = param_find("TC_G_ENABLE");
 	int32_t gyro_tc_enabled = 0;
@@ -154,6 +156,8 @@ int TemperatureCompensation::parameters_update()
 		return ret;
 	}
 
+	param_get(parameter_handles.temperature_delta, &_parameters.temperature_delta);
+
 	/* rate gyro calibration parameters */
 	param_get(parameter_handles.gyro_tc_enable, &_parameters.gyro_tc_enable);
 
@@ -344,7 +348,12 @@ int TemperatureCompensation::set_sensor_id(uint32_t device_id, int topic_instanc
 {
 	for (int i = 0; i < sensor_count_max; ++i) {
 		if (device_id == (uint32_t)sensor_cal_data[i].ID) {
-			sensor_data.device_mapping[topic_instance] = i;
+			if (sensor_data.device_mapping[topic_instance] != i) {
+				sensor_data.device_mapping[topic_instance] = i;
+				// cached offsets belong to the previous mapping
+				sensor_data.last_temperature[topic_instance] = -100.0f;
+			}
+
 			return i;
 		}
 	}
@@ -366,16 +375,20 @@ int TemperatureCompensation::update_offsets_gyro(int topic_instance, float tempe
 		return -1;
 	}
 
-	// Calculate and update the offsets
-	calc_thermal_offsets_3D(_parameters.gyro_cal_data[mapping], temperature, offsets);
+	matrix::Vector3f &cached_offsets = _gyro_data.cached_offsets[topic_instance];
+	int ret = 1;
 
-	// Check if temperature delta is large enough to warrant a new publication
-	if (fabsf(temperature - _gyro_data.last_temperature[topic_instance]) > 1.0f) {
-		_gyro_data.last_temperature[topic_instance] = temperature;
-		return 2;
+	// The temperature changes slowly, only re-evaluate the polynomial once it moved enough
+	if (temperature_changed(_gyro_data, topic_instance, temperature)) {
+		float offsets_new[3];
+		calc_thermal_offsets_3D(_parameters.gyro_cal_data[mapping], temperature, offsets_new);
+		cached_offsets = matrix::Vector3f{offsets_new};
+		ret = 2;
 	}
 
-	return 1;
+	cached_offsets.copyTo(offsets);
+
+	return ret;
 }
 
 int TemperatureCompensation::update_offsets_accel(int topic_instance, float temperature, float *offsets)
@@ -392,16 +405,20 @@ int TemperatureCompensation::update_offsets_accel(int topic_instance, float temp
 		return -1;
 	}
 
-	// Calculate and update the offsets
-	calc_thermal_offsets_3D(_parameters.accel_cal_data[mapping], temperature, offsets);
+	matrix::Vector3f &cached_offsets = _accel_data.cached_offsets[topic_instance];
+	int ret = 1;
 
-	// Check if temperature delta is large enough to warrant a new publication
-	if (fabsf(temperature - _accel_data.last_temperature[topic_instance]) > 1.0f) {
-		_accel_data.last_temperature[topic_instance] = temperature;
-		return 2;
+	// The temperature changes slowly, only re-evaluate the polynomial once it moved enough
+	if (temperature_changed(_accel_data, topic_instance, temperature)) {
+		float offsets_new[3];
+		calc_thermal_offsets_3D(_parameters.accel_cal_data[mapping], temperature, offsets_new);
+		cached_offsets = matrix::Vector3f{offsets_new};
+		ret = 2;
 	}
 
-	return 1;
+	cached_offsets.copyTo(offsets);
+
+	return ret;
 }
 
 int TemperatureCompensation::update_offsets_baro(int topic_instance, float temperature, float *offsets)
@@ -418,16 +435,18 @@ int TemperatureCompensation::update_offsets_baro(int topic_instance, float tempe
 		return -1;
 	}
 
-	// Calculate and update the offsets
-	calc_thermal_offsets_1D(_parameters.baro_cal_data[mapping], temperature, *offsets);
+	float &cached_offset = _baro_data.cached_offsets[topic_instance](0);
+	int ret = 1;
 
-	// Check if temperature delta is large enough to warrant a new publication
-	if (fabsf(temperature - _baro_data.last_temperature[topic_instance]) > 1.0f) {
-		_baro_data.last_temperature[topic_instance] = temperature;
-		return 2;
+	// The temperature changes slowly, only re-evaluate the polynomial once it moved enough
+	if (temperature_changed(_baro_data, topic_instance, temperature)) {
+		calc_thermal_offsets_1D(_parameters.baro_cal_data[mapping], temperature, cached_offset);
+		ret = 2;
 	}
 
-	return 1;
+	*offsets = cached_offset;
+
+	return ret;
 }
 
 void TemperatureCompensation::print_status()
@@ -83,11 +83,13 @@ public:
 	 * @param topic_instance uORB topic instance
 	 * @param sensor_data input sensor data, output sensor data with applied corrections
 	 * @param temperature measured current temperature
+	 * The offsets are cached per topic instance and only recomputed once the temperature has changed
+	 * by more than TC_TEMP_DELTA since the last evaluation.
 	 * @param offsets returns offsets that were applied (length = 3, except for baro), depending on return value
 	 * @return -1: error: correction enabled, but no sensor mapping set (@see set_sendor_id_gyro)
 	 *         0: no changes (correction not enabled),
-	 *         1: corrections applied but no changes to offsets,
-	 *         2: corrections applied and offsets updated
+	 *         1: cached corrections applied, no changes to offsets,
+	 *         2: corrections recomputed and offsets updated
 	 */
 	int update_offsets_gyro(int topic_instance, float temperature, float *offsets);
 	int update_offsets_accel(int topic_instance, float temperature, float *offsets);
@@ -178,6 +180,8 @@ private:
 
 	// create a struct containing all thermal calibration parameters
 	struct Parameters {
+		float temperature_delta{1.f};
+
 		int32_t gyro_tc_enable{0};
 		SensorCalData3D gyro_cal_data[GYRO_COUNT_MAX] {};
 
@@ -190,6 +194,8 @@ private:
 
 	// create a struct containing the handles required to access all calibration parameters
 	struct ParameterHandles {
+		param_t temperature_delta{PARAM_INVALID};
+
 		param_t gyro_tc_enable{PARAM_INVALID};
 		SensorCalHandles3D gyro_cal_handles[GYRO_COUNT_MAX] {};
 
@@ -268,13 +274,25 @@ private:
 		}
 
 		uint8_t device_mapping[SENSOR_COUNT_MAX] {}; /// map a topic instance to the parameters index
-		float last_temperature[SENSOR_COUNT_MAX] {};
+		float last_temperature[SENSOR_COUNT_MAX] {}; /// temperature at which cached_offsets were evaluated
+		matrix::Vector3f cached_offsets[SENSOR_COUNT_MAX] {}; /// offsets at last_temperature (baro uses x only)
 	};
 
 	PerSensorData _gyro_data;
 	PerSensorData _accel_data;
 	PerSensorData _baro_data;
 
+	/** @return true (and latch the temperature) if the cached offsets of a topic instance need to be recomputed */
+	bool temperature_changed(PerSensorData &sensor_data, int topic_instance, float temperature)
+	{
+		if (fabsf(temperature - sensor_data.last_temperature[topic_instance]) > _parameters.temperature_delta) {
+			sensor_data.last_temperature[topic_instance] = temperature;
+			return true;
+		}
+
+		return false;
+	}
+
 	template<typename T>
 	static inline int set_sensor_id(uint32_t device_id, int topic_instance, PerSensorData &sensor_data,
 					const T *sensor_cal_data, uint8_t sensor_count_max);
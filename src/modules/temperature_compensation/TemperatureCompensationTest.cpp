@@ -0,0 +1,177 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * Test the caching of the thermal compensation offsets (TC_TEMP_DELTA).
+ *
+ * to run: make tests TESTFILTER=TemperatureCompensation
+ */
+
+#include <gtest/gtest.h>
+#include "TemperatureCompensation.h"
+
+using namespace temperature_compensation;
+
+static constexpr uint32_t GYRO0_DEVICE_ID = 0x100;
+static constexpr uint32_t GYRO1_DEVICE_ID = 0x200;
+static constexpr uint32_t BARO0_DEVICE_ID = 0x300;
+
+static constexpr int RECOMPUTED = 2;
+static constexpr int CACHED = 1;
+
+class TemperatureCompensationTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		param_control_autosave(false);
+		param_reset_all();
+
+		setInt("TC_G_ENABLE", 1);
+		setGyro(0, GYRO0_DEVICE_ID, 0.1f);
+		setGyro(1, GYRO1_DEVICE_ID, -0.2f);
+
+		setInt("TC_B_ENABLE", 1);
+		setInt("TC_B0_ID", BARO0_DEVICE_ID);
+		setFloat("TC_B0_X1", 10.f);
+		setFloat("TC_B0_TREF", 25.f);
+		setFloat("TC_B0_TMIN", 0.f);
+		setFloat("TC_B0_TMAX", 60.f);
+
+		setFloat("TC_TEMP_DELTA", 1.f);
+	}
+
+	static void setInt(const char *name, int32_t value) { param_set(param_find(name), &value); }
+	static void setFloat(const char *name, float value) { param_set(param_find(name), &value); }
+
+	// linear offset x1 * (T - 25) on the X axis only
+	static void setGyro(int index, uint32_t device_id, float x1)
+	{
+		char name[16];
+		sprintf(name, "TC_G%d_ID", index);
+		setInt(name, device_id);
+		sprintf(name, "TC_G%d_X1_0", index);
+		setFloat(name, x1);
+		sprintf(name, "TC_G%d_TREF", index);
+		setFloat(name, 25.f);
+		sprintf(name, "TC_G%d_TMIN", index);
+		setFloat(name, 0.f);
+		sprintf(name, "TC_G%d_TMAX", index);
+		setFloat(name, 60.f);
+	}
+
+	TemperatureCompensation _temperature_compensation;
+};
+
+TEST_F(TemperatureCompensationTest, ReusedBelowTemperatureDelta)
+{
+	_temperature_compensation.parameters_update();
+	ASSERT_EQ(_temperature_compensation.set_sensor_id_gyro(GYRO0_DEVICE_ID, 0), 0);
+
+	float offsets[3] {};
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 30.f, offsets), RECOMPUTED);
+	EXPECT_FLOAT_EQ(offsets[0], 0.5f);
+	EXPECT_FLOAT_EQ(offsets[1], 0.f);
+
+	// within TC_TEMP_DELTA of the last evaluation: the offsets of 30 degrees are reused
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 30.9f, offsets), CACHED);
+	EXPECT_FLOAT_EQ(offsets[0], 0.5f);
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 29.1f, offsets), CACHED);
+	EXPECT_FLOAT_EQ(offsets[0], 0.5f);
+}
+
+TEST_F(TemperatureCompensationTest, RecomputedAboveTemperatureDelta)
+{
+	_temperature_compensation.parameters_update();
+	ASSERT_EQ(_temperature_compensation.set_sensor_id_gyro(GYRO0_DEVICE_ID, 0), 0);
+
+	float offsets[3] {};
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 30.f, offsets), RECOMPUTED);
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 31.5f, offsets), RECOMPUTED);
+	EXPECT_FLOAT_EQ(offsets[0], 0.65f);
+
+	// the reference moved with the recomputation
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 32.f, offsets), CACHED);
+	EXPECT_FLOAT_EQ(offsets[0], 0.65f);
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 30.f, offsets), RECOMPUTED);
+	EXPECT_FLOAT_EQ(offsets[0], 0.5f);
+}
+
+TEST_F(TemperatureCompensationTest, BaroReusedBelowTemperatureDelta)
+{
+	_temperature_compensation.parameters_update();
+	ASSERT_EQ(_temperature_compensation.set_sensor_id_baro(BARO0_DEVICE_ID, 0), 0);
+
+	float offset = 0.f;
+	EXPECT_EQ(_temperature_compensation.update_offsets_baro(0, 30.f, &offset), RECOMPUTED);
+	EXPECT_FLOAT_EQ(offset, 50.f);
+	EXPECT_EQ(_temperature_compensation.update_offsets_baro(0, 30.5f, &offset), CACHED);
+	EXPECT_FLOAT_EQ(offset, 50.f);
+	EXPECT_EQ(_temperature_compensation.update_offsets_baro(0, 32.f, &offset), RECOMPUTED);
+	EXPECT_FLOAT_EQ(offset, 70.f);
+}
+
+TEST_F(TemperatureCompensationTest, InvalidatedBySetSensorId)
+{
+	_temperature_compensation.parameters_update();
+	ASSERT_EQ(_temperature_compensation.set_sensor_id_gyro(GYRO0_DEVICE_ID, 0), 0);
+
+	float offsets[3] {};
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 30.f, offsets), RECOMPUTED);
+
+	// same device again, the cache stays valid
+	ASSERT_EQ(_temperature_compensation.set_sensor_id_gyro(GYRO0_DEVICE_ID, 0), 0);
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 30.f, offsets), CACHED);
+
+	// another device on the topic instance, its offsets are evaluated at the same temperature
+	ASSERT_EQ(_temperature_compensation.set_sensor_id_gyro(GYRO1_DEVICE_ID, 0), 1);
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 30.f, offsets), RECOMPUTED);
+	EXPECT_FLOAT_EQ(offsets[0], -1.f);
+}
+
+TEST_F(TemperatureCompensationTest, InvalidatedByParametersUpdate)
+{
+	_temperature_compensation.parameters_update();
+	ASSERT_EQ(_temperature_compensation.set_sensor_id_gyro(GYRO0_DEVICE_ID, 0), 0);
+
+	float offsets[3] {};
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 30.f, offsets), RECOMPUTED);
+	EXPECT_FLOAT_EQ(offsets[0], 0.5f);
+
+	setFloat("TC_G0_X1_0", 0.3f);
+	_temperature_compensation.parameters_update();
+
+	EXPECT_EQ(_temperature_compensation.update_offsets_gyro(0, 30.f, offsets), RECOMPUTED);
+	EXPECT_FLOAT_EQ(offsets[0], 1.5f);
+}
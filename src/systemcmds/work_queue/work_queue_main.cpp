@@ -61,6 +61,10 @@ work_queue_main(int argc, char *argv[])
 	} else if (!strcmp(argv[1], "status")) {
 		px4::WorkQueueManagerStatus();
 		return 0;
+
+	} else if (!strcmp(argv[1], "timing")) {
+		px4::WorkQueueManagerTimingStatus();
+		return 0;
 	}
 
 	usage();
@@ -78,9 +82,14 @@ usage()
 
 Command-line tool to show work queue status.
 
+`timing` prints, for every work item, a log2 histogram of the scheduling latency (from being scheduled
+until Run() starts) and of the Run() duration, both in microseconds and accumulated since startup.
+The status output shows the utilization of each work queue over the last second.
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("work_queue", "system");
 	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("timing", "Print work item latency and runtime histograms");
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 }